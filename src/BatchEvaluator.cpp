@@ -0,0 +1,76 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include "BatchEvaluator.h"
+#include "Position.h"
+#include "Evaluator.h"
+#include "ThreadPool.h"
+
+BatchEvaluator::BatchEvaluator(std::size_t threads, const EvaluatorConfig &config)
+  : noOfThreads(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+  for (std::size_t i = 0; i < noOfThreads; i++) {
+    auto evaluator = std::make_unique<Evaluator>(config.USE_PAWN_TABLE ? config.PAWN_TABLE_SIZE : 0);
+    evaluator->config = config;
+    evaluators.push_back(std::move(evaluator));
+  }
+  pool = std::make_unique<ThreadPool>(noOfThreads);
+}
+
+BatchEvaluator::~BatchEvaluator() = default;
+
+void BatchEvaluator::evaluate(const PackedPosition* positions, std::size_t count, Value* scores) {
+  const auto start = std::chrono::high_resolution_clock::now();
+  const std::size_t chunk = (count + noOfThreads - 1) / noOfThreads;
+  std::vector<std::future<void>> results;
+  for (std::size_t t = 0; t < noOfThreads; t++) {
+    const std::size_t begin = t * chunk;
+    const std::size_t end = std::min(count, begin + chunk);
+    if (begin >= end) break;
+    Evaluator* evaluator = evaluators[t].get();
+    results.push_back(pool->enqueue([evaluator, positions, scores, begin, end] {
+      // one position per task - setup() only resets what the packed data sets
+      auto position = std::make_unique<Position>();
+      for (std::size_t i = begin; i < end; i++) {
+        position->setup(positions[i]);
+        scores[i] = evaluator->evaluate(*position);
+      }
+    }));
+  }
+  for (auto &result : results) result.get();
+  lastCount = count;
+  lastNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void BatchEvaluator::setConfig(const EvaluatorConfig &config) {
+  for (auto &evaluator : evaluators) {
+    evaluator->config = config;
+    if (config.USE_PAWN_TABLE) evaluator->clearPawnTable();
+    if (config.USE_EVAL_CACHE) evaluator->clearEvalCache();
+  }
+}
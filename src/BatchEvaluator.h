@@ -0,0 +1,86 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef FRANKYCPP_BATCHEVALUATOR_H
+#define FRANKYCPP_BATCHEVALUATOR_H
+
+#include <memory>
+#include <vector>
+#include "types.h"
+#include "EvaluatorConfig.h"
+#include "PackedPosition.h"
+
+// forward declared dependencies
+class Evaluator;
+class ThreadPool;
+
+/**
+ * Evaluates arrays of packed positions in parallel.
+ *
+ * The array is split into one contiguous chunk per thread and each thread
+ * uses its own Evaluator and one reused Position which is set up directly
+ * from the packed data (no FEN parsing, no new Position per entry).
+ */
+class BatchEvaluator {
+  std::size_t noOfThreads;
+  std::vector<std::unique_ptr<Evaluator>> evaluators{};
+  std::unique_ptr<ThreadPool> pool{};
+  uint64_t lastNanos = 0;
+  std::size_t lastCount = 0;
+
+public:
+  /**
+   * @param threads number of threads - 0 for all cores
+   * @param config config of the evaluators which are always tunable (runtime config)
+   */
+  explicit BatchEvaluator(std::size_t threads = 0, const EvaluatorConfig &config = EvaluatorConfig{});
+  ~BatchEvaluator();
+  BatchEvaluator(const BatchEvaluator &) = delete;
+  BatchEvaluator &operator=(const BatchEvaluator &) = delete;
+
+  /**
+   * Evaluates count positions and writes the values to scores. The values
+   * are from the view of the side to move as Evaluator::evaluate().
+   */
+  void evaluate(const PackedPosition* positions, std::size_t count, Value* scores);
+
+  /** changes the config of all evaluators and clears their caches */
+  void setConfig(const EvaluatorConfig &config);
+
+  /** evaluator of a thread - e.g. for single evaluations */
+  Evaluator &getEvaluator(std::size_t thread = 0) { return *evaluators[thread]; }
+
+  std::size_t getThreads() const { return noOfThreads; }
+
+  /** positions per second of the last call to evaluate() */
+  uint64_t positionsPerSecond() const {
+    return lastNanos ? static_cast<uint64_t>(lastCount * 1e9 / lastNanos) : 0;
+  }
+
+  /** positions per second and core of the last call to evaluate() */
+  uint64_t positionsPerSecondPerCore() const { return positionsPerSecond() / noOfThreads; }
+};
+
+#endif //FRANKYCPP_BATCHEVALUATOR_H
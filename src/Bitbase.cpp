@@ -0,0 +1,211 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <chrono>
+#include <vector>
+#include "Logging.h"
+#include "Bitbase.h"
+#include "Bitboards.h"
+#include "Position.h"
+
+using namespace Bitboards;
+
+namespace Bitbase {
+
+  uint64_t kpkBuildTime = 0;
+
+  namespace {
+
+    /** one bit per KPK position - set if white (with the pawn) wins */
+    std::bitset<KPK_SIZE> kpkBitbase;
+
+    /**
+     * Results during generation. Results are bit flags so the results of all
+     * moves of a position can be combined with OR.
+     */
+    enum Result : uint8_t {
+      INVALID = 0,
+      UNKNOWN = 1,
+      DRAW = 2,
+      WIN = 4
+    };
+
+    /**
+     * Index layout: bit 0 side to move, bits 1-6 black king, bits 7-12 white
+     * king, bits 13-14 pawn file (a-d), bits 15-17 pawn rank (2-7).
+     */
+    inline std::size_t kpkIndex(Color stm, Square bksq, Square wksq, Square psq) {
+      return stm | (bksq << 1) | (wksq << 7) | (fileOf(psq) << 13) | ((rankOf(psq) - RANK_2) << 15);
+    }
+
+    /** sets up the initial result of a position which can be decided without looking at moves */
+    Result initialResult(std::size_t idx) {
+      const Color stm = Color(idx & 0x1);
+      const Square bksq = Square((idx >> 1) & 0x3F);
+      const Square wksq = Square((idx >> 7) & 0x3F);
+      const Square psq = getSquare(File((idx >> 13) & 0x3), Rank(RANK_2 + ((idx >> 15) & 0x7)));
+
+      // invalid positions - kings next to each other, a king on the pawn square
+      // or black king in check when white is to move
+      if (distance(wksq, bksq) <= 1
+          || wksq == psq || bksq == psq
+          || (stm == WHITE && (pawnAttacks[WHITE][psq] & squareBB[bksq]))) {
+        return INVALID;
+      }
+
+      // white can promote without the new queen being captured
+      if (stm == WHITE && rankOf(psq) == RANK_7) {
+        const Square promSq = psq + NORTH;
+        if (wksq != promSq && bksq != promSq
+            && (distance(bksq, promSq) > 1 || distance(wksq, promSq) == 1)) {
+          return WIN;
+        }
+      }
+
+      if (stm == BLACK) {
+        // stalemate (or checkmate by the pawn which is very rare and
+        // treated as draw)
+        const Bitboard blackMoves = pseudoAttacks[KING][bksq]
+                                    & ~(pseudoAttacks[KING][wksq] | pawnAttacks[WHITE][psq]);
+        if (!blackMoves) {
+          return DRAW;
+        }
+        // black can capture the undefended pawn
+        if ((pseudoAttacks[KING][bksq] & squareBB[psq])
+            && !(pseudoAttacks[KING][wksq] & squareBB[psq])) {
+          return DRAW;
+        }
+      }
+
+      return UNKNOWN;
+    }
+
+    /** combines the results of all moves of an unknown position */
+    Result classify(const std::vector<Result> &db, std::size_t idx) {
+      const Color stm = Color(idx & 0x1);
+      const Square bksq = Square((idx >> 1) & 0x3F);
+      const Square wksq = Square((idx >> 7) & 0x3F);
+      const Square psq = getSquare(File((idx >> 13) & 0x3), Rank(RANK_2 + ((idx >> 15) & 0x7)));
+
+      int r = INVALID;
+
+      if (stm == WHITE) {
+        Bitboard kingMoves = pseudoAttacks[KING][wksq]
+                             & ~(pseudoAttacks[KING][bksq] | squareBB[psq]);
+        while (kingMoves) {
+          r |= db[kpkIndex(BLACK, bksq, popLSB(kingMoves), psq)];
+        }
+        // pawn pushes - promotions are handled in initialResult()
+        if (rankOf(psq) < RANK_7) {
+          const Square push = psq + NORTH;
+          if (push != wksq && push != bksq) {
+            r |= db[kpkIndex(BLACK, bksq, wksq, push)];
+            const Square doublePush = push + NORTH;
+            if (rankOf(psq) == RANK_2 && doublePush != wksq && doublePush != bksq) {
+              r |= db[kpkIndex(BLACK, bksq, wksq, doublePush)];
+            }
+          }
+        }
+        // white wins if one move wins, draws if all moves draw
+        return r & WIN ? WIN : r & UNKNOWN ? UNKNOWN : DRAW;
+      }
+
+      Bitboard kingMoves = pseudoAttacks[KING][bksq]
+                           & ~(pseudoAttacks[KING][wksq] | pawnAttacks[WHITE][psq]);
+      while (kingMoves) {
+        r |= db[kpkIndex(WHITE, popLSB(kingMoves), wksq, psq)];
+      }
+      // black draws if one move draws, loses if all moves lose
+      return r & DRAW ? DRAW : r & UNKNOWN ? UNKNOWN : WIN;
+    }
+  }
+
+  void init() {
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<Result> db(KPK_SIZE);
+    for (std::size_t idx = 0; idx < KPK_SIZE; ++idx) {
+      db[idx] = initialResult(idx);
+    }
+
+    // retrograde analysis - iterate until no unknown position can be
+    // resolved anymore
+    bool repeat = true;
+    while (repeat) {
+      repeat = false;
+      for (std::size_t idx = 0; idx < KPK_SIZE; ++idx) {
+        if (db[idx] == UNKNOWN && (db[idx] = classify(db, idx)) != UNKNOWN) {
+          repeat = true;
+        }
+      }
+    }
+
+    // all remaining unknown positions are draws
+    kpkBitbase.reset();
+    for (std::size_t idx = 0; idx < KPK_SIZE; ++idx) {
+      if (db[idx] == WIN) {
+        kpkBitbase.set(idx);
+      }
+    }
+
+    kpkBuildTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start).count();
+    LOG__INFO(Logger::get().MAIN_LOG, "KPK bitbase generated in {:n} ms ({:n} wins of {:n} positions, {:n} bytes)",
+              kpkBuildTime, kpkBitbase.count(), KPK_SIZE, KPK_SIZE / 8);
+  }
+
+  bool probeKPK(Square wksq, Square wpsq, Square bksq, Color stm) {
+    assert(rankOf(wpsq) >= RANK_2 && rankOf(wpsq) <= RANK_7);
+    // mirror to files a-d
+    if (fileOf(wpsq) > FILE_D) {
+      wksq = Square(wksq ^ 7);
+      wpsq = Square(wpsq ^ 7);
+      bksq = Square(bksq ^ 7);
+    }
+    return kpkBitbase[kpkIndex(stm, bksq, wksq, wpsq)];
+  }
+
+  bool isKPK(const Position &position) {
+    return popcount(position.getOccupiedBB()) == 3
+           && popcount(position.getPieceBB(WHITE, PAWN) | position.getPieceBB(BLACK, PAWN)) == 1;
+  }
+
+  bool probeKPK(const Position &position) {
+    assert(isKPK(position));
+    const Color strong = position.getPieceBB(WHITE, PAWN) ? WHITE : BLACK;
+    Square wksq = position.getKingSquare(strong);
+    Square wpsq = lsb(position.getPieceBB(strong, PAWN));
+    Square bksq = position.getKingSquare(~strong);
+    Color stm = position.getNextPlayer();
+    // flip ranks when black has the pawn
+    if (strong == BLACK) {
+      wksq = Square(wksq ^ 56);
+      wpsq = Square(wpsq ^ 56);
+      bksq = Square(bksq ^ 56);
+      stm = ~stm;
+    }
+    return probeKPK(wksq, wpsq, bksq, stm);
+  }
+}
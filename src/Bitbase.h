@@ -0,0 +1,67 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef FRANKYCPP_BITBASE_H
+#define FRANKYCPP_BITBASE_H
+
+#include "types.h"
+
+// forward declared dependencies
+class Position;
+
+/**
+ * In memory bitbase for King+Pawn vs. King endings.
+ * The bitbase is generated by retrograde analysis in Bitbase::init() and
+ * stores one bit per position (1 = win for the side with the pawn).
+ * Positions are normalized to white having the pawn on the files a-d.
+ */
+namespace Bitbase {
+
+  void init();
+
+  /** number of positions in the KPK bitbase (stm * bk * wk * 24 pawn squares) */
+  constexpr std::size_t KPK_SIZE = 2 * 64 * 64 * 24;
+
+  /** milliseconds it took to generate the KPK bitbase in init() */
+  extern uint64_t kpkBuildTime;
+
+  /**
+   * Probes the KPK bitbase with white having the pawn.
+   * @return true if white wins, false if the position is a draw
+   */
+  bool probeKPK(Square wksq, Square wpsq, Square bksq, Color stm);
+
+  /** @return true if only the two kings and a single pawn are on the board */
+  bool isKPK(const Position &position);
+
+  /**
+   * Probes the KPK bitbase for the given position. The position must be a
+   * KPK position (see isKPK()).
+   * @return true if the side with the pawn wins, false if the position is a draw
+   */
+  bool probeKPK(const Position &position);
+}
+
+#endif //FRANKYCPP_BITBASE_H
@@ -433,6 +433,50 @@ namespace Bitboards {
     return b;
   }
 
+  /** All squares north of the set bits including the set bits (Kogge-Stone fill) */
+  inline Bitboard northFill(Bitboard b) {
+    b |= b << 8;
+    b |= b << 16;
+    b |= b << 32;
+    return b;
+  }
+
+  /** All squares south of the set bits including the set bits (Kogge-Stone fill) */
+  inline Bitboard southFill(Bitboard b) {
+    b |= b >> 8;
+    b |= b >> 16;
+    b |= b >> 32;
+    return b;
+  }
+
+  /** All squares of the files with at least one bit set */
+  inline Bitboard fileFill(Bitboard b) {
+    return northFill(b) | southFill(b);
+  }
+
+  /** Squares in front of the pieces of color c excluding their own squares */
+  inline Bitboard frontSpan(Color c, Bitboard b) {
+    return c == WHITE ? northFill(b << 8) : southFill(b >> 8);
+  }
+
+  /** Squares behind the pieces of color c excluding their own squares */
+  inline Bitboard rearSpan(Color c, Bitboard b) {
+    return frontSpan(~c, b);
+  }
+
+  /** Squares attacked by all pawns of color c */
+  inline Bitboard pawnAttackSet(Color c, Bitboard pawns) {
+    return c == WHITE
+           ? shift(NORTH_WEST, pawns) | shift(NORTH_EAST, pawns)
+           : shift(SOUTH_WEST, pawns) | shift(SOUTH_EAST, pawns);
+  }
+
+  /** Squares the pawns of color c might attack when advancing */
+  inline Bitboard attackSpan(Color c, Bitboard pawns) {
+    const Bitboard span = frontSpan(c, pawns);
+    return shift(EAST, span) | shift(WEST, span);
+  }
+
   /**
    * Rotates a Bitboard
    * @param b
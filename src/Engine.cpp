@@ -34,6 +34,8 @@
 #include "UCIOption.h"
 #include "MoveGenerator.h"
 #include "TT.h"
+#include "NNUE.h"
+#include "Evaluator.h"
 
 #define MAP(name, option) optionVector.push_back(std::make_pair(name, option))
 
@@ -105,9 +107,33 @@ void Engine::setOption(const std::string &name, const std::string &value) {
       EngineConfig::hash = getInt(optionIterator->second.getCurrentValue());
       pSearch->setHashSize(EngineConfig::hash);
     }
+    else if (name == "EvalCache") {
+      EngineConfig::evalCache = getInt(optionIterator->second.getCurrentValue());
+      pSearch->setEvalCacheSize(EngineConfig::evalCache);
+    }
+    else if (name == "EvalFile") {
+      EngineConfig::evalFile = optionIterator->second.getCurrentValue();
+      if (!EngineConfig::evalFile.empty() && NNUE::load(EngineConfig::evalFile)) {
+        NNUE::setEnabled(EngineConfig::useNNUE);
+        pSearch->clearHash();
+      }
+    }
+    else if (name == "Use_NNUE") {
+      EngineConfig::useNNUE = to_bool(optionIterator->second.getCurrentValue());
+      if (!NNUE::setEnabled(EngineConfig::useNNUE)) {
+        LOG__WARN(Logger::get().ENGINE_LOG, "Use_NNUE: no network loaded - set EvalFile first");
+      }
+      pSearch->clearHash();
+    }
     else if (name == "OwnBook") {
       SearchConfig::USE_BOOK = to_bool(optionIterator->second.getCurrentValue());
     }
+    else if (name == "Use_MateSolver") {
+      SearchConfig::USE_MATE_SOLVER = to_bool(optionIterator->second.getCurrentValue());
+    }
+    else if (name == "MateSolverHash") {
+      pSearch->setMateSolverSize(getInt(optionIterator->second.getCurrentValue()));
+    }
     else if (name == "Use_AlphaBeta") {
       SearchConfig::USE_ALPHABETA = to_bool(optionIterator->second.getCurrentValue());
     }
@@ -135,6 +161,12 @@ void Engine::setOption(const std::string &name, const std::string &value) {
     else if (name == "Use_PV_Sort") {
       SearchConfig::USE_PV_MOVE_SORT = to_bool(optionIterator->second.getCurrentValue());
     }
+    else if (name == "Use_UpcomingRep") {
+      SearchConfig::USE_UPCOMING_REP = to_bool(optionIterator->second.getCurrentValue());
+    }
+    else if (name == "Use_KPK_Bitbase") {
+      SearchConfig::USE_KPK_BITBASE = to_bool(optionIterator->second.getCurrentValue());
+    }
     else if (name == "Use_MDP") {
       SearchConfig::USE_MDP = to_bool(optionIterator->second.getCurrentValue());
     }
@@ -165,6 +197,18 @@ void Engine::setOption(const std::string &name, const std::string &value) {
     else if (name == "NMPV_Reduction") {
       SearchConfig::NMP_V_REDUCTION = static_cast<Depth>(getInt(optionIterator->second.getCurrentValue()));
     }
+    else if (name == "Use_ProbCut") {
+      SearchConfig::USE_PROBCUT = to_bool(optionIterator->second.getCurrentValue());
+    }
+    else if (name == "ProbCut_Depth") {
+      SearchConfig::PROBCUT_DEPTH = static_cast<Depth>(getInt(optionIterator->second.getCurrentValue()));
+    }
+    else if (name == "ProbCut_Margin") {
+      SearchConfig::PROBCUT_MARGIN = static_cast<Value>(getInt(optionIterator->second.getCurrentValue()));
+    }
+    else if (name == "ProbCut_Reduction") {
+      SearchConfig::PROBCUT_REDUCTION = static_cast<Depth>(getInt(optionIterator->second.getCurrentValue()));
+    }
     else if (name == "Use_EXT") {
       SearchConfig::USE_EXTENSIONS = to_bool(optionIterator->second.getCurrentValue());
     }
@@ -229,6 +273,16 @@ void Engine::setPosition(const std::string &fen) {
   pPosition = std::make_unique<Position>(fen);
 }
 
+std::string Engine::evalTrace() const {
+  LOG__INFO(Logger::get().ENGINE_LOG, "Engine: Evaluate {}", pPosition->printFen());
+  // own evaluator as the search's evaluator might be in use
+  Evaluator evaluator(0);
+  evaluator.config.USE_PAWN_TABLE = false;
+  EvalTrace trace;
+  evaluator.trace(*pPosition, trace);
+  return trace.str();
+}
+
 void Engine::doMove(const std::string &moveStr) {
   LOG__INFO(Logger::get().ENGINE_LOG, "Engine: Do move {}", moveStr);
   // this is used to check if the given move is valid
@@ -389,8 +443,13 @@ void Engine::initOptions() {
   MAP("Clear Hash",       UCI_Option("Clear Hash"));
   MAP("Use_Hash",         UCI_Option("Use_Hash",         SearchConfig::USE_TT));
   MAP("Hash",             UCI_Option("Hash",             EngineConfig::hash, 0, TT::MAX_SIZE_MB));
+  MAP("EvalCache",        UCI_Option("EvalCache",        EngineConfig::evalCache, 0, 1'024));
   MAP("Ponder",           UCI_Option("Ponder",           EngineConfig::ponder));
+  MAP("Use_NNUE",         UCI_Option("Use_NNUE",         EngineConfig::useNNUE));
+  MAP("EvalFile",         UCI_Option("EvalFile",         EngineConfig::evalFile.c_str()));
   MAP("OwnBook",          UCI_Option("OwnBook",          SearchConfig::USE_BOOK));
+  MAP("Use_MateSolver",   UCI_Option("Use_MateSolver",   SearchConfig::USE_MATE_SOLVER));
+  MAP("MateSolverHash",   UCI_Option("MateSolverHash",   SearchConfig::MATE_SOLVER_SIZE_MB, 1, TT::MAX_SIZE_MB));
   MAP("Use_AlphaBeta",    UCI_Option("Use_AlphaBeta",    SearchConfig::USE_ALPHABETA));
   MAP("Use_PVS",          UCI_Option("Use_PVS",          SearchConfig::USE_PVS));
   MAP("Use_Aspiration",   UCI_Option("Use_Aspiration",   SearchConfig::USE_ASPIRATION_WINDOW));
@@ -400,6 +459,8 @@ void Engine::initOptions() {
   MAP("Use_KillerMoves",  UCI_Option("Use_KillerMoves",  SearchConfig::USE_KILLER_MOVES));
   MAP("No_Of_Killer",     UCI_Option("No_Of_Killer",     SearchConfig::NO_KILLER_MOVES, 1, 9));
   MAP("Use_PV_Sort",      UCI_Option("Use_PV_Sort",      SearchConfig::USE_PV_MOVE_SORT));
+  MAP("Use_UpcomingRep",  UCI_Option("Use_UpcomingRep",  SearchConfig::USE_UPCOMING_REP));
+  MAP("Use_KPK_Bitbase",  UCI_Option("Use_KPK_Bitbase",  SearchConfig::USE_KPK_BITBASE));
   MAP("Use_MDP",          UCI_Option("Use_MDP",          SearchConfig::USE_MDP));
   MAP("Use_MPP",          UCI_Option("Use_MPP",          SearchConfig::USE_MPP));
   MAP("Use_Standpat",     UCI_Option("Use_Standpat",     SearchConfig::USE_QS_STANDPAT_CUT));
@@ -410,6 +471,10 @@ void Engine::initOptions() {
   MAP("NMP_Reduction",    UCI_Option("NMP_Reduction",    SearchConfig::NMP_REDUCTION, 0, DEPTH_MAX));
   MAP("Use_NMPVer",       UCI_Option("Use_NMPVer",       SearchConfig::NMP_VERIFICATION));
   MAP("NMPV_Reduction",   UCI_Option("NMPV_Reduction",   SearchConfig::NMP_V_REDUCTION, 0, DEPTH_MAX));
+  MAP("Use_ProbCut",      UCI_Option("Use_ProbCut",      SearchConfig::USE_PROBCUT));
+  MAP("ProbCut_Depth",    UCI_Option("ProbCut_Depth",    SearchConfig::PROBCUT_DEPTH, 0, DEPTH_MAX));
+  MAP("ProbCut_Margin",   UCI_Option("ProbCut_Margin",   SearchConfig::PROBCUT_MARGIN, 0, VALUE_MAX));
+  MAP("ProbCut_Reduction",UCI_Option("ProbCut_Reduction",SearchConfig::PROBCUT_REDUCTION, 0, DEPTH_MAX));
   MAP("Use_EXT",          UCI_Option("Use_EXT",          SearchConfig::USE_EXTENSIONS));
   MAP("Use_FP",           UCI_Option("Use_FP",           SearchConfig::USE_FP));
   MAP("FP_Margin",        UCI_Option("FP_Margin",        SearchConfig::FP_MARGIN, 0, VALUE_MAX));
@@ -92,6 +92,7 @@ public:
   void newGame();
   void setPosition(const std::string &fen);
   void doMove(const std::string &moveStr);
+  std::string evalTrace() const;
   void startSearch(const UCISearchMode &uciSearchMode);
   void stopSearch();
   bool isSearching();
@@ -26,10 +26,15 @@
 #ifndef FRANKYCPP_ENGINECONFIG_H
 #define FRANKYCPP_ENGINECONFIG_H
 
+#include <string>
+
 namespace EngineConfig {
 
   inline int hash = 64; // in MByte
+  inline int evalCache = 0; // in MByte - 0 turns the eval cache off
   inline bool ponder = true;
+  inline bool useNNUE = false; // needs a network from evalFile
+  inline std::string evalFile;
 
 }
 
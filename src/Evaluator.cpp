@@ -27,15 +27,41 @@
 #include "Evaluator.h"
 #include "Bitboards.h"
 #include "Position.h"
+#include "Bitbase.h"
+#include "Material.h"
+#include "NNUE.h"
 
 using namespace Bitboards;
 
+namespace {
+  /** attacks of a piece - sliders use the pre-rotated occupancy of the position */
+  template<PieceType PT>
+  inline Bitboard attacksFrom(const Position &position, const Square sq) {
+    switch (PT) {
+      case KNIGHT:
+        return pseudoAttacks[KNIGHT][sq];
+      case BISHOP:
+        return getMovesDiagUpR(sq, position.getOccupiedBBR45())
+               | getMovesDiagDownR(sq, position.getOccupiedBBL45());
+      case ROOK:
+        return getMovesRank(sq, position.getOccupiedBB())
+               | getMovesFileR(sq, position.getOccupiedBBL90());
+      case QUEEN:
+        return attacksFrom<BISHOP>(position, sq) | attacksFrom<ROOK>(position, sq);
+      default:
+        return EMPTY_BB;
+    }
+  }
+}
+
 Evaluator::Evaluator() {
   resizePawnTable(config.PAWN_TABLE_SIZE);
+  resizeEvalCache(config.EVAL_CACHE_SIZE_MB);
 }
 
 Evaluator::Evaluator(std::size_t pawnEvalCacheSize) {
   resizePawnTable(pawnEvalCacheSize);
+  resizeEvalCache(config.EVAL_CACHE_SIZE_MB);
 }
 
 void Evaluator::resizePawnTable(std::size_t size) {
@@ -48,58 +74,232 @@ void Evaluator::resizePawnTable(std::size_t size) {
   }
 }
 
-Value Evaluator::evaluate(const Position &position) {
+void Evaluator::resizeEvalCache(std::size_t sizeInMB) {
+  std::size_t entries = 0;
+  if (sizeInMB) {
+    entries = 1;
+    while (entries * 2 * sizeof(EvalEntry) <= sizeInMB * 1024 * 1024) {
+      entries *= 2;
+    }
+  }
+  evalCache.assign(entries, EvalEntry{});
+  evalCache.shrink_to_fit();
+  evalCacheMask = entries ? entries - 1 : 0;
+  evalCacheHits = evalCacheMisses = 0;
+  LOG__INFO(Logger::get().EVAL_LOG, "Evaluator eval cache of size {:.2F} MB created with {:n} entries",
+            static_cast<double>(sizeof(EvalEntry) * entries) / (1024 * 1024), entries);
+}
+
+void Evaluator::clearEvalCache() {
+  std::fill(evalCache.begin(), evalCache.end(), EvalEntry{});
+  evalCacheHits = evalCacheMisses = 0;
+}
+
+void Evaluator::clearPawnTable() {
+  std::fill(pawnTable.begin(), pawnTable.end(), Entry{});
+}
+
+Value Evaluator::evaluate(const Position &position, Value alpha, Value beta) {
+  evalCalls++;
+  lastEvalLazy = false;
+  if (!config.USE_EVAL_CACHE || evalCache.empty()) {
+    return staticEval ? evaluatePosition<StaticEvalPolicy>(position, alpha, beta)
+                      : evaluatePosition<RuntimeEvalPolicy>(position, alpha, beta);
+  }
+
+  const Key key = position.getZobristKey();
+  EvalEntry &entry = evalCache[key & evalCacheMask];
+  const auto verification = static_cast<uint32_t>(key >> 32);
+  if (entry.key == verification && entry.value != VALUE_NONE) {
+    evalCacheHits++;
+    return entry.value;
+  }
+  evalCacheMisses++;
+
+  const Value value = staticEval ? evaluatePosition<StaticEvalPolicy>(position, alpha, beta)
+                                 : evaluatePosition<RuntimeEvalPolicy>(position, alpha, beta);
+  // lazy estimates depend on the window and are not cached
+  if (!lastEvalLazy) {
+    entry.key = verification;
+    entry.value = value;
+  }
+  return value;
+}
+
+Value Evaluator::trace(const Position &position, EvalTrace &evalTrace) {
+  evalTrace = EvalTrace{};
+  evalTrace.scale = Material::SCALE_NORMAL;
+  pTrace = &evalTrace;
+  const Value value = evaluatePosition<TracedEvalPolicy>(position, VALUE_MIN, VALUE_MAX);
+  pTrace = nullptr;
+  return value;
+}
+
+std::string EvalTrace::str() const {
+  std::string out;
+  if (!shortcut.empty()) {
+    return fmt::format("Evaluated by {}: {}\n", shortcut, value);
+  }
+  out += fmt::format("{:>10} | {:^13} | {:^13} | {:^13}\n", "Term", "White", "Black", "Total");
+  out += fmt::format("{:>10} | {:>6} {:>6} | {:>6} {:>6} | {:>6} {:>6}\n",
+                     "", "mg", "eg", "mg", "eg", "mg", "eg");
+  out += fmt::format("{:-<10}-+-{:-<13}-+-{:-<13}-+-{:-<13}\n", "", "", "", "");
+  Score sum = SCORE_ZERO;
+  for (int t = MATERIAL; t < TERM_LENGTH; t++) {
+    const Term term = Term(t);
+    const Score w = scores[term][WHITE];
+    const Score b = scores[term][BLACK];
+    if (term == IMBALANCE || term == PAWNS) {
+      out += fmt::format("{:>10} | {:>6} {:>6} | {:>6} {:>6} | {:>6} {:>6}\n", termNames[term],
+                         "--", "--", "--", "--", mgValue(total(term)), egValue(total(term)));
+    }
+    else {
+      out += fmt::format("{:>10} | {:>6} {:>6} | {:>6} {:>6} | {:>6} {:>6}\n", termNames[term],
+                         mgValue(w), egValue(w), mgValue(b), egValue(b),
+                         mgValue(total(term)), egValue(total(term)));
+    }
+    sum += total(term);
+  }
+  out += fmt::format("{:-<10}-+-{:-<13}-+-{:-<13}-+-{:-<13}\n", "", "", "", "");
+  out += fmt::format("{:>10} | {:>6} {:>6} | {:>6} {:>6} | {:>6} {:>6}\n", "Total", "", "", "", "",
+                     mgValue(sum), egValue(sum));
+  out += fmt::format("Game phase factor {:.2f} tapered {} scaled {}/{} tempo {}\n",
+                     gamePhaseFactor, taper(sum, gamePhaseFactor), scale, Material::SCALE_NORMAL, tempo);
+  out += fmt::format("Final evaluation (side to move): {}\n", value);
+  return out;
+}
+
+template<class P>
+Value Evaluator::evaluatePosition(const Position &position, Value alpha, Value beta) {
+  const EvaluatorConfig &cfg = configOf<P>();
   LOG__TRACE(Logger::get().EVAL_LOG, "Start eval on {}", position.printFen());
 
   // Calculations are always from the view of the white player.
 
+  // material signature - draws, specialised endgames, imbalance and scaling
+  const Material::Entry* const material = position.getMaterialEntry();
+
   // if not enough material on the board for a win then it is a draw
-  if (position.checkInsufficientMaterial()) {
+  if (material->draw != Material::DRAW_NONE && position.checkInsufficientMaterial()) {
     LOG__TRACE(Logger::get().EVAL_LOG, "Eval: DRAW for insufficient material on {}", position.printFen());
-    return VALUE_DRAW;
+    return traceShortcut<P>("insufficient material", VALUE_DRAW);
+  }
+
+  switch (material->endgame) {
+    case Material::ENDGAME_KPK:
+      // King+Pawn vs. King is decided by the bitbase
+      if (cfg.USE_KPK_BITBASE) return traceShortcut<P>("KPK bitbase", evaluateKPK<P>(position));
+      break;
+    case Material::ENDGAME_KXK:
+      // King+Rook/Queen vs. King is a win - drive the king to the edge
+      if (cfg.USE_KXK) return traceShortcut<P>("KXK", evaluateKXK<P>(position, material->strongSide));
+      break;
+    default:
+      break;
+  }
+
+  // a loaded network replaces the hand crafted terms
+  if (NNUE::isEnabled()) {
+    return traceShortcut<P>("NNUE", NNUE::evaluate(position));
   }
 
+  // Calculations are done with packed mid and end game scores which are
+  // tapered once by the game phase at the end. Material does not depend on
+  // the game phase.
+  const double gamePhaseFactor = material->gamePhaseFactor;
+
   // MATERIAL & POSITION
-  int value = (config.USE_MATERIAL
+  int value = (cfg.USE_MATERIAL
                ? position.getMaterial(WHITE) - position.getMaterial(BLACK)
-               : 0) * config.MATERIAL_WEIGHT;
+               : 0) * cfg.MATERIAL_WEIGHT;
+  if constexpr (P::TRACE) {
+    if (cfg.USE_MATERIAL) {
+      for (Color c : {WHITE, BLACK}) {
+        const int m = position.getMaterial(c) * cfg.MATERIAL_WEIGHT;
+        pTrace->scores[EvalTrace::MATERIAL][c] = makeScore(m, m);
+      }
+    }
+  }
   LOG__TRACE(Logger::get().EVAL_LOG, "Eval value after material: {}", value);
 
-  value += (config.USE_POSITION
-            ? position.getPosValue(WHITE) - position.getPosValue(BLACK)
-            : 0) * config.POSITION_WEIGHT;
-  LOG__TRACE(Logger::get().EVAL_LOG, "Eval value after position: {}", value);
-
-  // TODO: Early exit if score is very high
+  Score score = cfg.USE_POSITION
+                ? traceTerm<P>(EvalTrace::PSQT, position.getPosScore(WHITE) * cfg.POSITION_WEIGHT,
+                               position.getPosScore(BLACK) * cfg.POSITION_WEIGHT)
+                : SCORE_ZERO;
+  if (cfg.USE_MATERIAL && cfg.USE_IMBALANCE) {
+    score += traceTerm<P>(EvalTrace::IMBALANCE, material->imbalance * cfg.MATERIAL_WEIGHT, SCORE_ZERO);
+  }
+  LOG__TRACE(Logger::get().EVAL_LOG, "Eval score after position: {}/{}", mgValue(score), egValue(score));
+
+  // Lazy evaluation - when material and position are already far outside
+  // of the search window the remaining terms will not bring the value
+  // back into it.
+  if (cfg.USE_LAZY_EVAL) {
+    const int estimate = (position.getNextPlayer() == WHITE ? 1 : -1) * (value + taper(score, gamePhaseFactor))
+                         + static_cast<int>(cfg.TEMPO * gamePhaseFactor);
+    if (estimate + cfg.LAZY_EVAL_MARGIN <= alpha || estimate - cfg.LAZY_EVAL_MARGIN >= beta) {
+      LOG__TRACE(Logger::get().EVAL_LOG, "Eval: lazy exit with {} outside of ({},{})", estimate, alpha, beta);
+      lazyEvals++;
+      lastEvalLazy = true;
+      return static_cast<Value>(estimate);
+    }
+  }
 
   // evaluate pawns
-  if (config.USE_PAWNEVAL) {
-    value += pawnEval(position);
+  if (cfg.USE_PAWNEVAL) {
+    score += traceTerm<P>(EvalTrace::PAWNS, pawnEval<P>(position), SCORE_ZERO);
   }
-  LOG__TRACE(Logger::get().EVAL_LOG, "Eval value after pawns: {}", value);
+  LOG__TRACE(Logger::get().EVAL_LOG, "Eval score after pawns: {}/{}", mgValue(score), egValue(score));
+
+  // attack maps for all following terms
+  computeAttacks(position);
 
   // evaluate pieces                                                         @formatter:off
-  value += evaluatePiece<WHITE, KNIGHT>(position) - evaluatePiece<BLACK, KNIGHT>(position);
-  value += evaluatePiece<WHITE, BISHOP>(position) - evaluatePiece<BLACK, BISHOP>(position);
-  value += evaluatePiece<WHITE, ROOK  >(position) - evaluatePiece<BLACK, ROOK  >(position);
-  value += evaluatePiece<WHITE, QUEEN >(position) - evaluatePiece<BLACK, QUEEN >(position);
+  score += traceTerm<P>(EvalTrace::KNIGHTS, evaluatePiece<WHITE, KNIGHT, P>(position), evaluatePiece<BLACK, KNIGHT, P>(position));
+  score += traceTerm<P>(EvalTrace::BISHOPS, evaluatePiece<WHITE, BISHOP, P>(position), evaluatePiece<BLACK, BISHOP, P>(position));
+  score += traceTerm<P>(EvalTrace::ROOKS  , evaluatePiece<WHITE, ROOK  , P>(position), evaluatePiece<BLACK, ROOK  , P>(position));
+  score += traceTerm<P>(EvalTrace::QUEENS , evaluatePiece<WHITE, QUEEN , P>(position), evaluatePiece<BLACK, QUEEN , P>(position));
   // @formatter:on
-  LOG__TRACE(Logger::get().EVAL_LOG, "Eval value after pieces: {}", value);
+  LOG__TRACE(Logger::get().EVAL_LOG, "Eval score after pieces: {}/{}", mgValue(score), egValue(score));
 
   // evaluate king
-  value += evaluateKing<WHITE>(position) - evaluateKing<BLACK>(position);
-  LOG__TRACE(Logger::get().EVAL_LOG, "Eval value after king: {}", value);
+  score += traceTerm<P>(EvalTrace::KING, evaluateKing<WHITE, P>(position), evaluateKing<BLACK, P>(position));
+  LOG__TRACE(Logger::get().EVAL_LOG, "Eval score after king: {}/{}", mgValue(score), egValue(score));
+
+  // evaluate threats against pieces
+  if (cfg.USE_THREATS) {
+    score += traceTerm<P>(EvalTrace::THREATS, evaluateThreats<WHITE, P>(position), evaluateThreats<BLACK, P>(position));
+  }
+  LOG__TRACE(Logger::get().EVAL_LOG, "Eval score after threats: {}/{}", mgValue(score), egValue(score));
+
+  // taper all mid and end game terms once
+  value += taper(score, gamePhaseFactor);
+  LOG__TRACE(Logger::get().EVAL_LOG, "Eval value after tapering: {}", value);
 
   // check bonus: giving check or being in check has value as it forces evasion
   // moves
-  if (config.USE_CHECK_BONUS) {
-    value += position.isAttacked(position.getKingSquare(BLACK), WHITE)
-             ? config.CHECK_VALUE : 0;
-    value -= position.isAttacked(position.getKingSquare(WHITE), BLACK)
-             ? config.CHECK_VALUE : 0;
+  if (cfg.USE_CHECK_BONUS) {
+    value += attacks.all[WHITE] & position.getKingSquare(BLACK)
+             ? cfg.CHECK_VALUE : 0;
+    value -= attacks.all[BLACK] & position.getKingSquare(WHITE)
+             ? cfg.CHECK_VALUE : 0;
+    if constexpr (P::TRACE) {
+      for (Color c : {WHITE, BLACK}) {
+        const int check = attacks.all[c] & position.getKingSquare(~c) ? cfg.CHECK_VALUE : 0;
+        pTrace->scores[EvalTrace::CHECK][c] = makeScore(check, check);
+      }
+    }
   }
   LOG__TRACE(Logger::get().EVAL_LOG, "Eval value after check bonus: {}", value);
 
+  // material which is hard to win with scales down the value of the side
+  // which is ahead
+  if (cfg.USE_MATERIAL_SCALE) {
+    if constexpr (P::TRACE) pTrace->scale = material->scale[value > 0 ? WHITE : BLACK];
+    value = value * material->scale[value > 0 ? WHITE : BLACK] / Material::SCALE_NORMAL;
+  }
+  LOG__TRACE(Logger::get().EVAL_LOG, "Eval value after scaling: {}", value);
+
   // value is always from the view of the next player
   if (position.getNextPlayer() == BLACK) {
     value *= -1;
@@ -108,28 +308,65 @@ Value Evaluator::evaluate(const Position &position) {
   // TEMPO Bonus for the side to move (helps with evaluation alternation -
   // less difference between side which makes aspiration search faster
   // (not empirically tested)
-  value += static_cast<int>(config.TEMPO * position.getGamePhaseFactor());
+  value += static_cast<int>(cfg.TEMPO * gamePhaseFactor);
   LOG__TRACE(Logger::get().EVAL_LOG, "Eval value after tempo and player adjust: {}", value);
 
+  if constexpr (P::TRACE) {
+    pTrace->gamePhaseFactor = gamePhaseFactor;
+    pTrace->tempo = static_cast<int>(cfg.TEMPO * gamePhaseFactor);
+    pTrace->value = static_cast<Value>(value);
+  }
+
   return static_cast<Value>(value);
 }
 
-int Evaluator::pawnEval(const Position &position) {
-  const double gamePhaseFactor = position.getGamePhaseFactor();
-  const double revGamePhaseFactor = 1.0 - gamePhaseFactor;
-  const Bitboard pawnsBitboard =
-    position.getPieceBB(WHITE, PAWN) | position.getPieceBB(BLACK, PAWN);
+template<class P>
+Value Evaluator::evaluateKPK(const Position &position) const {
+  const EvaluatorConfig &cfg = configOf<P>();
+  const Color strong = position.getPieceBB(WHITE, PAWN) ? WHITE : BLACK;
+  if (!Bitbase::probeKPK(position)) {
+    LOG__TRACE(Logger::get().EVAL_LOG, "Eval: DRAW for KPK bitbase on {}", position.printFen());
+    return VALUE_DRAW;
+  }
+  // a known win - the further the pawn has advanced the better to
+  // make progress towards promotion
+  const Square psq = lsb(position.getPieceBB(strong, PAWN));
+  const int relativeRank = strong == WHITE ? rankOf(psq) : RANK_8 - rankOf(psq);
+  const int value = cfg.KPK_WIN_BONUS + valueOf(PAWN) + 10 * relativeRank;
+  LOG__TRACE(Logger::get().EVAL_LOG, "Eval: WIN for KPK bitbase on {} value {}", position.printFen(), value);
+  return static_cast<Value>(position.getNextPlayer() == strong ? value : -value);
+}
+
+template<class P>
+Value Evaluator::evaluateKXK(const Position &position, const Color strong) const {
+  const EvaluatorConfig &cfg = configOf<P>();
+  const Square weakKing = position.getKingSquare(~strong);
+  const Square strongKing = position.getKingSquare(strong);
+  // a bare king can only be mated at the edge and with the help of the
+  // other king
+  const int value = cfg.KXK_WIN_BONUS
+                    + position.getMaterial(strong) - position.getMaterial(~strong)
+                    + 10 * centerDistance[weakKing]
+                    + 5 * (7 - distance(weakKing, strongKing));
+  LOG__TRACE(Logger::get().EVAL_LOG, "Eval: WIN for KXK on {} value {}", position.printFen(), value);
+  return static_cast<Value>(position.getNextPlayer() == strong ? value : -value);
+}
+
+template<class P>
+Score Evaluator::pawnEval(const Position &position) {
+  const EvaluatorConfig &cfg = configOf<P>();
+  const Key pawnKey = position.getPawnKey();
 
   Entry* const entryPtr = [&] { // lambda initialization
     // Get a pointer to a value entry for pawns
     // Either from the cache or from the default entry.
     if (config.USE_PAWN_TABLE) {
-      LOG__TRACE(Logger::get().EVAL_LOG, "Using pawn table on {}", pawnsBitboard);
-      return &pawnTable[getTableIndex(pawnsBitboard)];;
+      LOG__TRACE(Logger::get().EVAL_LOG, "Using pawn table on {}", pawnKey);
+      return &pawnTable[getTableIndex(pawnKey)];
     }
     else {
       // reset the default entry every time it is used
-      defaultEntry = {0, 0, 0};
+      defaultEntry = Entry{};
       LOG__TRACE(Logger::get().EVAL_LOG, "Not using pawn table.");
       return &defaultEntry;
     }
@@ -137,8 +374,7 @@ int Evaluator::pawnEval(const Position &position) {
 
   // we have an entry here - either from the cache or the default entry
 
-  if (entryPtr->pawnBitboard != EMPTY_BB &&
-      entryPtr->pawnBitboard == pawnsBitboard) {
+  if (entryPtr->key != 0 && entryPtr->key == pawnKey) {
     cacheHits++;
     LOG__TRACE(Logger::get().EVAL_LOG, "Found cache hit: {}", entryPtr->str());
   }
@@ -147,218 +383,171 @@ int Evaluator::pawnEval(const Position &position) {
     // we did not find an entry or have the default entry when cache is turned
     // off
     if (config.USE_PAWN_TABLE) {
-      if (entryPtr->pawnBitboard == 0) {
+      if (entryPtr->key == 0) {
         cacheEntries++;
       }
       else {
         cacheReplace++;
       }
-      // replace entry in cache by overwriting the key (=pawns bitboard)
-      entryPtr->pawnBitboard = pawnsBitboard;
-      entryPtr->midvalue = 0;
-      entryPtr->endvalue = 0;
+      // replace entry in cache by overwriting the key
+      entryPtr->key = pawnKey;
+      entryPtr->score = SCORE_ZERO;
     }
     // entry values will be overwritten in evaluatePawns and stored in cache or
     // the default entry
-    evaluatePawns(position, entryPtr);
+    evaluatePawns<P>(position, entryPtr);
     LOG__TRACE(Logger::get().EVAL_LOG, "Cache miss or no cache. Created cache entry: {}", entryPtr->str());
     LOG__TRACE(Logger::get().EVAL_LOG, "{:s}", pawnTableStats());
   }
 
-  // we have found a matching entry - add the respective mid and end values
-  // for the current game phase
-  const int value = static_cast<int>(entryPtr->midvalue * gamePhaseFactor +
-                                     entryPtr->endvalue * revGamePhaseFactor);
-  LOG__TRACE(Logger::get().EVAL_LOG, "Game phase adjusted pawn eval results in {} (midvalue={}, endvalue={}, weight={})", value * config.PAWNEVAL_WEIGHT, entryPtr->midvalue * gamePhaseFactor, entryPtr->endvalue * revGamePhaseFactor, config.PAWNEVAL_WEIGHT);
+  // we have found a matching entry - the score is tapered together with
+  // all other terms
+  LOG__TRACE(Logger::get().EVAL_LOG, "Pawn eval results in midvalue={}, endvalue={}, weight={}", mgValue(entryPtr->score), egValue(entryPtr->score), cfg.PAWNEVAL_WEIGHT);
+
+  return entryPtr->score * cfg.PAWNEVAL_WEIGHT;
+}
 
-  return value * config.PAWNEVAL_WEIGHT;
+Evaluator::PawnStructure Evaluator::pawnStructure(const Color c, const Bitboard myPawns, const Bitboard oppPawns) {
+  // evals inspired by Stockfish - all pawns are classified at once with
+  // bitboard fills instead of per pawn masks
+  PawnStructure ps;
+  const Bitboard files = fileFill(myPawns);
+  // no own pawns on the neighbour files
+  ps.isolated = myPawns & ~(shift(EAST, files) | shift(WEST, files));
+  // any other own pawn on the same file - both pawns are counted
+  ps.doubled = myPawns & (frontSpan(c, myPawns) | rearSpan(c, myPawns));
+  // no opponent pawns in front on the same or neighbour files and no own
+  // pawn in front
+  ps.passed = myPawns & ~(frontSpan(~c, oppPawns) | attackSpan(~c, oppPawns) | rearSpan(c, myPawns));
+  // any pawn in front on the same file
+  ps.blocked = myPawns & rearSpan(c, myPawns | oppPawns);
+  // pawns as neighbours in a row - both pawns are counted
+  ps.phalanx = myPawns & (shift(EAST, myPawns) | shift(WEST, myPawns));
+  // pawns protected by own pawns
+  ps.supported = myPawns & pawnAttackSet(c, myPawns);
+  return ps;
 }
 
-// TODO - template it
+template<class P>
 void Evaluator::evaluatePawns(const Position &position, Entry* const entry) {
+  const EvaluatorConfig &cfg = configOf<P>();
 
   // compiler will likely unroll this
   for (Color color = WHITE; color <= BLACK; ++color) {
     const Bitboard myPawns = position.getPieceBB(color, PAWN);
     const Bitboard oppPawns = position.getPieceBB(~color, PAWN);
-    // evals inspired by Stockfish
-
-    Bitboard isolated = EMPTY_BB;
-    Bitboard doubled = EMPTY_BB; // both pawns are counted
-    Bitboard passed = EMPTY_BB;
-    Bitboard blocked = EMPTY_BB;
-    Bitboard phalanx = EMPTY_BB; // both pawns are counted
-    Bitboard supported = EMPTY_BB;
-
-    // LOOP through all pawns of this color and type
-    Bitboard pawns = myPawns;
-    while (pawns) {
-      const Square sq = popLSB(pawns);
-      const Bitboard neighbours = myPawns & neighbourFilesMask[sq];
-      // isolated pawns
-      isolated |= neighbours ? EMPTY_BB : squareBB[sq];
-      // doubled pawns - any other of my pawns on same file
-      doubled |= ~squareBB[sq] & myPawns & sqToFileBB[sq];
-      // passed pawns - no opponent pawns in the area before me and no own pawn
-      // before me
-      passed |=
-        ((myPawns & sqToFileBB[sq]) | oppPawns) & passedPawnMask[color][sq]
-        ? EMPTY_BB
-        : squareBB[sq];
-      // blocked pawns
-      blocked |= ((myPawns & sqToFileBB[sq]) | oppPawns) &
-                 rays[color == WHITE ? N : S][sq]
-                 ? squareBB[sq]
-                 : EMPTY_BB;
-      // pawns as neighbours in a row = phalanx
-      phalanx |= myPawns & neighbours & sqToRankBB[sq];
-      // pawn as neighbours in the row forward = supported pawns
-      supported |= myPawns & neighbours &
-                   sqToRankBB[sq + (color == WHITE ? NORTH : SOUTH)];
-    }
+    const PawnStructure ps = pawnStructure(color, myPawns, oppPawns);
 
-    /*
-    fprintln("{} isolated : {} {}\n{}", !color ? "WHITE" : "BLACK",
-    popcount(isolated), printFlat(isolated), print(isolated)); fprintln("{}
-    doubled  : {} {}\n{}", !color ? "WHITE" : "BLACK", popcount(doubled),
-    printFlat(doubled), print(doubled)); fprintln("{} passed   : {} {}\n{}",
-    !color ? "WHITE" : "BLACK", popcount(passed), printFlat(passed),
-    print(passed)); fprintln("{} blocked  : {} {}\n{}", !color ? "WHITE" :
-    "BLACK", popcount(blocked), printFlat(blocked), print(blocked));
-    fprintln("{} phalanx  : {} {}\n{}", !color ? "WHITE" : "BLACK",
-    popcount(phalanx), printFlat(phalanx), print(phalanx)); fprintln("{}
-    supported: {} {}\n{}", !color ? "WHITE" : "BLACK", popcount(supported),
-    printFlat(supported), print(supported));
-    */
+    // keep for later eval terms
+    entry->passed[color] = ps.passed;
+    entry->attacks[color] = pawnAttackSet(color, myPawns);
 
     // @formatter:off
-    int midvalue =  popcount(isolated)  * config.ISOLATED_PAWN_MID_WEIGHT ;
-    int endvalue =  popcount(isolated)  * config.ISOLATED_PAWN_END_WEIGHT ;
-    midvalue    += (popcount(doubled)   * config.DOUBLED_PAWN_MID_WEIGHT  )/2;
-    endvalue    += (popcount(doubled)   * config.DOUBLED_PAWN_END_WEIGHT  )/2;
-    midvalue    +=  popcount(passed)    * config.PASSED_PAWN_MID_WEIGHT   ;
-    endvalue    +=  popcount(passed)    * config.PASSED_PAWN_END_WEIGHT   ;
-    midvalue    +=  popcount(blocked)   * config.BLOCKED_PAWN_MID_WEIGHT  ;
-    endvalue    +=  popcount(blocked)   * config.BLOCKED_PAWN_END_WEIGHT  ;
-    midvalue    += (popcount(phalanx)   * config.PHALANX_PAWN_MID_WEIGHT  )/2;
-    endvalue    += (popcount(phalanx)   * config.PHALANX_PAWN_END_WEIGHT  )/2;
-    midvalue    +=  popcount(supported) * config.SUPPORTED_PAWN_MID_WEIGHT;
-    endvalue    +=  popcount(supported) * config.SUPPORTED_PAWN_END_WEIGHT;
+    Score score =  popcount(ps.isolated)  * makeScore(cfg.ISOLATED_PAWN_MID_WEIGHT,  cfg.ISOLATED_PAWN_END_WEIGHT) ;
+    score       += (popcount(ps.doubled)   * makeScore(cfg.DOUBLED_PAWN_MID_WEIGHT,   cfg.DOUBLED_PAWN_END_WEIGHT))/2;
+    score       +=  popcount(ps.passed)    * makeScore(cfg.PASSED_PAWN_MID_WEIGHT,    cfg.PASSED_PAWN_END_WEIGHT)  ;
+    score       +=  popcount(ps.blocked)   * makeScore(cfg.BLOCKED_PAWN_MID_WEIGHT,   cfg.BLOCKED_PAWN_END_WEIGHT) ;
+    score       += (popcount(ps.phalanx)   * makeScore(cfg.PHALANX_PAWN_MID_WEIGHT,   cfg.PHALANX_PAWN_END_WEIGHT))/2;
+    score       +=  popcount(ps.supported) * makeScore(cfg.SUPPORTED_PAWN_MID_WEIGHT, cfg.SUPPORTED_PAWN_END_WEIGHT);
     // @formatter:on
 
     if (color == WHITE) {
-      entry->midvalue += midvalue;
-      entry->endvalue += endvalue;
+      entry->score += score;
     }
     else {
-      entry->midvalue -= midvalue;
-      entry->endvalue -= endvalue;
+      entry->score -= score;
     }
     LOG__TRACE(Logger::get().EVAL_LOG,
                "Raw pawn eval for {} results midvalue = {} and endvalue = {}",
-               color ? "BLACK" : "WHITE", midvalue, endvalue);
+               color ? "BLACK" : "WHITE", mgValue(score), egValue(score));
   }
 }
 
-template<Color C, PieceType PT>
-int Evaluator::evaluatePiece(const Position &position) {
+template<Color C, PieceType PT, class P>
+Score Evaluator::evaluatePiece(const Position &position) {
+  const EvaluatorConfig &cfg = configOf<P>();
   assert(PT != PAWN && PT != KING);
 
+  // piece terms do not depend on the game phase
   int value = 0;
+  Score score = SCORE_ZERO;
 
   // get all pieces of type PT from color C
   Bitboard pieces = position.getPieceBB(C, PT);
 
-  if (config.USE_PIECE_BONI) {
+  if (cfg.USE_PIECE_BONI) {
     // bonus/malus for bishop pair
     if (PT == BISHOP && popcount(pieces) >= 2) {
-      value += config.BISHOP_PAIR;
+      value += cfg.BISHOP_PAIR;
     }
     // bonus/malus for knight pair
     if (PT == KNIGHT && popcount(pieces) >= 2) {
-      value += config.KNIGHT_PAIR;
+      value += cfg.KNIGHT_PAIR;
     }
     // bonus/malus for rook pair
     if (PT == ROOK && popcount(pieces) >= 2) {
-      value += config.ROOK_PAIR;
+      value += cfg.ROOK_PAIR;
     }
   }
 
   // LOOP through all pieces of this color and type
   while (pieces) {
     const Square fromSquare = Bitboards::popLSB(pieces);
-    // MOBILITY
-    if (config.USE_MOBILITY) {
-      value += mobility<C, PT>(position, fromSquare);
-    }
-    if (config.USE_PIECE_BONI) {
+    if (cfg.USE_PIECE_BONI) {
       // trapped bishops
       const Bitboard myPawns = position.getPieceBB(C, PAWN);
       if (PT == BISHOP && fromSquare == (C ? SQ_C8 : SQ_C1)) {
         value += myPawns & ((C ? SQ_B7 : SQ_B2) | (C ? SQ_D7 : SQ_D2))
-                 ? config.TRAPPED_BISHOP_PENALTY
+                 ? cfg.TRAPPED_BISHOP_PENALTY
                  : 0;
       }
       if (PT == BISHOP && fromSquare == (C ? SQ_F1 : SQ_F8)) {
         value += myPawns & ((C ? SQ_E7 : SQ_E2) | (C ? SQ_G7 : SQ_G2))
-                 ? config.TRAPPED_BISHOP_PENALTY
+                 ? cfg.TRAPPED_BISHOP_PENALTY
                  : 0;
       }
     }
   }
 
-  LOG__TRACE(Logger::get().EVAL_LOG, "Raw piece eval for {} {:6} results in value = {}",
-             C ? "BLACK" : "WHITE", pieceTypeToString[PT], value);
-  return value;
-}
-
-template<Color C, PieceType PT>
-inline int Evaluator::mobility(const Position &position, const Square sq) {
-  const Bitboard occupiedBB = position.getOccupiedBB();
-  const Bitboard myPiecesBB = position.getOccupiedBB(C);
-  const Bitboard pseudoMoves = Bitboards::pseudoAttacks[PT][sq];
-  int tmpMobility = 0;
-  if (PT == KNIGHT) {
-    // knights can't be blocked
-    Bitboard moves = pseudoMoves & ~myPiecesBB;
-    tmpMobility += Bitboards::popcount(moves);
-  }
-  else { // sliding pieces
-    Bitboard pseudoTo = pseudoMoves & ~myPiecesBB;
-    while (pseudoTo) {
-      const Square toSquare = Bitboards::popLSB(pseudoTo);
-      if (config.USE_MOBILITY) {
-        if (!(Bitboards::intermediateBB[sq][toSquare] & occupiedBB)) {
-          tmpMobility += 1;
-        }
-      }
-    }
+  // MOBILITY - counted when computing the attack maps
+  if (cfg.USE_MOBILITY) {
+    value += attacks.mobility[C][PT] * cfg.MOBILITY_WEIGHT;
   }
-  return tmpMobility * config.MOBILITY_WEIGHT;
+
+  score += makeScore(value, value);
+  LOG__TRACE(Logger::get().EVAL_LOG, "Raw piece eval for {} {:6} results in value = {}/{}",
+             C ? "BLACK" : "WHITE", pieceTypeToString[PT], mgValue(score), egValue(score));
+  return score;
 }
 
-template<Color C>
-int Evaluator::evaluateKing(const Position &position) {
+template<Color C, class P>
+Score Evaluator::evaluateKing(const Position &position) {
+  const EvaluatorConfig &cfg = configOf<P>();
 
-  int value = 0;
+  Score score = SCORE_ZERO;
 
-  // king castle safety - skip in endgame
-  if (config.USE_KING_CASTLE_SAFETY) {
-    value += kingCastleSafety<C>(position);
+  // king castle safety and attacks on the king zone - skip in endgame
+  if (cfg.USE_KING_CASTLE_SAFETY) {
+    score += kingCastleSafety<C, P>(position);
   }
 
-  LOG__TRACE(Logger::get().EVAL_LOG, "Raw piece eval for {} {:6} results in value = {}",
-             C ? "BLACK" : "WHITE", pieceTypeToString[KING], value);
-  return value;
+  LOG__TRACE(Logger::get().EVAL_LOG, "Raw piece eval for {} {:6} results in value = {}/{}",
+             C ? "BLACK" : "WHITE", pieceTypeToString[KING], mgValue(score), egValue(score));
+  return score;
 }
 
-template<Color C>
-int Evaluator::kingCastleSafety(const Position &position) {
+template<Color C, class P>
+Score Evaluator::kingCastleSafety(const Position &position) {
+  const EvaluatorConfig &cfg = configOf<P>();
   const Bitboard myRooks = position.getPieceBB(C, ROOK);
   const Bitboard myPawns = position.getPieceBB(C, PAWN);
   const Square kingSquare = position.getKingSquare(C);
 
-  int value = 0;
+  // the pawn shield only counts in the mid game
+  const Score pawnShield = makeScore(cfg.KING_SAFETY_PAWNSHIELD, 0);
+  const Score trappedRook = makeScore(cfg.TRAPPED_ROOK_PENALTY, cfg.TRAPPED_ROOK_PENALTY);
+
+  Score score = SCORE_ZERO;
 
   // king in king side castle
   if (kingSideCastleMask[C] & kingSquare) {
@@ -368,11 +557,10 @@ int Evaluator::kingCastleSafety(const Position &position) {
         (squareBB[C ? SQ_H7 : SQ_H2] | squareBB[C ? SQ_H6 : SQ_H3] |
          squareBB[C ? SQ_H5 : SQ_H4]) &
         myPawns) {
-      value += static_cast<int>(config.KING_SAFETY_PAWNSHIELD *
-                                position.getGamePhaseFactor());
+      score += pawnShield;
       // trapped rook
       if (myRooks & rays[E][kingSquare]) {
-        value += config.TRAPPED_ROOK_PENALTY;
+        score += trappedRook;
       }
     }
   }
@@ -385,28 +573,109 @@ int Evaluator::kingCastleSafety(const Position &position) {
         (squareBB[C ? SQ_A7 : SQ_A2] | squareBB[C ? SQ_A6 : SQ_A3] |
          squareBB[C ? SQ_A5 : SQ_A4]) &
         myPawns) {
-      value += static_cast<int>(config.KING_SAFETY_PAWNSHIELD *
-                                position.getGamePhaseFactor());
+      score += pawnShield;
       // trapped rook
       if (myRooks & rays[W][kingSquare]) {
-        value += config.TRAPPED_ROOK_PENALTY;
+        score += trappedRook;
       }
     }
   }
 
-  return value * config.KING_CASTLE_SAFETY_WEIGHT;
+  // squares around the king attacked by the opponent (shared attack maps)
+  // - double attacks by other pieces than the opponent's king count twice
+  if (cfg.USE_KING_ATTACKS) {
+    const Bitboard kingZone = pseudoAttacks[KING][kingSquare];
+    const Bitboard attacked = attacks.all[~C] & ~attacks.byType[~C][KING];
+    const int count = popcount(kingZone & attacked) + popcount(kingZone & attacks.twice[~C]);
+    score += makeScore(count * cfg.KING_ZONE_ATTACK_PENALTY, 0);
+  }
+
+  return score * cfg.KING_CASTLE_SAFETY_WEIGHT;
+}
+
+void Evaluator::computeAttacks(const Position &position) {
+  computeAttacks<WHITE>(position);
+  computeAttacks<BLACK>(position);
+}
+
+template<Color C, PieceType PT>
+inline void Evaluator::pieceAttacks(const Position &position, Bitboard &all, Bitboard &twice) {
+  const Bitboard myPieces = position.getOccupiedBB(C);
+  Bitboard typeAttacks = EMPTY_BB;
+  int mobility = 0;
+  Bitboard pieces = position.getPieceBB(C, PT);
+  while (pieces) {
+    const Bitboard pieceAttacks = attacksFrom<PT>(position, popLSB(pieces));
+    mobility += popcount(pieceAttacks & ~myPieces);
+    typeAttacks |= pieceAttacks;
+    twice |= all & pieceAttacks;
+    all |= pieceAttacks;
+  }
+  attacks.byType[C][PT] = typeAttacks;
+  attacks.mobility[C][PT] = mobility;
+}
+
+template<Color C>
+void Evaluator::computeAttacks(const Position &position) {
+  Bitboard (&byType)[PT_LENGTH] = attacks.byType[C];
+
+  // pawns set-wise - two pawns attacking the same square are double attacks
+  const Bitboard pawns = position.getPieceBB(C, PAWN);
+  const Bitboard pawnsLeft = shift(C == WHITE ? NORTH_WEST : SOUTH_WEST, pawns);
+  const Bitboard pawnsRight = shift(C == WHITE ? NORTH_EAST : SOUTH_EAST, pawns);
+  byType[PAWN] = pawnsLeft | pawnsRight;
+  Bitboard all = byType[PAWN];
+  Bitboard twice = pawnsLeft & pawnsRight;
+
+  byType[KING] = pseudoAttacks[KING][position.getKingSquare(C)];
+  twice |= all & byType[KING];
+  all |= byType[KING];
+
+  pieceAttacks<C, KNIGHT>(position, all, twice);
+  pieceAttacks<C, BISHOP>(position, all, twice);
+  pieceAttacks<C, ROOK>(position, all, twice);
+  pieceAttacks<C, QUEEN>(position, all, twice);
+
+  attacks.all[C] = all;
+  attacks.twice[C] = twice;
+}
+
+template<Color C, class P>
+Score Evaluator::evaluateThreats(const Position &position) {
+  const EvaluatorConfig &cfg = configOf<P>();
+  const Bitboard (&oppAttacks)[PT_LENGTH] = attacks.byType[~C];
+  const Bitboard pieces = position.getOccupiedBB(C)
+                          & ~position.getPieceBB(C, PAWN) & ~position.getPieceBB(C, KING);
+  const Bitboard majors = position.getPieceBB(C, ROOK) | position.getPieceBB(C, QUEEN);
+
+  // attacked pieces without a defender
+  const int hanging = popcount(pieces & attacks.all[~C] & ~attacks.all[C]);
+  // attacks by pieces of lower value win material even when defended
+  const int byPawn = popcount(pieces & oppAttacks[PAWN]);
+  const int byMinor = popcount(majors & (oppAttacks[KNIGHT] | oppAttacks[BISHOP]));
+
+  const int value = hanging * cfg.HANGING_PIECE_PENALTY
+                    + byPawn * cfg.THREAT_BY_PAWN_PENALTY
+                    + byMinor * cfg.THREAT_BY_MINOR_PENALTY;
+  LOG__TRACE(Logger::get().EVAL_LOG, "Raw threat eval for {} hanging {} by pawn {} by minor {} results in value = {}",
+             C ? "BLACK" : "WHITE", hanging, byPawn, byMinor, value);
+  return makeScore(value, value);
 }
 
 // explicitly instantiate all template definitions so other classes can see them
 // @formatter:off
-template int Evaluator::evaluatePiece<Color::WHITE, PieceType::KNIGHT>(const Position &position);
-template int Evaluator::evaluatePiece<Color::WHITE, PieceType::BISHOP>(const Position &position);
-template int Evaluator::evaluatePiece<Color::WHITE, PieceType::ROOK>(const Position &position);
-template int Evaluator::evaluatePiece<Color::WHITE, PieceType::QUEEN>(const Position &position);
-template int Evaluator::evaluatePiece<Color::WHITE, PieceType::KING>(const Position &position);
-template int Evaluator::evaluatePiece<Color::BLACK, PieceType::KNIGHT>(const Position &position);
-template int Evaluator::evaluatePiece<Color::BLACK, PieceType::BISHOP>(const Position &position);
-template int Evaluator::evaluatePiece<Color::BLACK, PieceType::ROOK>(const Position &position);
-template int Evaluator::evaluatePiece<Color::BLACK, PieceType::QUEEN>(const Position &position);
-template int Evaluator::evaluatePiece<Color::BLACK, PieceType::KING>(const Position &position);
+template Score Evaluator::evaluatePiece<Color::WHITE, PieceType::KNIGHT>(const Position &position);
+template Score Evaluator::evaluatePiece<Color::WHITE, PieceType::BISHOP>(const Position &position);
+template Score Evaluator::evaluatePiece<Color::WHITE, PieceType::ROOK>(const Position &position);
+template Score Evaluator::evaluatePiece<Color::WHITE, PieceType::QUEEN>(const Position &position);
+template Score Evaluator::evaluatePiece<Color::WHITE, PieceType::KING>(const Position &position);
+template Score Evaluator::evaluatePiece<Color::BLACK, PieceType::KNIGHT>(const Position &position);
+template Score Evaluator::evaluatePiece<Color::BLACK, PieceType::BISHOP>(const Position &position);
+template Score Evaluator::evaluatePiece<Color::BLACK, PieceType::ROOK>(const Position &position);
+template Score Evaluator::evaluatePiece<Color::BLACK, PieceType::QUEEN>(const Position &position);
+template Score Evaluator::evaluatePiece<Color::BLACK, PieceType::KING>(const Position &position);
+template Score Evaluator::evaluateThreats<Color::WHITE>(const Position &position);
+template Score Evaluator::evaluateThreats<Color::BLACK>(const Position &position);
+template Score Evaluator::pawnEval(const Position &position);
+template void Evaluator::evaluatePawns(const Position &position, Entry* entry);
 // @formatter:on
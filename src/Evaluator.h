@@ -38,7 +38,7 @@
 
 #ifdef EVAL_ENABLE_PREFETCH
 #include <emmintrin.h>
-#define EVAL_PREFETCH pEvaluator->prefetch(position.getPieceBB(WHITE, PAWN) | position.getPieceBB(BLACK, PAWN))
+#define EVAL_PREFETCH pEvaluator->prefetch(position.getPawnKey())
 #else
 #define EVAL_PREFETCH void(0);
 #endif
@@ -47,18 +47,49 @@
 // forward declared dependencies
 class Position;
 
+/**
+ * Term by term breakdown of an evaluation filled by Evaluator::trace().
+ * All scores are from the view of the respective color, the totals are
+ * from the view of white.
+ */
+struct EvalTrace {
+  enum Term : int {
+    MATERIAL, IMBALANCE, PSQT, PAWNS, KNIGHTS, BISHOPS, ROOKS, QUEENS, KING, THREATS, CHECK, TERM_LENGTH
+  };
+  static constexpr const char* termNames[TERM_LENGTH] = {
+    "Material", "Imbalance", "PSQT", "Pawns", "Knights", "Bishops", "Rooks", "Queens", "King", "Threats", "Check"
+  };
+
+  // imbalance and pawns are only evaluated as the difference between the
+  // colors which is stored for white
+  Score scores[TERM_LENGTH][COLOR_LENGTH]{};
+  double gamePhaseFactor = 0.0;
+  // of Material::SCALE_NORMAL
+  int scale = 0;
+  int tempo = 0;
+  // set if the value was not computed from the terms (draw, endgame, network)
+  std::string shortcut{};
+  // final value from the view of the side to move
+  Value value = VALUE_NONE;
+
+  Score total(Term term) const { return scores[term][WHITE] - scores[term][BLACK]; }
+  std::string str() const;
+};
+
 class Evaluator {
 
 //  std::shared_ptr<spdlog::logger> LOG = spdlog::get("Eval_Logger");
 
-  /** Entry class for the eval cache */
+  /** Entry class for the pawn table */
   struct Entry {
-    Bitboard pawnBitboard = 0;
-    int midvalue = 0;
-    int endvalue = 0;
+    Key key = 0; // pawn zobrist key of the position
+    Score score = SCORE_ZERO;
+    // passed pawns and squares attacked by pawns of each color
+    Bitboard passed[COLOR_LENGTH]{};
+    Bitboard attacks[COLOR_LENGTH]{};
 
     std::string str() const {
-      return fmt::format("id {} midvalue {} endvalue {}", pawnBitboard, midvalue, endvalue);
+      return fmt::format("key {} midvalue {} endvalue {}", key, mgValue(score), egValue(score));
     }
 
     std::ostream &operator<<(std::ostream &os) {
@@ -71,10 +102,10 @@ class Evaluator {
   typedef std::vector<Entry> Table;
   Table pawnTable;
   /** if eval cache is turned off this holds the pawn eval */
-  Entry defaultEntry{0, 0, 0};
+  Entry defaultEntry{};
 
-  inline std::size_t getTableIndex(const Bitboard pawnsBitboard) const {
-    return pawnsBitboard & (config.PAWN_TABLE_SIZE - 1);
+  inline std::size_t getTableIndex(const Key pawnKey) const {
+    return pawnKey & (config.PAWN_TABLE_SIZE - 1);
   }
 
   /** stats for cache */
@@ -83,8 +114,66 @@ class Evaluator {
   std::size_t cacheMisses = 0;
   std::size_t cacheReplace = 0;
 
+  /**
+   * Entry class for the eval cache which stores the final evaluation of a
+   * position. The lower bits of the zobrist key are the index into the cache
+   * and the upper 32 bits are stored to verify the position.
+   */
+  struct EvalEntry {
+    uint32_t key = 0;
+    Value value = VALUE_NONE;
+  };
+
+  /** eval cache */
+  std::vector<EvalEntry> evalCache;
+  std::size_t evalCacheMask = 0;
+
+  /** stats for eval cache */
+  std::size_t evalCacheHits = 0;
+  std::size_t evalCacheMisses = 0;
+
+  /**
+   * Attack maps of both colors. They are computed once per evaluation by
+   * computeAttacks() and shared by mobility, king safety and threat terms.
+   */
+  struct Attacks {
+    // squares attacked by pieces of a piece type
+    Bitboard byType[COLOR_LENGTH][PT_LENGTH]{};
+    // squares attacked by any piece
+    Bitboard all[COLOR_LENGTH]{};
+    // squares attacked by at least two pieces
+    Bitboard twice[COLOR_LENGTH]{};
+    // number of squares not occupied by own pieces the pieces of a type attack
+    int mobility[COLOR_LENGTH][PT_LENGTH]{};
+  };
+  Attacks attacks;
+
+  /** stats for lazy evaluation */
+  std::size_t evalCalls = 0;
+  std::size_t lazyEvals = 0;
+  bool lastEvalLazy = false;
+
+  /** evaluate with the StaticEvalPolicy - set by updatePolicy() */
+  bool staticEval = false;
+
+  /** target of trace() - only used by the TracedEvalPolicy */
+  EvalTrace* pTrace = nullptr;
+
 public:
 
+  /** pawns of one color classified by their structure */
+  struct PawnStructure {
+    Bitboard isolated = 0;
+    Bitboard doubled = 0;
+    Bitboard passed = 0;
+    Bitboard blocked = 0;
+    Bitboard phalanx = 0;
+    Bitboard supported = 0;
+  };
+
+  /** Classifies all pawns of color c at once using bitboard fills */
+  static PawnStructure pawnStructure(Color c, Bitboard myPawns, Bitboard oppPawns);
+
   Evaluator(); // constructor
   explicit Evaluator(std::size_t pawnEvalCacheSize); // constructor
   ~Evaluator() = default;
@@ -95,43 +184,155 @@ public:
 
   EvaluatorConfig config{};
 
+  /**
+   * Uses the compile time constants of the default config (StaticEvalPolicy)
+   * for the following evaluations when the config matches them and reads
+   * the config at runtime otherwise. Needs to be called again after the
+   * config has been changed - the search calls it at the start of each search.
+   */
+  void updatePolicy() { staticEval = StaticEvalPolicy::matchesConfig(config); }
+
+  /** true if the evaluation uses the StaticEvalPolicy (see updatePolicy()) */
+  bool isStatic() const { return staticEval; }
+
   void resizePawnTable(size_t size);
 
-  Value evaluate(const Position &position);
+  /**
+   * Resizes and clears the eval cache to the largest power of two number of
+   * entries fitting into the given size. 0 removes the cache.
+   */
+  void resizeEvalCache(std::size_t sizeInMB);
+
+  /**
+   * Clears the eval cache. Needs to be called when the evaluation config has
+   * been changed after positions have been evaluated.
+   */
+  void clearEvalCache();
+
+  /** Clears the pawn table - needed after changes to the pawn evaluation config */
+  void clearPawnTable();
+
+  /** Evaluates the position from the view of the side to move. */
+  Value evaluate(const Position &position) {
+    return evaluate(position, VALUE_MIN, VALUE_MAX);
+  }
+
+  /**
+   * Evaluates the position from the view of the side to move. When the
+   * material and positional value is already outside of the alpha beta
+   * window by more than config.LAZY_EVAL_MARGIN the remaining terms are
+   * skipped and this estimate is returned (see wasLazy()).
+   */
+  Value evaluate(const Position &position, Value alpha, Value beta);
+
+  /**
+   * Evaluates the position like evaluate() with the runtime config and
+   * writes every term to the trace. The trace code only exists in this
+   * instantiation - evaluate() does not pay for it.
+   */
+  Value trace(const Position &position, EvalTrace &evalTrace);
+
+  /** true if the last call to evaluate() returned a lazy estimate */
+  bool wasLazy() const { return lastEvalLazy; }
 
   std::string pawnTableStats() const {
+    const std::size_t probes = cacheHits + cacheMisses;
     return fmt::format("Cache stats: capacity {:n} entries {:n} hits {:n} "
-                       "misses {:n} replace {:n}",
+                       "misses {:n} replace {:n} hit rate {:.1f}%",
                        pawnTable.capacity(), cacheEntries, cacheHits,
-                       cacheMisses, cacheReplace);
+                       cacheMisses, cacheReplace,
+                       probes ? 100.0 * cacheHits / probes : 0.0);
+  }
+
+  std::string evalCacheStats() const {
+    const std::size_t probes = evalCacheHits + evalCacheMisses;
+    return fmt::format("Eval cache stats: capacity {:n} hits {:n} misses {:n} hit rate {:.1f}%",
+                       evalCache.size(), evalCacheHits, evalCacheMisses,
+                       probes ? 100.0 * evalCacheHits / probes : 0.0);
+  }
+
+  std::string lazyEvalStats() const {
+    return fmt::format("Lazy eval stats: evaluations {:n} lazy {:n} ({:.1f}%)",
+                       evalCalls, lazyEvals,
+                       evalCalls ? 100.0 * lazyEvals / evalCalls : 0.0);
   }
 
-  inline void prefetch(const Bitboard &pawnBitboard) const {
+  inline void prefetch(const Key pawnKey) const {
 #ifdef EVAL_ENABLE_PREFETCH
-    _mm_prefetch(&pawnTable[getTableIndex(pawnBitboard)], _MM_HINT_T0);
+    _mm_prefetch(&pawnTable[getTableIndex(pawnKey)], _MM_HINT_T0);
 #endif
   }
 
 private:
 
-  int pawnEval(const Position &position);
+  /** the config of the policy - constants for the static policy */
+  template<class P>
+  constexpr const EvaluatorConfig &configOf() const {
+    if constexpr (P::IS_STATIC) return P::CONFIG;
+    else return config;
+  }
+
+  template<class P>
+  Value evaluatePosition(const Position &position, Value alpha, Value beta);
+
+  /** records a term of both colors when tracing and returns the difference */
+  template<class P>
+  Score traceTerm(EvalTrace::Term term, Score white, Score black) {
+    if constexpr (P::TRACE) {
+      pTrace->scores[term][WHITE] = white;
+      pTrace->scores[term][BLACK] = black;
+    }
+    return white - black;
+  }
+
+  /** records a value which has not been computed from the terms when tracing */
+  template<class P>
+  Value traceShortcut(const char* shortcut, Value value) {
+    if constexpr (P::TRACE) {
+      pTrace->shortcut = shortcut;
+      pTrace->value = value;
+    }
+    return value;
+  }
+
+  template<class P>
+  Value evaluateKPK(const Position &position) const;
 
+  template<class P>
+  Value evaluateKXK(const Position &position, Color strong) const;
+
+  template<class P = RuntimeEvalPolicy>
+  Score pawnEval(const Position &position);
+
+  template<class P = RuntimeEvalPolicy>
   void evaluatePawns(const Position &position, Entry* entry);
 
-  template<Color C, PieceType PT>
-  int evaluatePiece(const Position &position);
+  template<Color C, PieceType PT, class P = RuntimeEvalPolicy>
+  Score evaluatePiece(const Position &position);
 
-  template<Color C, PieceType PT>
-  int mobility(const Position &position, Square sq);
+  void computeAttacks(const Position &position);
 
   template<Color C>
-  int evaluateKing(const Position &position);
+  void computeAttacks(const Position &position);
 
-  template<Color C>
-  int kingCastleSafety(const Position &position);
+  template<Color C, PieceType PT>
+  void pieceAttacks(const Position &position, Bitboard &all, Bitboard &twice);
+
+  template<Color C, class P = RuntimeEvalPolicy>
+  Score evaluateThreats(const Position &position);
+
+  template<Color C, class P>
+  Score evaluateKing(const Position &position);
+
+  template<Color C, class P>
+  Score kingCastleSafety(const Position &position);
 
   FRIEND_TEST(EvaluatorTest, evaluatePieceMobility);
   FRIEND_TEST(EvaluatorTest, evaluatePawns);
+  FRIEND_TEST(EvaluatorTest, attacks);
+  FRIEND_TEST(EvaluatorTest, threats);
+  FRIEND_TEST(SearchTest, pawnTable);
+  FRIEND_TEST(SearchTest, evalCache);
 
 };
 
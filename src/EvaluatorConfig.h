@@ -31,14 +31,35 @@
 struct EvaluatorConfig {
 
   bool USE_PAWN_TABLE = true;
-  std::size_t PAWN_TABLE_SIZE = 1'048'576; // 2^20
+  std::size_t PAWN_TABLE_SIZE = 262'144; // 2^18 entries of 48 byte
+
+  // enabled but with size 0 (no cache) until configured with the UCI
+  // option EvalCache as the static eval stored in the TT already catches
+  // most transpositions - 2 MB gives 2^18 entries of 8 byte
+  bool USE_EVAL_CACHE = true;
+  std::size_t EVAL_CACHE_SIZE_MB = 0;
 
   // set values for bonus > 0 and for penalty < 0
 
    int TEMPO = 30;
 
+   // lazy evaluation skips the expensive terms when material and position
+   // are already outside of the search window by more than the margin
+   bool USE_LAZY_EVAL = true;
+   int LAZY_EVAL_MARGIN = 300;
+
+   bool USE_KPK_BITBASE = true;
+   int KPK_WIN_BONUS = 500;
+
+   bool USE_KXK = true;
+   int KXK_WIN_BONUS = 1000;
+
    bool USE_MATERIAL = true;
    int MATERIAL_WEIGHT = 1;
+   // piece values depending on the number of own pawns (material table)
+   bool USE_IMBALANCE = true;
+   // scale down values of material which is hard to win with (material table)
+   bool USE_MATERIAL_SCALE = true;
 
    bool USE_POSITION = true;
    int POSITION_WEIGHT = 1;
@@ -75,6 +96,94 @@ struct EvaluatorConfig {
    int TRAPPED_ROOK_PENALTY = -50;
    int TRAPPED_BISHOP_PENALTY = -50;
 
+   // part of the king castle safety: squares around the king attacked by
+   // the opponent - counted twice when attacked by more than one piece
+   bool USE_KING_ATTACKS = true;
+   int KING_ZONE_ATTACK_PENALTY = -42;
+
+   // pieces attacked and not defended or attacked by lower value pieces
+   bool USE_THREATS = true;
+   int HANGING_PIECE_PENALTY = -25;
+   int THREAT_BY_PAWN_PENALTY = -48;
+   int THREAT_BY_MINOR_PENALTY = -53;
+
+};
+
+/**
+ * The production evaluation with the default EvaluatorConfig as compile
+ * time constants. Disabled terms and multiplications by weights of 1 are
+ * removed by the compiler. Only used when the evaluator's config matches -
+ * otherwise the evaluator falls back to the RuntimeEvalPolicy.
+ */
+struct StaticEvalPolicy {
+  static constexpr bool IS_STATIC = true;
+  static constexpr bool TRACE = false;
+  static constexpr EvaluatorConfig CONFIG{};
+
+  /**
+   * true if the evaluation terms and weights of the config have the values
+   * of CONFIG - pawn table and eval cache settings are always read at runtime
+   */
+  static bool matchesConfig(const EvaluatorConfig &config) {
+    return CONFIG.TEMPO == config.TEMPO &&
+           CONFIG.USE_LAZY_EVAL == config.USE_LAZY_EVAL &&
+           CONFIG.LAZY_EVAL_MARGIN == config.LAZY_EVAL_MARGIN &&
+           CONFIG.USE_KPK_BITBASE == config.USE_KPK_BITBASE &&
+           CONFIG.KPK_WIN_BONUS == config.KPK_WIN_BONUS &&
+           CONFIG.USE_KXK == config.USE_KXK &&
+           CONFIG.KXK_WIN_BONUS == config.KXK_WIN_BONUS &&
+           CONFIG.USE_MATERIAL == config.USE_MATERIAL &&
+           CONFIG.MATERIAL_WEIGHT == config.MATERIAL_WEIGHT &&
+           CONFIG.USE_IMBALANCE == config.USE_IMBALANCE &&
+           CONFIG.USE_MATERIAL_SCALE == config.USE_MATERIAL_SCALE &&
+           CONFIG.USE_POSITION == config.USE_POSITION &&
+           CONFIG.POSITION_WEIGHT == config.POSITION_WEIGHT &&
+           CONFIG.USE_MOBILITY == config.USE_MOBILITY &&
+           CONFIG.MOBILITY_WEIGHT == config.MOBILITY_WEIGHT &&
+           CONFIG.USE_PAWNEVAL == config.USE_PAWNEVAL &&
+           CONFIG.PAWNEVAL_WEIGHT == config.PAWNEVAL_WEIGHT &&
+           CONFIG.ISOLATED_PAWN_MID_WEIGHT == config.ISOLATED_PAWN_MID_WEIGHT &&
+           CONFIG.ISOLATED_PAWN_END_WEIGHT == config.ISOLATED_PAWN_END_WEIGHT &&
+           CONFIG.DOUBLED_PAWN_MID_WEIGHT == config.DOUBLED_PAWN_MID_WEIGHT &&
+           CONFIG.DOUBLED_PAWN_END_WEIGHT == config.DOUBLED_PAWN_END_WEIGHT &&
+           CONFIG.PASSED_PAWN_MID_WEIGHT == config.PASSED_PAWN_MID_WEIGHT &&
+           CONFIG.PASSED_PAWN_END_WEIGHT == config.PASSED_PAWN_END_WEIGHT &&
+           CONFIG.BLOCKED_PAWN_MID_WEIGHT == config.BLOCKED_PAWN_MID_WEIGHT &&
+           CONFIG.BLOCKED_PAWN_END_WEIGHT == config.BLOCKED_PAWN_END_WEIGHT &&
+           CONFIG.PHALANX_PAWN_MID_WEIGHT == config.PHALANX_PAWN_MID_WEIGHT &&
+           CONFIG.PHALANX_PAWN_END_WEIGHT == config.PHALANX_PAWN_END_WEIGHT &&
+           CONFIG.SUPPORTED_PAWN_MID_WEIGHT == config.SUPPORTED_PAWN_MID_WEIGHT &&
+           CONFIG.SUPPORTED_PAWN_END_WEIGHT == config.SUPPORTED_PAWN_END_WEIGHT &&
+           CONFIG.USE_CHECK_BONUS == config.USE_CHECK_BONUS &&
+           CONFIG.CHECK_VALUE == config.CHECK_VALUE &&
+           CONFIG.USE_PIECE_BONI == config.USE_PIECE_BONI &&
+           CONFIG.BISHOP_PAIR == config.BISHOP_PAIR &&
+           CONFIG.KNIGHT_PAIR == config.KNIGHT_PAIR &&
+           CONFIG.ROOK_PAIR == config.ROOK_PAIR &&
+           CONFIG.USE_KING_CASTLE_SAFETY == config.USE_KING_CASTLE_SAFETY &&
+           CONFIG.KING_CASTLE_SAFETY_WEIGHT == config.KING_CASTLE_SAFETY_WEIGHT &&
+           CONFIG.KING_SAFETY_PAWNSHIELD == config.KING_SAFETY_PAWNSHIELD &&
+           CONFIG.TRAPPED_ROOK_PENALTY == config.TRAPPED_ROOK_PENALTY &&
+           CONFIG.TRAPPED_BISHOP_PENALTY == config.TRAPPED_BISHOP_PENALTY &&
+           CONFIG.USE_KING_ATTACKS == config.USE_KING_ATTACKS &&
+           CONFIG.KING_ZONE_ATTACK_PENALTY == config.KING_ZONE_ATTACK_PENALTY &&
+           CONFIG.USE_THREATS == config.USE_THREATS &&
+           CONFIG.HANGING_PIECE_PENALTY == config.HANGING_PIECE_PENALTY &&
+           CONFIG.THREAT_BY_PAWN_PENALTY == config.THREAT_BY_PAWN_PENALTY &&
+           CONFIG.THREAT_BY_MINOR_PENALTY == config.THREAT_BY_MINOR_PENALTY;
+  }
+};
+
+/** Evaluation terms and weights are read from the evaluator's config (tests and tuning) */
+struct RuntimeEvalPolicy {
+  static constexpr bool IS_STATIC = false;
+  static constexpr bool TRACE = false;
+};
+
+/** Runtime config and every term written to an EvalTrace (Evaluator::trace()) */
+struct TracedEvalPolicy {
+  static constexpr bool IS_STATIC = false;
+  static constexpr bool TRACE = true;
 };
 
 #endif //FRANKYCPP_EVALUATORCONFIG_H
@@ -33,7 +33,8 @@
 #include <optional>
 
 /**
- * Synchronized FIFO queue based on std::queue and std::deque
+ * Synchronized FIFO queue based on std::queue and std::deque.
+ * Optionally bounded - push then blocks while the queue is full.
  * @tparam T
  */
 template<class T>
@@ -41,16 +42,29 @@ class Fifo {
 
   mutable std::mutex fifoLock;
   mutable std::condition_variable cv;
+  mutable std::condition_variable notFullCv;
 
   std::queue<T, std::deque<T>> fifo;
 
   bool closedFlag = false;
 
+  // maximum number of items - 0 is unbounded
+  std::size_t capacity = 0;
+
+  // waits until there is room for another item or the fifo has been closed
+  void waitNotFull(std::unique_lock<std::mutex> &lock) {
+    notFullCv.wait(lock, [this] { return capacity == 0 || fifo.size() < capacity || closedFlag; });
+  }
+
 public:
   Fifo() {
     LOG__TRACE(Logger::get().MAIN_LOG, "Constructor");
   }
 
+  explicit Fifo(std::size_t maxSize) : capacity(maxSize) {
+    LOG__TRACE(Logger::get().MAIN_LOG, "Constructor with capacity {}", maxSize);
+  }
+
   ~Fifo() = default;
 
   // copy
@@ -58,6 +72,7 @@ public:
     LOG__TRACE(Logger::get().MAIN_LOG, "Copy constructor");
     std::scoped_lock lock{other.fifoLock};
     fifo = other.fifo;
+    capacity = other.capacity;
   }
 
   // copy assignment
@@ -65,6 +80,7 @@ public:
     LOG__TRACE(Logger::get().MAIN_LOG, "Copy assignment");
     std::scoped_lock lock(fifoLock, other.fifoLock);
     fifo = other.fifo;
+    capacity = other.capacity;
     return *this;
   }
 
@@ -73,6 +89,7 @@ public:
     LOG__TRACE(Logger::get().MAIN_LOG, "Move constructor");
     std::scoped_lock lock{other.fifoLock};
     fifo = std::move(other.fifo);
+    capacity = other.capacity;
   }
 
   // move assignment
@@ -81,13 +98,15 @@ public:
     if (this != &other) {
       std::scoped_lock lock(fifoLock, other.fifoLock);
       fifo = std::move(other.fifo);
+      capacity = other.capacity;
     }
     return *this;
   }
 
   void push(T &t) {
     {
-      std::scoped_lock<std::mutex> lock{fifoLock};
+      std::unique_lock<std::mutex> lock{fifoLock};
+      waitNotFull(lock);
       LOG__TRACE(Logger::get().MAIN_LOG, "Reference push");
       fifo.push(t);
     }
@@ -96,7 +115,8 @@ public:
 
   void push(T &&t) {
     {
-      std::scoped_lock<std::mutex> lock{fifoLock};
+      std::unique_lock<std::mutex> lock{fifoLock};
+      waitNotFull(lock);
       LOG__TRACE(Logger::get().MAIN_LOG, "Move push");
       fifo.push(std::move(t));
     }
@@ -114,6 +134,7 @@ public:
     LOG__TRACE(Logger::get().MAIN_LOG, "Value pop");
     std::optional<T> t{fifo.front()};
     fifo.pop();
+    notFullCv.notify_one();
     return t;
   }
 
@@ -129,6 +150,7 @@ public:
     LOG__TRACE(Logger::get().MAIN_LOG, "Reference pop");
     t.emplace(fifo.front());
     fifo.pop();
+    notFullCv.notify_one();
     return t;
   }
 
@@ -145,6 +167,7 @@ public:
     if (fifo.empty()) return std::nullopt;
     std::optional<T> t{fifo.front()};
     fifo.pop();
+    notFullCv.notify_one();
     return t;
   }
 
@@ -161,6 +184,7 @@ public:
     if (fifo.empty()) return std::nullopt;
     t.emplace(fifo.front());
     fifo.pop();
+    notFullCv.notify_one();
     return t;
   }
 
@@ -168,6 +192,7 @@ public:
     std::scoped_lock<std::mutex> lock{fifoLock};
     closedFlag = true;
     cv.notify_all();
+    notFullCv.notify_all();
   }
 
   void open() {
@@ -27,6 +27,8 @@
 #include "Values.h"
 #include "Bitboards.h"
 #include "Position.h"
+#include "Bitbase.h"
+#include "Material.h"
 
 namespace INIT {
   static bool INITIALIZED = false;
@@ -36,6 +38,8 @@ namespace INIT {
     Values::init();
     Bitboards::init();
     Position::init();
+    Bitbase::init();
+    Material::init();
     INITIALIZED = true;
     Logger::get().MAIN_LOG->info("Data initialization done");
   }
@@ -0,0 +1,252 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "Logging.h"
+#include "MateSolver.h"
+#include "Position.h"
+
+MateSolver::MateSolver(std::size_t sizeInMB) {
+  resize(sizeInMB);
+}
+
+void MateSolver::resize(std::size_t sizeInMB) {
+  // number of buckets (2 entries each) as power of two
+  std::size_t buckets = 1;
+  while (buckets * 2 * 2 * sizeof(Entry) <= sizeInMB * MB) {
+    buckets *= 2;
+  }
+  table.assign(buckets * 2, Entry{});
+  bucketMask = buckets - 1;
+  LOG__INFO(Logger::get().SEARCH_LOG, "Mate solver table of size {:.2F} MB created with {:n} entries",
+            static_cast<double>(table.size() * sizeof(Entry)) / MB, table.size());
+}
+
+void MateSolver::clear() {
+  std::fill(table.begin(), table.end(), Entry{});
+}
+
+Value MateSolver::solve(Position &position, int mateIn, const std::function<bool()> &stop) {
+  stopCallback = stop;
+  aborted = false;
+  nodes = 0;
+  pv.clear();
+  moveGenerators.resize(2 * mateIn + 1);
+  childInfos.resize(2 * mateIn + 1);
+
+  for (int n = 1; n <= mateIn; n++) {
+    const int remaining = 2 * n - 1;
+    mid(position, remaining, 0, INF, INF);
+    if (aborted) {
+      LOG__DEBUG(Logger::get().SEARCH_LOG, "Mate solver stopped in mate {} search after {:n} nodes", n, nodes);
+      return VALUE_NONE;
+    }
+    uint32_t phi, delta;
+    lookup(position, remaining, phi, delta);
+    if (phi == 0) {
+      extractPV(position, remaining);
+      LOG__DEBUG(Logger::get().SEARCH_LOG, "Mate solver found mate {} after {:n} nodes: {}", n, nodes, printMoveListUCI(pv));
+      return static_cast<Value>(VALUE_CHECKMATE - remaining);
+    }
+    LOG__DEBUG(Logger::get().SEARCH_LOG, "Mate solver: no mate in {} ({:n} nodes)", n, nodes);
+  }
+  return VALUE_NONE;
+}
+
+void MateSolver::mid(Position &position, int remaining, int ply, uint32_t thPhi, uint32_t thDelta) {
+  nodes++;
+  if (stopCallback && stopCallback()) {
+    aborted = true;
+    return;
+  }
+  const uint64_t startNodes = nodes;
+
+  // the attacker is to move when the remaining plies are odd
+  const bool attacker = remaining & 1;
+
+  const MoveList* moves = moveGenerators[ply].generateLegalMoves<MoveGenerator::GENALL>(position);
+
+  // terminal nodes - no moves or the defender is out of plies
+  if (moves->empty() || remaining == 0) {
+    // the side to move has lost when it is mated or is the attacker
+    // (stalemate, out of plies) - otherwise the defender has escaped
+    const bool lost = attacker || (moves->empty() && position.hasCheck());
+    store(position, remaining, lost ? INF : 0, lost ? 0 : INF, 1, MOVE_NONE);
+    return;
+  }
+
+  // with one ply left the node is solved directly - only a check leaving
+  // the defender without a legal move is a mate
+  if (remaining == 1) {
+    for (Move move : *moves) {
+      if (!position.givesCheck(move)) continue;
+      position.doMove(move);
+      const bool mate = !MoveGenerator::hasLegalMove(position);
+      position.undoMove();
+      if (mate) {
+        store(position, remaining, 0, INF, 1, move);
+        return;
+      }
+    }
+    store(position, remaining, INF, 0, 1, moves->front());
+    return;
+  }
+
+  // the children's table keys are computed once as the children are
+  // looked up in every iteration
+  std::vector<Child> &children = childInfos[ply];
+  children.clear();
+  for (Move move : *moves) {
+    const bool check = attacker && position.givesCheck(move);
+    position.doMove(move);
+    children.push_back({tableKey(position.getZobristKey(), remaining - 1), check});
+    position.undoMove();
+  }
+
+  while (true) {
+    // phi is the smallest delta of the children and delta is the sum of
+    // the children's phi
+    uint32_t phi = INF;
+    uint32_t delta = 0;
+    uint32_t delta2 = INF;
+    uint32_t bestPhi = INF;
+    Move bestMove = MOVE_NONE;
+    for (std::size_t i = 0; i < moves->size(); i++) {
+      const Move move = (*moves)[i];
+      uint32_t childPhi, childDelta;
+      if (!lookup(children[i].key, childPhi, childDelta) && attacker && !children[i].check) {
+        // checks are tried first by the attacker
+        childDelta = 4;
+      }
+      delta = std::min(INF, delta + childPhi);
+      if (childDelta < phi) {
+        delta2 = phi;
+        phi = childDelta;
+        bestPhi = childPhi;
+        bestMove = move;
+      }
+      else if (childDelta < delta2) {
+        delta2 = childDelta;
+      }
+    }
+
+    if (phi >= thPhi || delta >= thDelta) {
+      // a disproved node has no better move than any other
+      if (bestMove == MOVE_NONE) bestMove = moves->front();
+      store(position, remaining, phi, delta,
+            static_cast<uint32_t>(std::min<uint64_t>(nodes - startNodes + 1, UINT32_MAX)), bestMove);
+      return;
+    }
+
+    // thresholds for the most proving child
+    const auto childThPhi = static_cast<uint32_t>(
+      std::min<uint64_t>(INF, static_cast<uint64_t>(thDelta) + bestPhi - delta));
+    // 1+epsilon trick - the child may exceed the second best by a
+    // fraction which saves many re-expansions when switching between children
+    const auto childThDelta = static_cast<uint32_t>(
+      std::min<uint64_t>(thPhi, static_cast<uint64_t>(delta2) + delta2 / 4 + 1));
+
+    position.doMove(bestMove);
+    mid(position, remaining - 1, ply + 1, childThPhi, childThDelta);
+    position.undoMove();
+    if (aborted) return;
+  }
+}
+
+void MateSolver::lookup(const Position &position, int remaining, uint32_t &phi, uint32_t &delta) const {
+  lookup(tableKey(position.getZobristKey(), remaining), phi, delta);
+}
+
+bool MateSolver::lookup(Key key, uint32_t &phi, uint32_t &delta) const {
+  const Entry* bucket = &table[(key & bucketMask) * 2];
+  for (int i = 0; i < 2; i++) {
+    if (bucket[i].key == key) {
+      phi = bucket[i].phi;
+      delta = bucket[i].delta;
+      return true;
+    }
+  }
+  phi = 1;
+  delta = 1;
+  return false;
+}
+
+void MateSolver::store(const Position &position, int remaining, uint32_t phi, uint32_t delta, uint32_t work,
+                       Move move) {
+  const Key key = tableKey(position.getZobristKey(), remaining);
+  Entry* bucket = &table[(key & bucketMask) * 2];
+  Entry* replace = &bucket[0];
+  if (bucket[1].key == key || (bucket[0].key != key && bucket[1].work < bucket[0].work)) {
+    replace = &bucket[1];
+  }
+  if (replace->key == key) {
+    work += replace->work;
+  }
+  *replace = {key, phi, delta, work, move};
+}
+
+void MateSolver::extractPV(Position &position, int remaining) {
+  int played = 0;
+  while (remaining > 0) {
+    Move move = MOVE_NONE;
+    if (remaining & 1) {
+      // attacker - the move which proved the node
+      const Key key = tableKey(position.getZobristKey(), remaining);
+      const Entry* bucket = &table[(key & bucketMask) * 2];
+      const Entry* entry = bucket[0].key == key ? &bucket[0] : bucket[1].key == key ? &bucket[1] : nullptr;
+      if (entry && entry->phi == 0) move = entry->move;
+    }
+    else {
+      // defender - the move which delays the mate the longest
+      int longest = 0;
+      const MoveList moves = *moveGenerators[played].generateLegalMoves<MoveGenerator::GENALL>(position);
+      for (Move m : moves) {
+        position.doMove(m);
+        for (int r = 1; r < remaining; r += 2) {
+          mid(position, r, played + 1, INF, INF);
+          uint32_t phi, delta;
+          lookup(position, r, phi, delta);
+          if (phi == 0) {
+            if (r > longest) {
+              longest = r;
+              move = m;
+            }
+            break;
+          }
+        }
+        position.undoMove();
+        if (aborted) break;
+      }
+      remaining = longest + 1;
+    }
+    if (move == MOVE_NONE || aborted) break;
+    pv.push_back(move);
+    position.doMove(move);
+    played++;
+    remaining--;
+  }
+  while (played--) {
+    position.undoMove();
+  }
+}
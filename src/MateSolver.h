@@ -0,0 +1,126 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef FRANKYCPP_MATESOLVER_H
+#define FRANKYCPP_MATESOLVER_H
+
+#include <functional>
+#include <vector>
+#include "types.h"
+#include "MoveGenerator.h"
+
+// forward declared dependencies
+class Position;
+
+/**
+ * Mate solver based on depth-first proof-number search (df-pn).
+ * Searches for a forced mate for the side to move within a given number of
+ * moves. Proof and disproof numbers are kept in a table of bounded size
+ * (buckets of two entries, the entry with less work below it is replaced).
+ * As the number of remaining plies is part of the table key a result is
+ * only reused for the same remaining depth.
+ * Mates are searched for 1..n moves so the first mate found is the shortest.
+ */
+class MateSolver {
+public:
+
+  static constexpr uint64_t MB = 1024 * 1024;
+  static constexpr uint32_t INF = 100'000'000;
+
+  struct Entry {
+    Key key = 0;          // zobrist key mixed with the remaining plies
+    uint32_t phi = 0;     // proof number for the side to move
+    uint32_t delta = 0;   // disproof number for the side to move
+    uint32_t work = 0;    // nodes searched below this entry
+    Move move = MOVE_NONE;// best child
+  };
+
+private:
+
+  std::vector<Entry> table{};
+  std::size_t bucketMask = 0;
+
+  // one move generator per ply so move lists stay valid while recursing
+  std::vector<MoveGenerator> moveGenerators{};
+  struct Child {
+    Key key;    // table key of the position after the move
+    bool check; // attacker move giving check
+  };
+  std::vector<std::vector<Child>> childInfos{};
+
+  std::function<bool()> stopCallback{};
+  bool aborted = false;
+
+  uint64_t nodes = 0;
+  MoveList pv{};
+
+public:
+
+  explicit MateSolver(std::size_t sizeInMB);
+  MateSolver(const MateSolver &) = delete;
+  MateSolver &operator=(const MateSolver &) = delete;
+
+  /** resizes and clears the table */
+  void resize(std::size_t sizeInMB);
+
+  /** clears the table */
+  void clear();
+
+  /**
+   * Searches a mate in at most mateIn moves for the side to move.
+   * The stop callback is called for every node and aborts the search
+   * when it returns true.
+   * @return the mate value of the shortest mate found or VALUE_NONE
+   */
+  Value solve(Position &position, int mateIn, const std::function<bool()> &stop);
+
+  /** the mating line of the last successful solve() */
+  const MoveList &getPV() const { return pv; }
+
+  /** nodes searched in the last solve() */
+  uint64_t getNodes() const { return nodes; }
+
+  /** true if the last solve() was aborted by the stop callback */
+  bool wasAborted() const { return aborted; }
+
+private:
+
+  /** the df-pn multiple iterative deepening search */
+  void mid(Position &position, int remaining, int ply, uint32_t thPhi, uint32_t thDelta);
+
+  /** the proof and disproof number of a child not yet visited */
+  void lookup(const Position &position, int remaining, uint32_t &phi, uint32_t &delta) const;
+  bool lookup(Key key, uint32_t &phi, uint32_t &delta) const;
+
+  void store(const Position &position, int remaining, uint32_t phi, uint32_t delta, uint32_t work, Move move);
+
+  static inline Key tableKey(Key key, int remaining) {
+    return key ^ (static_cast<Key>(remaining + 1) * 0x9E3779B97F4A7C15ULL);
+  }
+
+  void extractPV(Position &position, int remaining);
+};
+
+#endif //FRANKYCPP_MATESOLVER_H
@@ -0,0 +1,157 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <algorithm>
+#include <vector>
+#include "Logging.h"
+#include "Material.h"
+
+namespace Material {
+
+  namespace {
+
+    // imbalance - knights gain and rooks lose value with more pawns on the
+    // board (L. Kaufman)
+    constexpr int KNIGHT_PAWN_ADJUSTMENT = 6;
+    constexpr int ROOK_PAWN_ADJUSTMENT = -12;
+
+    // scale for a side ahead in material without pawns
+    constexpr int SCALE_NO_PAWNS_SMALL_ADVANTAGE = 16;
+
+    /** number of pieces per color and type */
+    using Counts = int[COLOR_LENGTH][PT_LENGTH];
+
+    inline int nonPawnMaterial(const Counts &counts, Color c) {
+      int value = 0;
+      for (PieceType pt = KNIGHT; pt <= QUEEN; ++pt) value += counts[c][pt] * valueOf(pt);
+      return value;
+    }
+
+    inline bool bare(const Counts &counts, Color c) {
+      return counts[c][PAWN] + counts[c][KNIGHT] + counts[c][BISHOP] + counts[c][ROOK] + counts[c][QUEEN] == 0;
+    }
+
+    void computeEntry(Entry &entry, const Counts &counts) {
+      entry = Entry{};
+
+      int gamePhase = 0;
+      for (Color c = WHITE; c <= BLACK; ++c) {
+        for (PieceType pt = KNIGHT; pt <= QUEEN; ++pt) gamePhase += counts[c][pt] * gamePhaseValue[pt];
+      }
+      entry.gamePhaseFactor = float(std::min(GAME_PHASE_MAX, gamePhase)) / GAME_PHASE_MAX;
+
+      for (Color c = WHITE; c <= BLACK; ++c) {
+        const int pawnsAboveFive = counts[c][PAWN] - 5;
+        const int value = pawnsAboveFive * (counts[c][KNIGHT] * KNIGHT_PAWN_ADJUSTMENT
+                                            + counts[c][ROOK] * ROOK_PAWN_ADJUSTMENT);
+        entry.imbalance += (c == WHITE ? 1 : -1) * makeScore(value, value);
+      }
+
+      // draws by insufficient material - only minor pieces on the board
+      const bool onlyMinors = counts[WHITE][PAWN] + counts[BLACK][PAWN]
+                              + counts[WHITE][ROOK] + counts[BLACK][ROOK]
+                              + counts[WHITE][QUEEN] + counts[BLACK][QUEEN] == 0;
+      if (onlyMinors) {
+        for (Color c = WHITE; c <= BLACK; ++c) {
+          if (!bare(counts, ~c)) continue;
+          // KK, KNK, KBK
+          if ((counts[c][KNIGHT] <= 1 && counts[c][BISHOP] == 0)
+              || (counts[c][KNIGHT] == 0 && counts[c][BISHOP] == 1)) {
+            entry.draw = DRAW_ALWAYS;
+          }
+          // KNNK
+          else if (counts[c][KNIGHT] == 2 && counts[c][BISHOP] == 0) {
+            entry.draw = DRAW_NO_FORCED_MATE;
+          }
+        }
+        if (counts[WHITE][KNIGHT] + counts[BLACK][KNIGHT] == 0
+            && counts[WHITE][BISHOP] == 1 && counts[BLACK][BISHOP] == 1) {
+          entry.draw = DRAW_SAME_COLORED_BISHOPS;
+        }
+      }
+
+      // without pawns a side needs more than a minor piece advantage to win
+      for (Color c = WHITE; c <= BLACK; ++c) {
+        if (counts[c][PAWN]) continue;
+        const int material = nonPawnMaterial(counts, c);
+        if (material <= valueOf(BISHOP)) {
+          entry.scale[c] = 0;
+        }
+        else if (material - nonPawnMaterial(counts, ~c) <= valueOf(BISHOP)) {
+          entry.scale[c] = SCALE_NO_PAWNS_SMALL_ADVANTAGE;
+        }
+      }
+
+      // specialised endgames
+      for (Color c = WHITE; c <= BLACK; ++c) {
+        if (!bare(counts, ~c)) continue;
+        if (counts[c][PAWN] == 1 && nonPawnMaterial(counts, c) == 0) {
+          entry.endgame = ENDGAME_KPK;
+          entry.strongSide = c;
+        }
+        else if (counts[c][ROOK] + counts[c][QUEEN] > 0) {
+          entry.endgame = ENDGAME_KXK;
+          entry.strongSide = c;
+        }
+      }
+    }
+
+    inline int colorIndex(const Counts &counts, Color c) {
+      int index = 0;
+      for (PieceType pt = PAWN; pt <= QUEEN; ++pt) index += counts[c][pt] * INDEX_DELTA[makePiece(BLACK, pt)];
+      return index;
+    }
+  }
+
+  void init() {
+    if (!table.empty()) return;
+    table.resize(COLOR_INDEXES * COLOR_INDEXES);
+    Counts counts{};
+    // all combinations of the counts of both colors
+    for (int i = 0; i < COLOR_INDEXES * COLOR_INDEXES; i++) {
+      int index[COLOR_LENGTH] = {i / COLOR_INDEXES, i % COLOR_INDEXES};
+      for (Color c = WHITE; c <= BLACK; ++c) {
+        counts[c][KING] = 1;
+        for (PieceType pt = PAWN; pt <= QUEEN; ++pt) {
+          counts[c][pt] = index[c] % (MAX_COUNT[pt] + 1);
+          index[c] /= MAX_COUNT[pt] + 1;
+        }
+      }
+      assert(colorIndex(counts, WHITE) * COLOR_INDEXES + colorIndex(counts, BLACK) == i);
+      computeEntry(table[i], counts);
+    }
+    LOG__INFO(Logger::get().MAIN_LOG, "Material table with {:n} entries created", table.size());
+  }
+
+  const Entry* compute(const Key materialKey) {
+    Counts counts;
+    for (Color c = WHITE; c <= BLACK; ++c) {
+      for (PieceType pt = KING; pt <= QUEEN; ++pt) counts[c][pt] = count(materialKey, makePiece(c, pt));
+    }
+    thread_local Entry entry;
+    computeEntry(entry, counts);
+    return &entry;
+  }
+}
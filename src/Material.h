@@ -0,0 +1,155 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef FRANKYCPP_MATERIAL_H
+#define FRANKYCPP_MATERIAL_H
+
+#include <array>
+#include <vector>
+#include "types.h"
+
+/**
+ * Material signature key and precomputed material table.
+ *
+ * The material key packs the number of pieces of each piece (color and
+ * type) into 4 bits and is maintained incrementally by Position. All
+ * signatures with up to 8 pawns, 2 knights, 2 bishops, 2 rooks and 1 queen
+ * per side are precomputed in Material::init(). Position also maintains
+ * the index into this table incrementally so a probe is a single lookup.
+ * Other signatures (after promotions) are computed on the fly.
+ */
+namespace Material {
+
+  void init();
+
+  constexpr int KEY_BITS = 4;
+
+  /** change of the material key when a piece is added to the board */
+  constexpr Key keyDelta(Piece pc) { return Key(1) << (KEY_BITS * pc); }
+
+  /** number of pieces of the given piece in the material key */
+  constexpr int count(Key materialKey, Piece pc) {
+    return static_cast<int>((materialKey >> (KEY_BITS * pc)) & ((1 << KEY_BITS) - 1));
+  }
+
+  // counts covered by the precomputed table (radix of the table index)
+  constexpr int MAX_COUNT[PT_LENGTH] = {0, 1, 8, 2, 2, 2, 1};
+  constexpr int COLOR_INDEXES = 9 * 3 * 3 * 3 * 2;
+
+  /**
+   * Change of the table index when a piece is added to the board. The
+   * index is colorIndex(white) * COLOR_INDEXES + colorIndex(black) with
+   * the piece counts as digits of the radix MAX_COUNT + 1 (kings are not
+   * counted).
+   */
+  constexpr std::array<int, PIECE_LENGTH> INDEX_DELTA = [] {
+    std::array<int, PIECE_LENGTH> delta{};
+    for (Color c = WHITE; c <= BLACK; c = Color(c + 1)) {
+      int weight = c == WHITE ? COLOR_INDEXES : 1;
+      for (int pt = PAWN; pt <= QUEEN; pt++) {
+        delta[makePiece(c, PieceType(pt))] = weight;
+        weight *= MAX_COUNT[pt] + 1;
+      }
+    }
+    return delta;
+  }();
+
+  // Adding OVERFLOW_ADD to a material key sets a bit of OVERFLOW_BITS
+  // exactly when a count is above MAX_COUNT. This does not carry into the
+  // next count as no count can be more than 7 above its MAX_COUNT (pawns
+  // can never be more than 8 and are not checked).
+  constexpr Key OVERFLOW_ADD = [] {
+    Key add = 0;
+    for (int pc = 0; pc < PIECE_LENGTH; pc++) {
+      const PieceType pt = typeOf(Piece(pc));
+      if (pt == PIECETYPE_NONE || pt == PAWN || pt >= PT_LENGTH) continue;
+      add += Key(7 - MAX_COUNT[pt]) << (KEY_BITS * pc);
+    }
+    return add;
+  }();
+  constexpr Key OVERFLOW_BITS = [] {
+    Key bits = 0;
+    for (int pc = 0; pc < PIECE_LENGTH; pc++) {
+      const PieceType pt = typeOf(Piece(pc));
+      if (pt == PIECETYPE_NONE || pt == PAWN || pt >= PT_LENGTH) continue;
+      bits |= Key(8) << (KEY_BITS * pc);
+    }
+    return bits;
+  }();
+
+  /** true if the material key is covered by the precomputed table */
+  constexpr bool inTable(Key materialKey) {
+    return ((materialKey + OVERFLOW_ADD) & OVERFLOW_BITS) == 0;
+  }
+
+  /** endgames which have a specialised evaluation */
+  enum Endgame : uint8_t {
+    ENDGAME_NONE,
+    ENDGAME_KPK, // king and pawn vs. king - KPK bitbase
+    ENDGAME_KXK  // king and at least a rook or queen vs. bare king
+  };
+
+  /** material which can't win */
+  enum Draw : uint8_t {
+    DRAW_NONE,
+    DRAW_ALWAYS,                // KK, KNK, KBK - no mate possible
+    DRAW_SAME_COLORED_BISHOPS,  // KBKB - no mate possible if bishops are on same colored squares
+    DRAW_NO_FORCED_MATE         // KNNK - mates exist but can't be forced (evaluation only)
+  };
+
+  /** eval scale factor for a normal position */
+  constexpr int SCALE_NORMAL = 64;
+
+  struct Entry {
+    // imbalance adjustments of the piece values from white's view
+    Score imbalance = SCORE_ZERO;
+    // game phase as in Position::getGamePhaseFactor()
+    float gamePhaseFactor = 0.0f;
+    // the eval is scaled by scale[c] / SCALE_NORMAL when c is ahead
+    uint8_t scale[COLOR_LENGTH]{SCALE_NORMAL, SCALE_NORMAL};
+    Draw draw = DRAW_NONE;
+    Endgame endgame = ENDGAME_NONE;
+    // side with the material advantage for endgames
+    Color strongSide = WHITE;
+  };
+
+  // precomputed entries - inline for speed of probe()
+  inline std::vector<Entry> table{};
+
+  /** Computes the entry for material not in the table (thread local) */
+  const Entry* compute(Key materialKey);
+
+  /**
+   * Returns the entry for the material signature.
+   * @param materialIndex sum of INDEX_DELTA of all pieces on the board
+   */
+  inline const Entry* probe(const Key materialKey, const int materialIndex) {
+    if (inTable(materialKey)) return &table[materialIndex];
+    // rare material after promotions
+    return compute(materialKey);
+  }
+}
+
+#endif //FRANKYCPP_MATERIAL_H
@@ -0,0 +1,419 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <vector>
+#include "Logging.h"
+#include "NNUE.h"
+#include "Bitboards.h"
+#include "Position.h"
+
+// SIMD kernels are compiled with function target attributes and selected at
+// runtime so the engine does not need to be built for a specific CPU
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NNUE_X86
+#include <immintrin.h>
+#endif
+
+namespace NNUE {
+
+  namespace {
+
+    /** file format header - all values are stored little endian */
+    constexpr char MAGIC[4] = {'F', 'K', 'N', 'N'};
+    constexpr uint32_t VERSION = 1;
+
+    struct Network {
+      std::vector<int16_t> ftBias = std::vector<int16_t>(HALF);
+      std::vector<int16_t> ftWeights = std::vector<int16_t>(static_cast<std::size_t>(INPUTS) * HALF);
+      alignas(32) int32_t l1Bias[L1]{};
+      alignas(32) int8_t l1Weights[L1][2 * HALF]{};
+      alignas(32) int32_t l2Bias[L2]{};
+      alignas(32) int8_t l2Weights[L2][L1]{};
+      int32_t outBias = 0;
+      alignas(32) int8_t outWeights[L2]{};
+    };
+
+    std::unique_ptr<Network> network;
+
+    Simd detectSimd() {
+#ifdef NNUE_X86
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2")) return AVX2;
+      if (__builtin_cpu_supports("sse4.1")) return SSE41;
+#endif
+      return SCALAR;
+    }
+
+    const Simd maxSimd = detectSimd();
+    Simd simd = maxSimd;
+
+    // ###############################################
+    // SCALAR kernels
+
+    void addScalar(int16_t* acc, const int16_t* w) {
+      for (int i = 0; i < HALF; i++) acc[i] += w[i];
+    }
+
+    void subScalar(int16_t* acc, const int16_t* w) {
+      for (int i = 0; i < HALF; i++) acc[i] -= w[i];
+    }
+
+    void clipScalar(const int16_t* in, uint8_t* out) {
+      for (int i = 0; i < HALF; i++) {
+        out[i] = static_cast<uint8_t>(std::clamp<int>(in[i], 0, ACTIVATION_MAX));
+      }
+    }
+
+    int32_t dotScalar(const uint8_t* in, const int8_t* w, int n) {
+      int32_t sum = 0;
+      for (int i = 0; i < n; i++) sum += in[i] * w[i];
+      return sum;
+    }
+
+#ifdef NNUE_X86
+    // ###############################################
+    // SSE4.1 kernels (128 bit)
+
+    __attribute__((target("sse4.1")))
+    void addSSE(int16_t* acc, const int16_t* w) {
+      for (int i = 0; i < HALF; i += 8) {
+        const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(acc + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i));
+        _mm_store_si128(reinterpret_cast<__m128i*>(acc + i), _mm_add_epi16(a, b));
+      }
+    }
+
+    __attribute__((target("sse4.1")))
+    void subSSE(int16_t* acc, const int16_t* w) {
+      for (int i = 0; i < HALF; i += 8) {
+        const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(acc + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i));
+        _mm_store_si128(reinterpret_cast<__m128i*>(acc + i), _mm_sub_epi16(a, b));
+      }
+    }
+
+    __attribute__((target("sse4.1")))
+    void clipSSE(const int16_t* in, uint8_t* out) {
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i max = _mm_set1_epi16(ACTIVATION_MAX);
+      for (int i = 0; i < HALF; i += 16) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(in + i + 8));
+        a = _mm_min_epi16(_mm_max_epi16(a, zero), max);
+        b = _mm_min_epi16(_mm_max_epi16(b, zero), max);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(a, b));
+      }
+    }
+
+    __attribute__((target("sse4.1")))
+    int32_t dotSSE(const uint8_t* in, const int8_t* w, int n) {
+      const __m128i ones = _mm_set1_epi16(1);
+      __m128i sum = _mm_setzero_si128();
+      for (int i = 0; i < n; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i));
+        // u8 * i8 pairs to i16 - can't saturate as activations are <= 127
+        const __m128i product = _mm_maddubs_epi16(a, b);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(product, ones));
+      }
+      sum = _mm_hadd_epi32(sum, sum);
+      sum = _mm_hadd_epi32(sum, sum);
+      return _mm_cvtsi128_si32(sum);
+    }
+
+    // ###############################################
+    // AVX2 kernels (256 bit)
+
+    __attribute__((target("avx2")))
+    void addAVX2(int16_t* acc, const int16_t* w) {
+      for (int i = 0; i < HALF; i += 16) {
+        const __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_add_epi16(a, b));
+      }
+    }
+
+    __attribute__((target("avx2")))
+    void subAVX2(int16_t* acc, const int16_t* w) {
+      for (int i = 0; i < HALF; i += 16) {
+        const __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_sub_epi16(a, b));
+      }
+    }
+
+    __attribute__((target("avx2")))
+    int32_t dotAVX2(const uint8_t* in, const int8_t* w, int n) {
+      const __m256i ones = _mm256_set1_epi16(1);
+      __m256i sum = _mm256_setzero_si256();
+      for (int i = 0; i < n; i += 32) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+        const __m256i product = _mm256_maddubs_epi16(a, b);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(product, ones));
+      }
+      __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+      sum128 = _mm_hadd_epi32(sum128, sum128);
+      sum128 = _mm_hadd_epi32(sum128, sum128);
+      return _mm_cvtsi128_si32(sum128);
+    }
+#endif
+
+    // ###############################################
+    // dispatch
+
+    inline void addWeights(int16_t* acc, const int16_t* w) {
+#ifdef NNUE_X86
+      if (simd == AVX2) return addAVX2(acc, w);
+      if (simd == SSE41) return addSSE(acc, w);
+#endif
+      addScalar(acc, w);
+    }
+
+    inline void subWeights(int16_t* acc, const int16_t* w) {
+#ifdef NNUE_X86
+      if (simd == AVX2) return subAVX2(acc, w);
+      if (simd == SSE41) return subSSE(acc, w);
+#endif
+      subScalar(acc, w);
+    }
+
+    inline void clip(const int16_t* in, uint8_t* out) {
+#ifdef NNUE_X86
+      if (simd != SCALAR) return clipSSE(in, out);
+#endif
+      clipScalar(in, out);
+    }
+
+    inline int32_t dot(const uint8_t* in, const int8_t* w, int n) {
+#ifdef NNUE_X86
+      if (simd == AVX2) return dotAVX2(in, w, n);
+      if (simd == SSE41) return dotSSE(in, w, n);
+#endif
+      return dotScalar(in, w, n);
+    }
+
+    inline const int16_t* featureWeights(int index) {
+      return &network->ftWeights[static_cast<std::size_t>(index) * HALF];
+    }
+
+    /** one layer of n inputs to N outputs with clipped ReLU activation */
+    template<int N>
+    inline void layer(const uint8_t* in, int n, const int8_t* weights, const int32_t* bias, uint8_t* out) {
+      for (int i = 0; i < N; i++) {
+        const int32_t sum = bias[i] + dot(in, weights + i * n, n);
+        out[i] = static_cast<uint8_t>(std::clamp(sum >> WEIGHT_SHIFT, 0, ACTIVATION_MAX));
+      }
+    }
+
+    template<typename T>
+    bool read(std::istream &in, T* data, std::size_t n) {
+      return static_cast<bool>(in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(n * sizeof(T))));
+    }
+
+    template<typename T>
+    void write(std::ostream &out, const T* data, std::size_t n) {
+      out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(n * sizeof(T)));
+    }
+  }
+
+  bool load(const std::string &fileName) {
+    std::ifstream in(fileName, std::ios::binary);
+    if (!in) {
+      LOG__ERROR(Logger::get().EVAL_LOG, "NNUE: could not open network file {}", fileName);
+      return false;
+    }
+    char magic[4];
+    uint32_t header[5];
+    if (!read(in, magic, 4) || std::memcmp(magic, MAGIC, 4) != 0 || !read(in, header, 5)
+        || header[0] != VERSION || header[1] != INPUTS || header[2] != HALF
+        || header[3] != L1 || header[4] != L2) {
+      LOG__ERROR(Logger::get().EVAL_LOG, "NNUE: {} is not a compatible network file", fileName);
+      return false;
+    }
+    auto net = std::make_unique<Network>();
+    if (!read(in, net->ftBias.data(), net->ftBias.size())
+        || !read(in, net->ftWeights.data(), net->ftWeights.size())
+        || !read(in, net->l1Bias, L1)
+        || !read(in, &net->l1Weights[0][0], L1 * 2 * HALF)
+        || !read(in, net->l2Bias, L2)
+        || !read(in, &net->l2Weights[0][0], L2 * L1)
+        || !read(in, &net->outBias, 1)
+        || !read(in, net->outWeights, L2)) {
+      LOG__ERROR(Logger::get().EVAL_LOG, "NNUE: network file {} is truncated", fileName);
+      return false;
+    }
+    network = std::move(net);
+    LOG__INFO(Logger::get().EVAL_LOG, "NNUE: network {} loaded (SIMD {})", fileName, simdName(simd));
+    return setEnabled(true);
+  }
+
+  bool save(const std::string &fileName) {
+    if (!network) return false;
+    std::ofstream out(fileName, std::ios::binary);
+    if (!out) return false;
+    const uint32_t header[5] = {VERSION, INPUTS, HALF, L1, L2};
+    write(out, MAGIC, 4);
+    write(out, header, 5);
+    write(out, network->ftBias.data(), network->ftBias.size());
+    write(out, network->ftWeights.data(), network->ftWeights.size());
+    write(out, network->l1Bias, L1);
+    write(out, &network->l1Weights[0][0], L1 * 2 * HALF);
+    write(out, network->l2Bias, L2);
+    write(out, &network->l2Weights[0][0], L2 * L1);
+    write(out, &network->outBias, 1);
+    write(out, network->outWeights, L2);
+    return static_cast<bool>(out);
+  }
+
+  void initRandom(uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    auto random = [&rng](int min, int max) {
+      return std::uniform_int_distribution<int>(min, max)(rng);
+    };
+    auto net = std::make_unique<Network>();
+    // ranges are chosen to keep most activations between 0 and 127
+    for (auto &b : net->ftBias) b = static_cast<int16_t>(random(0, 64));
+    for (auto &w : net->ftWeights) w = static_cast<int16_t>(random(-16, 16));
+    for (auto &b : net->l1Bias) b = random(-64, 64) << WEIGHT_SHIFT;
+    for (auto &row : net->l1Weights) for (auto &w : row) w = static_cast<int8_t>(random(-8, 8));
+    for (auto &b : net->l2Bias) b = random(-64, 64) << WEIGHT_SHIFT;
+    for (auto &row : net->l2Weights) for (auto &w : row) w = static_cast<int8_t>(random(-16, 16));
+    net->outBias = 0;
+    for (auto &w : net->outWeights) w = static_cast<int8_t>(random(-64, 64));
+    network = std::move(net);
+    setEnabled(true);
+  }
+
+  bool isLoaded() {
+    return network != nullptr;
+  }
+
+  bool setEnabled(bool enable) {
+    if (enable && !network) {
+      LOG__WARN(Logger::get().EVAL_LOG, "NNUE: no network loaded - using classic evaluation");
+      enabled = false;
+      return false;
+    }
+    // accumulators have not been updated while disabled or are from another
+    // network
+    generation++;
+    enabled = enable;
+    return true;
+  }
+
+  Simd getMaxSimd() {
+    return maxSimd;
+  }
+
+  void setSimd(Simd s) {
+    simd = std::min(s, maxSimd);
+  }
+
+  Simd getSimd() {
+    return simd;
+  }
+
+  std::string simdName(Simd s) {
+    switch (s) {
+      case AVX2:
+        return "AVX2";
+      case SSE41:
+        return "SSE4.1";
+      case SCALAR:
+        break;
+    }
+    return "scalar";
+  }
+
+  void refresh(Accumulator &acc, const Position &position, Color perspective) {
+    int16_t* const values = acc.values[perspective];
+    std::copy(network->ftBias.begin(), network->ftBias.end(), values);
+    const Square kingSq = position.getKingSquare(perspective);
+    Bitboard pieces = position.getOccupiedBB()
+                      & ~(position.getPieceBB(WHITE, KING) | position.getPieceBB(BLACK, KING));
+    while (pieces) {
+      const Square sq = Bitboards::popLSB(pieces);
+      addWeights(values, featureWeights(featureIndex(perspective, kingSq, position.getPiece(sq), sq)));
+    }
+    acc.computed[perspective] = true;
+  }
+
+  void addPiece(Accumulator &acc, const Position &position, Piece pc, Square sq) {
+    if (acc.generation != generation) return;
+    for (Color p = WHITE; p <= BLACK; ++p) {
+      if (!acc.computed[p]) continue;
+      if (typeOf(pc) == KING) {
+        // all features of this perspective change with its king square
+        if (colorOf(pc) == p) acc.computed[p] = false;
+        continue;
+      }
+      addWeights(acc.values[p], featureWeights(featureIndex(p, position.getKingSquare(p), pc, sq)));
+    }
+  }
+
+  void removePiece(Accumulator &acc, const Position &position, Piece pc, Square sq) {
+    if (acc.generation != generation) return;
+    for (Color p = WHITE; p <= BLACK; ++p) {
+      if (!acc.computed[p]) continue;
+      if (typeOf(pc) == KING) {
+        if (colorOf(pc) == p) acc.computed[p] = false;
+        continue;
+      }
+      subWeights(acc.values[p], featureWeights(featureIndex(p, position.getKingSquare(p), pc, sq)));
+    }
+  }
+
+  Value evaluate(const Position &position) {
+    assert(network);
+    Accumulator &acc = position.getAccumulator();
+    if (acc.generation != generation) {
+      acc.generation = generation;
+      acc.computed[WHITE] = acc.computed[BLACK] = false;
+    }
+    if (!acc.computed[WHITE]) refresh(acc, position, WHITE);
+    if (!acc.computed[BLACK]) refresh(acc, position, BLACK);
+
+    // side to move first
+    const Color stm = position.getNextPlayer();
+    alignas(32) uint8_t input[2 * HALF];
+    clip(acc.values[stm], input);
+    clip(acc.values[~stm], input + HALF);
+
+    alignas(32) uint8_t l1Out[L1];
+    layer<L1>(input, 2 * HALF, &network->l1Weights[0][0], network->l1Bias, l1Out);
+    alignas(32) uint8_t l2Out[L2];
+    layer<L2>(l1Out, L1, &network->l2Weights[0][0], network->l2Bias, l2Out);
+    const int32_t output = network->outBias + dot(l2Out, network->outWeights, L2);
+
+    const int limit = VALUE_CHECKMATE_THRESHOLD - 1;
+    return static_cast<Value>(std::clamp(output / OUTPUT_SCALE, -limit, limit));
+  }
+}
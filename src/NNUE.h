@@ -0,0 +1,134 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef FRANKYCPP_NNUE_H
+#define FRANKYCPP_NNUE_H
+
+#include <string>
+#include "types.h"
+
+// forward declared dependencies
+class Position;
+
+/**
+ * Efficiently updatable neural network evaluation (HalfKP).
+ *
+ * Input features are (king square, piece, square) triples seen from each
+ * side's perspective (kings themselves are not features). The first layer
+ * sums the weights of all active features into an accumulator per
+ * perspective which is kept up to date by Position::putPiece/removePiece
+ * when a network is enabled. A king move invalidates the accumulator of its
+ * side which is then recomputed on the next evaluation.
+ *
+ * Network: 2x(40960 -> HALF) -> 32 -> 32 -> 1 with int16 first layer
+ * weights, int8 weights for the other layers and clipped ReLU activations.
+ * Inference uses AVX2 or SSE4.1 kernels when the CPU supports them
+ * (detected at runtime) and a scalar implementation otherwise.
+ */
+namespace NNUE {
+
+  constexpr int KING_SQUARES = 64;
+  constexpr int PIECE_KINDS = 10; // pawn to queen for both colors
+  constexpr int INPUTS = KING_SQUARES * PIECE_KINDS * SQ_LENGTH; // 40960
+  constexpr int HALF = 128; // accumulator size per perspective
+  constexpr int L1 = 32;
+  constexpr int L2 = 32;
+
+  /** activations are clipped to 0..ACTIVATION_MAX (weights are scaled by 2^WEIGHT_SHIFT) */
+  constexpr int ACTIVATION_MAX = 127;
+  constexpr int WEIGHT_SHIFT = 6;
+  /** the output is divided by this to get centi pawns */
+  constexpr int OUTPUT_SCALE = 16;
+
+  /** first layer accumulator for both perspectives */
+  struct Accumulator {
+    alignas(32) int16_t values[COLOR_LENGTH][HALF]{};
+    bool computed[COLOR_LENGTH]{false, false};
+    // accumulators of other networks or from before the network has been
+    // enabled are not valid
+    uint32_t generation = 0;
+  };
+
+  enum Simd : int {
+    SCALAR, SSE41, AVX2
+  };
+
+  /**
+   * Loads a network from the given file and enables it.
+   * @return false if the file could not be read or has the wrong format -
+   *         the currently loaded network stays unchanged
+   */
+  bool load(const std::string &fileName);
+
+  /** Writes the current network to the given file */
+  bool save(const std::string &fileName);
+
+  /** Fills the network with deterministic random weights (for tests and benchmarks) and enables it. */
+  void initRandom(uint64_t seed);
+
+  // state which is checked for every piece move - inline for speed
+  inline bool enabled = false;
+  inline uint32_t generation = 1;
+
+  /** true if a network is loaded */
+  bool isLoaded();
+
+  /** true if a network is loaded and should be used instead of the classic evaluation */
+  inline bool isEnabled() { return enabled; }
+
+  /** Enables or disables the network evaluation. Only possible when a network is loaded. */
+  bool setEnabled(bool enable);
+
+  /** best SIMD level supported by the CPU */
+  Simd getMaxSimd();
+
+  /** selects the SIMD level - limited to the level the CPU supports */
+  void setSimd(Simd simd);
+  Simd getSimd();
+  std::string simdName(Simd simd);
+
+  /** HalfKP feature index for a piece on a square from the perspective of color p */
+  inline int featureIndex(Color p, Square kingSq, Piece pc, Square sq) {
+    // black sees the board from its side - flip ranks
+    if (p == BLACK) {
+      kingSq = Square(kingSq ^ 56);
+      sq = Square(sq ^ 56);
+    }
+    const int kind = (typeOf(pc) - PAWN) * 2 + (colorOf(pc) != p);
+    return (kingSq * PIECE_KINDS + kind) * SQ_LENGTH + sq;
+  }
+
+  /** Recomputes the accumulator of the perspective from all pieces of the position */
+  void refresh(Accumulator &acc, const Position &position, Color perspective);
+
+  /** Incremental updates called when a piece is put on or removed from a square */
+  void addPiece(Accumulator &acc, const Position &position, Piece pc, Square sq);
+  void removePiece(Accumulator &acc, const Position &position, Piece pc, Square sq);
+
+  /** Evaluates the position from the view of the side to move */
+  Value evaluate(const Position &position);
+}
+
+#endif //FRANKYCPP_NNUE_H
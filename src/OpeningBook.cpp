@@ -24,11 +24,11 @@
  */
 
 #include <algorithm>
+#include <cstring>
 #include <chrono>
 #include <iostream>
 #include <fstream>
 #include <mutex>
-#include <regex>
 #include <thread>
 #include <random>
 #include "OpeningBook.h"
@@ -39,8 +39,12 @@
 #include "ThreadPool.h"
 #include "Position.h"
 #include "PGN_Reader.h"
+#include "MoveGenerator.h"
+#include "Tokenizer.h"
 
 #include <boost/thread/thread_functors.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 #define PARALLEL_LINE_PROCESSING
 #define PARALLEL_GAME_PROCESSING
@@ -54,16 +58,94 @@
 #include <filesystem>
 #endif
 
+struct OpeningBook::BinaryBook {
+  boost::interprocess::file_mapping mapping;
+  boost::interprocess::mapped_region region;
+  const BinaryEntry* entries = nullptr;
+  const BinaryMove* moves = nullptr;
+  // set instead of entries and moves for polyglot books
+  const PolyglotEntry* polyglotEntries = nullptr;
+  uint64_t entryCount = 0;
+
+  explicit BinaryBook(const std::string &filePath)
+    : mapping(filePath.c_str(), boost::interprocess::read_only),
+      region(mapping, boost::interprocess::read_only) {}
+};
+
+/** polyglot books store all values big endian */
+template<typename T>
+static inline T fromBigEndian(const T value) {
+  const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+  uint64_t result = 0;
+  for (std::size_t i = 0; i < sizeof(T); i++) result = result << 8 | bytes[i];
+  return static_cast<T>(result);
+}
+
+/** size and last write time of a file to recognize a changed source book */
+static void fileIdentity(const std::string &filePath, uint64_t &size, int64_t &time) {
+  size = 0;
+  time = 0;
+#ifdef HAS_FILESYSTEM_LIB
+  std::error_code ec;
+  const auto fileSize = std::filesystem::file_size(filePath, ec);
+  if (ec) return;
+  const auto writeTime = std::filesystem::last_write_time(filePath, ec);
+  if (ec) return;
+  size = fileSize;
+  time = static_cast<int64_t>(writeTime.time_since_epoch().count());
+#endif
+}
+
 OpeningBook::OpeningBook(const std::string &bookPath, const BookFormat &bFormat)
   : bookFilePath(bookPath), bookFormat(bFormat) {
 }
 
+OpeningBook::~OpeningBook() = default;
+
 void OpeningBook::initialize() {
   if (isInitialized) return;
   LOG__INFO(Logger::get().BOOK_LOG, "Opening book initialization.");
 
   const auto start = std::chrono::high_resolution_clock::now();
 
+  // polyglot books are used directly from the file
+  if (bookFormat == BookFormat::POLYGLOT) {
+    if (readPolyglotBook(bookFilePath)) {
+      const auto stop = std::chrono::high_resolution_clock::now();
+      const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
+      LOG__INFO(Logger::get().BOOK_LOG, "Polyglot opening book mapped in ({:n} us). {:n} entries", elapsed.count(), size());
+    }
+    isInitialized = true;
+    return;
+  }
+
+  // compiled books are only mapped into memory - a compiled version of
+  // a source book is only used if it has been compiled from this source
+  bool binaryRead = false;
+  if (bookFormat == BookFormat::BINARY) {
+    binaryRead = readBinaryBook(bookFilePath);
+  }
+  else {
+#ifdef HAS_FILESYSTEM_LIB
+    std::error_code ec;
+    if (std::filesystem::exists(bookFilePath + ".bin", ec)) {
+      binaryRead = readBinaryBook(bookFilePath + ".bin", bookFilePath);
+    }
+#endif
+  }
+  if (binaryRead) {
+    const auto stop = std::chrono::high_resolution_clock::now();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
+    LOG__INFO(Logger::get().BOOK_LOG, "Binary opening book mapped in ({:n} us). {:n} positions", elapsed.count(), size());
+    isInitialized = true;
+    return;
+  }
+  if (bookFormat == BookFormat::BINARY) {
+    // an invalid binary book leaves the book empty
+    isInitialized = true;
+    return;
+  }
+
   // set root entry
   Position position;
   bookMap.emplace(position.getZobristKey(),
@@ -78,6 +160,111 @@ void OpeningBook::initialize() {
   isInitialized = true;
 }
 
+bool OpeningBook::readBinaryBook(const std::string &filePath, const std::string &sourcePath) {
+  try {
+    auto book = std::make_unique<BinaryBook>(filePath);
+    const auto* data = static_cast<const char*>(book->region.get_address());
+    const std::size_t fileBytes = book->region.get_size();
+    const BinaryHeader expected{};
+    BinaryHeader header;
+    if (fileBytes < sizeof(header)) {
+      LOG__ERROR(Logger::get().BOOK_LOG, "Binary book '{}' is too short.", filePath);
+      return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0
+        || header.version != expected.version
+        || fileBytes != sizeof(header) + header.entries * sizeof(BinaryEntry) + header.moves * sizeof(BinaryMove)) {
+      LOG__ERROR(Logger::get().BOOK_LOG, "Binary book '{}' has a wrong format.", filePath);
+      return false;
+    }
+    if (header.startKey != Position().getZobristKey()) {
+      LOG__WARN(Logger::get().BOOK_LOG, "Binary book '{}' has been compiled with different zobrist keys.", filePath);
+      return false;
+    }
+    if (!sourcePath.empty()) {
+      uint64_t sourceSize;
+      int64_t sourceTime;
+      fileIdentity(sourcePath, sourceSize, sourceTime);
+      if (sourceSize == 0 || header.sourceSize != sourceSize || header.sourceTime != sourceTime) {
+        LOG__WARN(Logger::get().BOOK_LOG, "Binary book '{}' has not been compiled from the current '{}'.", filePath, sourcePath);
+        return false;
+      }
+    }
+    book->entries = reinterpret_cast<const BinaryEntry*>(data + sizeof(header));
+    book->moves = reinterpret_cast<const BinaryMove*>(data + sizeof(header) + header.entries * sizeof(BinaryEntry));
+    book->entryCount = header.entries;
+    pBinaryBook = std::move(book);
+    LOG__DEBUG(Logger::get().BOOK_LOG, "Binary book '{}' with {:n} kB mapped.", filePath, fileBytes / 1024);
+    return true;
+  }
+  catch (const boost::interprocess::interprocess_exception &e) {
+    LOG__ERROR(Logger::get().BOOK_LOG, "Open binary book '{}' failed: {}", filePath, e.what());
+    return false;
+  }
+}
+
+bool OpeningBook::readPolyglotBook(const std::string &filePath) {
+  try {
+    auto book = std::make_unique<BinaryBook>(filePath);
+    const std::size_t fileBytes = book->region.get_size();
+    if (fileBytes == 0 || fileBytes % sizeof(PolyglotEntry) != 0) {
+      LOG__ERROR(Logger::get().BOOK_LOG, "Polyglot book '{}' has a wrong format.", filePath);
+      return false;
+    }
+    book->polyglotEntries = static_cast<const PolyglotEntry*>(book->region.get_address());
+    book->entryCount = fileBytes / sizeof(PolyglotEntry);
+    pBinaryBook = std::move(book);
+    LOG__DEBUG(Logger::get().BOOK_LOG, "Polyglot book '{}' with {:n} kB mapped.", filePath, fileBytes / 1024);
+    return true;
+  }
+  catch (const boost::interprocess::interprocess_exception &e) {
+    LOG__ERROR(Logger::get().BOOK_LOG, "Open polyglot book '{}' failed: {}", filePath, e.what());
+    return false;
+  }
+}
+
+bool OpeningBook::saveBinary(const std::string &filePath) const {
+  std::vector<const BookEntry*> sorted;
+  BinaryHeader header;
+  fileIdentity(bookFilePath, header.sourceSize, header.sourceTime);
+  header.startKey = Position().getZobristKey();
+  for (const auto &[key, entry] : bookMap) {
+    if (entry.moves.empty()) continue;
+    sorted.push_back(&entry);
+    header.moves += entry.moves.size();
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const BookEntry* a, const BookEntry* b) { return a->key < b->key; });
+  header.entries = sorted.size();
+
+  std::vector<BinaryEntry> entries;
+  std::vector<BinaryMove> moves;
+  entries.reserve(header.entries);
+  moves.reserve(header.moves);
+  for (const BookEntry* entry : sorted) {
+    entries.push_back({entry->key, static_cast<uint32_t>(moves.size()), static_cast<uint32_t>(entry->moves.size())});
+    for (std::size_t i = 0; i < entry->moves.size(); i++) {
+      moves.push_back({entry->moves[i], static_cast<uint32_t>(entry->moveCounter[i])});
+    }
+  }
+
+  std::ofstream out(filePath, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    LOG__ERROR(Logger::get().BOOK_LOG, "Could not write binary book '{}'.", filePath);
+    return false;
+  }
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(BinaryEntry));
+  out.write(reinterpret_cast<const char*>(moves.data()), moves.size() * sizeof(BinaryMove));
+  LOG__INFO(Logger::get().BOOK_LOG, "Binary book '{}' written with {:n} positions and {:n} moves.",
+            filePath, header.entries, header.moves);
+  return out.good();
+}
+
+uint64_t OpeningBook::size() const {
+  return pBinaryBook ? pBinaryBook->entryCount : bookMap.size();
+}
+
 void OpeningBook::readBookFromFile(const std::string &filePath) {
 
   // get file size
@@ -90,24 +277,36 @@ void OpeningBook::readBookFromFile(const std::string &filePath) {
 #endif
 
   std::ifstream file(filePath);
-  if (file.is_open()) {
-    LOG__DEBUG(Logger::get().BOOK_LOG, "Open book '{}' with {:n} kB successful.", filePath, fileSize / 1024);
-    std::vector<std::string> lines = getLinesFromFile(file);
-    file.close();
-    processAllLines(lines);
-  }
-  else {
+  if (!file.is_open()) {
     LOG__ERROR(Logger::get().BOOK_LOG, "Open book '{}' failed.", filePath);
     return;
   }
-}
-
-void OpeningBook::processAllLines(std::vector<std::string> &lines) {
-  LOG__DEBUG(Logger::get().BOOK_LOG, "Processing file.");
+  LOG__DEBUG(Logger::get().BOOK_LOG, "Open book '{}' with {:n} kB successful.", filePath, fileSize / 1024);
 
   const auto start = std::chrono::high_resolution_clock::now();
   LOG__DEBUG(Logger::get().BOOK_LOG, "Creating internal book...");
 
+  // the file is streamed so only a chunk of lines or games is in memory at a time
+  if (bookFormat == BookFormat::PGN) {
+#ifdef FIFO_PROCESSING
+    processPGNFileFifo(file);
+#else
+    processPGNFile(file);
+#endif
+  }
+  else {
+    std::vector<std::string> lines;
+    while (getLinesFromFile(file, lines)) processAllLines(lines);
+  }
+
+  const auto stop = std::chrono::high_resolution_clock::now();
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+  LOG__DEBUG(Logger::get().BOOK_LOG, "Internal book created {:n} positions in {:n} ms.", bookMap.size(), elapsed.count());
+}
+
+void OpeningBook::processAllLines(std::vector<std::string> &lines) {
+  LOG__TRACE(Logger::get().BOOK_LOG, "Processing {:n} lines.", lines.size());
+
   switch (bookFormat) {
     case BookFormat::SIMPLE:
     case BookFormat::SAN: {
@@ -142,134 +341,109 @@ void OpeningBook::processAllLines(std::vector<std::string> &lines) {
       break;
     }
     case BookFormat::PGN:
-#ifdef FIFO_PROCESSING
-      processPGNFileFifo(lines);
-#else
-      processPGNFile(lines);
-#endif
+      // pgn books are streamed game by game
+    case BookFormat::BINARY:
+    case BookFormat::POLYGLOT:
+      // binary books are not read line by line
       break;
   }
-
-  const auto stop = std::chrono::high_resolution_clock::now();
-  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
-  LOG__DEBUG(Logger::get().BOOK_LOG, "Internal book created {:n} positions in {:n} ms.", bookMap.size(), elapsed.count());
 }
 
-std::vector<std::string> OpeningBook::getLinesFromFile(std::ifstream &ifstream) {
-  LOG__DEBUG(Logger::get().BOOK_LOG, "Reading lines from book.");
-  const auto start = std::chrono::high_resolution_clock::now();
-  std::vector<std::string> lines;
-  lines.reserve(fileSize / 40);
+bool OpeningBook::getLinesFromFile(std::ifstream &ifstream, std::vector<std::string> &lines) {
+  LOG__TRACE(Logger::get().BOOK_LOG, "Reading lines from book.");
+  lines.clear();
+  lines.reserve(LINES_PER_CHUNK);
   std::string line;
-  while (std::getline(ifstream, line)) {
+  while (lines.size() < LINES_PER_CHUNK && std::getline(ifstream, line)) {
     if (!line.empty()) lines.push_back(line);
   }
-  const auto stop = std::chrono::high_resolution_clock::now();
-  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
-  LOG__DEBUG(Logger::get().BOOK_LOG, "Read {:n} lines in {:n} ms.", lines.size(), elapsed.count());
-  return lines;
+  LOG__TRACE(Logger::get().BOOK_LOG, "Read {:n} lines.", lines.size());
+  return !lines.empty();
 }
 
 void OpeningBook::processLine(std::string &line) {
   LOG__TRACE(Logger::get().BOOK_LOG, "Processing line: {}", line);
 
   // clean up line
-  const std::regex whiteSpaceTrim(R"(^\s*(.*)\s*$)");
-  line = std::regex_replace(line, whiteSpaceTrim, "$1");
+  const std::string_view trimmed = Tokenizer::trim(line);
 
   switch (bookFormat) {
     case BookFormat::SIMPLE:
-      processSimpleLine(line);
+      processSimpleLine(trimmed);
       break;
     case BookFormat::SAN:
-      processSANLine(line);
+      processSANLine(trimmed);
       break;
     case BookFormat::PGN:
       LOG__ERROR(Logger::get().BOOK_LOG, "PNG format can't be processed by line");
       break;
+    case BookFormat::BINARY:
+    case BookFormat::POLYGLOT:
+      LOG__ERROR(Logger::get().BOOK_LOG, "Binary format can't be processed by line");
+      break;
   }
 }
 
-void OpeningBook::processSimpleLine(std::string &line) {
-  std::smatch matcher;
+void OpeningBook::processSimpleLine(std::string_view line) {
 
   // check if line starts with move
-  const std::regex startPattern(R"(^[a-h][1-8][a-h][1-8].*$)");
-  if (!std::regex_match(line, matcher, startPattern)) {
+  if (!Tokenizer::isUCIMoveAt(line, 0)) {
     LOG__TRACE(Logger::get().BOOK_LOG, "Line ignored: {}", line);
     return;
   }
 
-  // iterate over all found pattern matches (aka moves)
-  const std::regex movePattern(R"([a-h][1-8][a-h][1-8])");
-  auto move_begin = std::sregex_iterator(line.begin(), line.end(), movePattern);
-  auto move_end = std::sregex_iterator();
-  LOG__TRACE(Logger::get().BOOK_LOG, "Found {} moves in line: {}", std::distance(move_begin, move_end), line);
-
+  // iterate over all moves - moves are not necessarily separated
   Position currentPosition; // start position
-  for (auto i = move_begin; i != move_end; ++i) {
-    const std::string &moveStr = (*i).str();
+  bool valid = true;
+  Tokenizer::forEachUCIMove(line, [&](std::string_view moveStr) {
+    if (!valid) return;
     LOG__TRACE(Logger::get().BOOK_LOG, "Moves {}", moveStr);
 
     // create and validate the move
-    Move move = Misc::getMoveFromUCI(currentPosition, moveStr);
+    Move move = Misc::getMoveFromUCI(currentPosition, std::string(moveStr));
     if (!isMove(move)) {
       LOG__WARN(Logger::get().BOOK_LOG, "Not a valid move {} on this position {}", moveStr, currentPosition.printFen());
+      valid = false;
       return;
     }
 
     addToBook(currentPosition, move);
-  }
+  });
 }
 
-void OpeningBook::processSANLine(std::string &line) {
-  std::smatch matcher;
-
-  // check if line starts valid
-  const std::regex startLineRegex(R"(^\d+\. )");
-  if (std::regex_match(line, matcher, startLineRegex)) {
-    LOG__TRACE(Logger::get().BOOK_LOG, "Line ignored: {}", line);
-    return;
-  }
-
-  // ignore patterns
-  const std::regex numberRegex(R"(^\d+\.)");
-  const std::regex resultRegex(R"((1/2|1|0)-(1/2|1|0))");
+void OpeningBook::processSANLine(std::string_view line) {
 
   //1. f4 d5 2. Nf3 Nf6 3. e3 g6 4. b3 Bg7 5. Bb2 O-O 6. Be2 c5 7. O-O Nc6 8. Ne5 Qc7 1/2-1/2
   //1. f4 d5 2. Nf3 Nf6 3. e3 Bg4 4. Be2 e6 5. O-O Bd6 6. b3 O-O 7. Bb2 c5 1/2-1/2
   // split at every whitespace and iterate through items
-  const std::regex splitRegex(R"(\s+)");
-  const std::sregex_token_iterator iter(line.begin(), line.end(), splitRegex, -1);
-  const std::sregex_token_iterator end;
-
   Position currentPosition; // start position
-  LOG__TRACE(Logger::get().BOOK_LOG, "Found {} items in line: {}", std::distance(iter, end), line);
-  for (auto i = iter; i != end; ++i) {
-    const std::string &moveStr = (*i).str();
+  bool valid = true;
+  Tokenizer::forEachToken(line, [&](std::string_view moveStr) {
+    if (!valid) return;
     LOG__TRACE(Logger::get().BOOK_LOG, "Item {}", moveStr);
-    if (std::regex_match(moveStr, matcher, numberRegex)) { continue; }
-    if (std::regex_match(moveStr, matcher, resultRegex)) { continue; }
+    // ignore move numbers and results
+    if (Tokenizer::isMoveNumber(moveStr) || Tokenizer::isResult(moveStr)) return;
     LOG__TRACE(Logger::get().BOOK_LOG, "SAN Move {}", moveStr);
 
     // create and validate the move
-    Move move = Misc::getMoveFromSAN(currentPosition, moveStr);
+    Move move = Misc::getMoveFromSAN(currentPosition, std::string(moveStr));
     if (move == MOVE_NONE) {
       LOG__WARN(Logger::get().BOOK_LOG, "Not a valid move {} on this position {}", moveStr, currentPosition.printFen());
+      valid = false;
       return;
     }
     LOG__TRACE(Logger::get().BOOK_LOG, "Move found {}", printMoveVerbose(move));
 
     addToBook(currentPosition, move);
-  }
+  });
 }
 
-void OpeningBook::processPGNFileFifo(std::vector<std::string> &lines) {
-  LOG__DEBUG(Logger::get().BOOK_LOG, "Process lines from PGN file with FIFO...");
-  // reading pgn and get a list of games
-  PGN_Reader pgnReader(lines);
-  // prepare FIFO for storing the games
-  Fifo<PGN_Game> gamesFifo;
+void OpeningBook::processPGNFileFifo(std::ifstream &ifstream) {
+  LOG__DEBUG(Logger::get().BOOK_LOG, "Process games from PGN file with FIFO...");
+  // reading pgn game by game
+  PGN_Reader pgnReader;
+  // prepare FIFO for storing the games - the reader waits while it is full
+  Fifo<PGN_Game> gamesFifo(GAMES_PER_CHUNK);
   // prepare thread pool
   const auto numberOfThreads = std::thread::hardware_concurrency() == 0 ?
                                4 : std::thread::hardware_concurrency();
@@ -296,7 +470,8 @@ void OpeningBook::processPGNFileFifo(std::vector<std::string> &lines) {
   // start finding games and putting them into the FIFO
   std::future<bool> future = std::async(std::launch::async, [&] {
     LOG__DEBUG(Logger::get().BOOK_LOG, "Start finding games");
-    finished = pgnReader.process(gamesFifo);
+    pgnReader.process(ifstream, [&](PGN_Game &&game) { gamesFifo.push(std::move(game)); });
+    finished = true;
     LOG__DEBUG(Logger::get().BOOK_LOG, "Finished finding games {}", finished);
     return finished;
   });
@@ -314,20 +489,22 @@ void OpeningBook::processPGNFileFifo(std::vector<std::string> &lines) {
 
 }
 
-void OpeningBook::processPGNFile(std::vector<std::string> &lines) {
-  LOG__DEBUG(Logger::get().BOOK_LOG, "Process lines from PGN file...");
-
-  // reading pgn and get a list of games
-  PGN_Reader pgnReader(lines);
-  if (!pgnReader.process()) {
-    LOG__ERROR(Logger::get().BOOK_LOG, "Could not process lines from PGN file.");
-    return;
-  }
-  auto ptrGames = &pgnReader.getGames();
-  gamesTotal = ptrGames->size();
-
-  // process all games
-  processGames(ptrGames);
+void OpeningBook::processPGNFile(std::ifstream &ifstream) {
+  LOG__DEBUG(Logger::get().BOOK_LOG, "Process games from PGN file...");
+
+  // reading pgn and processing the games in chunks
+  PGN_Reader pgnReader;
+  std::vector<PGN_Game> games;
+  games.reserve(GAMES_PER_CHUNK);
+  pgnReader.process(ifstream, [&](PGN_Game &&game) {
+    games.push_back(std::move(game));
+    if (games.size() < GAMES_PER_CHUNK) return;
+    gamesTotal += games.size();
+    processGames(&games);
+    games.clear();
+  });
+  gamesTotal += games.size();
+  processGames(&games);
 }
 
 void OpeningBook::processGames(std::vector<PGN_Game>* ptrGames) {// processing games
@@ -372,10 +549,6 @@ void OpeningBook::processGames(std::vector<PGN_Game>* ptrGames) {// processing g
 
 
 void OpeningBook::processGame(PGN_Game &game) {
-  std::smatch matcher;
-  const std::regex UCIRegex(R"(([a-h][1-8][a-h][1-8])([NBRQnbrq])?)");
-  const std::regex SANRegex(R"(([NBRQK])?([a-h])?([1-8])?x?([a-h][1-8]|O-O-O|O-O)(=?([NBRQ]))?([!?+#]*)?)");
-
   Position currentPosition; // start position
   for (auto moveStr : game.moves) {
     Move move = MOVE_NONE;
@@ -383,11 +556,11 @@ void OpeningBook::processGame(PGN_Game &game) {
     // check the notation format
     // Per PGN it must be SAN but some files have UCI notation
     // As UCI is pattern wise a subset of SAN we test for UCI first.  
-    if (std::regex_match(moveStr, matcher, UCIRegex)) {
+    if (Tokenizer::isUCIMove(moveStr)) {
       //      LOG__DEBUG(Logger::get().BOOK_LOG, "Game move {} is UCI", moveStr);
       move = Misc::getMoveFromUCI(currentPosition, moveStr);
     }
-    else if (std::regex_match(moveStr, matcher, SANRegex)) {
+    else {
       //      LOG__DEBUG(Logger::get().BOOK_LOG, "Game move {} is SAN", moveStr);
       move = Misc::getMoveFromSAN(currentPosition, moveStr);
     }
@@ -439,15 +612,92 @@ void OpeningBook::addToBook(Position &currentPosition, const Move &move) {
 
   // add move to the last book entry's move list
   BookEntry* lastEntry = &bookMap.at(lastKey);
-  if (std::find(lastEntry->moves.begin(), lastEntry->moves.end(), move) == lastEntry->moves.end()) {
+  const auto found = std::find(lastEntry->moves.begin(), lastEntry->moves.end(), move);
+  if (found == lastEntry->moves.end()) {
     lastEntry->moves.emplace_back(move);
+    lastEntry->moveCounter.emplace_back(1);
     lastEntry->ptrNextPosition.emplace_back(&bookMap.at(currentKey));
     LOG__TRACE(Logger::get().BOOK_LOG, "Added to last entry.");
   }
+  else {
+    lastEntry->moveCounter[found - lastEntry->moves.begin()]++;
+  }
+
+}
+
+Move OpeningBook::getBinaryMove(Key zobrist) const {
+  const BinaryEntry* const begin = pBinaryBook->entries;
+  const BinaryEntry* const end = begin + pBinaryBook->entryCount;
+  const BinaryEntry* entry = std::lower_bound(begin, end, zobrist,
+                                              [](const BinaryEntry &e, Key key) { return e.key < key; });
+  if (entry == end || entry->key != zobrist) return MOVE_NONE;
+  // moves which have been played more often are chosen more often
+  const BinaryMove* const moves = pBinaryBook->moves + entry->firstMove;
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < entry->moveCount; i++) total += moves[i].weight;
+  std::random_device rd;
+  std::uniform_int_distribution<uint64_t> random(0, total - 1);
+  uint64_t pick = random(rd);
+  for (uint32_t i = 0; i < entry->moveCount; i++) {
+    if (pick < moves[i].weight) return moves[i].move;
+    pick -= moves[i].weight;
+  }
+  return moves[entry->moveCount - 1].move;
+}
+
+Move OpeningBook::getPolyglotMove(const Position &position) const {
+  const Key key = position.getPolyglotKey();
+  const PolyglotEntry* const begin = pBinaryBook->polyglotEntries;
+  const PolyglotEntry* const end = begin + pBinaryBook->entryCount;
+  const PolyglotEntry* const first = std::lower_bound(begin, end, key, [](const PolyglotEntry &e, Key k) {
+    return fromBigEndian(e.key) < k;
+  });
+  const PolyglotEntry* last = first;
+  uint64_t total = 0;
+  for (; last != end && fromBigEndian(last->key) == key; ++last) total += fromBigEndian(last->weight);
+  if (first == last) return MOVE_NONE;
+
+  // moves with a higher weight are chosen more often - all equal if there are no weights
+  std::random_device rd;
+  std::uniform_int_distribution<uint64_t> random(0, (total ? total : last - first) - 1);
+  uint64_t pick = random(rd);
+  const PolyglotEntry* entry = first;
+  for (; entry != last - 1; ++entry) {
+    const uint64_t weight = total ? fromBigEndian(entry->weight) : 1;
+    if (pick < weight) break;
+    pick -= weight;
+  }
+
+  // to, from and promotion piece (knight=1 .. queen=4) - castling is encoded
+  // as the king capturing its own rook
+  const uint16_t polyglotMove = fromBigEndian(entry->move);
+  const auto from = Square(polyglotMove >> 6 & 0x3F);
+  auto to = Square(polyglotMove & 0x3F);
+  const int promotion = polyglotMove >> 12 & 0x7;
+  const Piece piece = position.getPiece(from);
+  if (piece != PIECE_NONE && typeOf(piece) == KING
+      && position.getPiece(to) == makePiece(colorOf(piece), ROOK)) {
+    to = to > from ? Square(from + 2) : Square(from - 2);
+  }
+  MoveGenerator mg;
+  for (const Move move : *mg.generateLegalMoves<MoveGenerator::GENALL>(position)) {
+    if (getFromSquare(move) == from && getToSquare(move) == to
+        && (typeOf(move) == PROMOTION ? promotionType(move) - PAWN : 0) == promotion) {
+      return moveOf(move);
+    }
+  }
+  LOG__WARN(Logger::get().BOOK_LOG, "Polyglot book move {:04x} is not legal in {}", polyglotMove, position.printFen());
+  return MOVE_NONE;
+}
 
+Move OpeningBook::getRandomMove(const Position &position) {
+  if (pBinaryBook && pBinaryBook->polyglotEntries) return getPolyglotMove(position);
+  return getRandomMove(position.getZobristKey());
 }
 
 Move OpeningBook::getRandomMove(Key zobrist) {
+  // polyglot books need the position to compute their own key
+  if (pBinaryBook) return pBinaryBook->entries ? getBinaryMove(zobrist) : MOVE_NONE;
   Move bookMove = MOVE_NONE;
   if (bookMap.find(zobrist) != bookMap.end()) {
     BookEntry bookEntry = bookMap.at(zobrist);
@@ -468,7 +718,7 @@ std::string BookEntry::str() {
   std::ostringstream os;
   os << this->fen << " (" << this->counter << ") ";
   for (int i = 0; i < moves.size(); i++) {
-    os << "[" << printMove(this->moves[i]) << " (" << this->ptrNextPosition[i]->counter << ")] ";
+    os << "[" << printMove(this->moves[i]) << " (" << this->moveCounter[i] << ")] ";
   }
   return os.str();
 }
@@ -27,6 +27,8 @@
 #define FRANKYCPP_OPENINGBOOK_H
 
 #include <map>
+#include <memory>
+#include <string_view>
 #include "gtest/gtest_prod.h"
 #include "PGN_Reader.h"
 #include "Position.h"
@@ -38,6 +40,8 @@ struct BookEntry {
   std::string fen{};
   int counter{0};
   std::vector<Move> moves{};
+  // number of times each move has been played from this position
+  std::vector<int> moveCounter{};
   std::vector<BookEntry*> ptrNextPosition{};
 
   BookEntry(const Key &zobrist, const std::string &fenString) : key(zobrist), fen(fenString), counter{1} {}
@@ -50,9 +54,52 @@ public:
   enum class BookFormat {
     SIMPLE,
     SAN,
-    PGN
+    PGN,
+    BINARY,
+    POLYGLOT
   };
 
+  /**
+   * Layout of a compiled binary book: header, entries sorted by zobrist key,
+   * moves of all entries. Each entry points to its consecutive moves.
+   * The header identifies the source book and the zobrist keys the binary
+   * book was compiled with so a stale binary book is not used.
+   */
+  struct BinaryHeader {
+    char magic[4]{'F', 'K', 'B', 'K'};
+    uint32_t version = 2;
+    uint64_t entries = 0;
+    uint64_t moves = 0;
+    // size and last write time of the source book (0 if unknown)
+    uint64_t sourceSize = 0;
+    int64_t sourceTime = 0;
+    // zobrist key of the start position
+    Key startKey = 0;
+  };
+  struct BinaryEntry {
+    Key key;
+    uint32_t firstMove;
+    uint32_t moveCount;
+  };
+  struct BinaryMove {
+    Move move;
+    // number of times the move has been played in the source games
+    uint32_t weight;
+  };
+  static_assert(sizeof(BinaryHeader) == 48 && sizeof(BinaryEntry) == 16 && sizeof(BinaryMove) == 8);
+
+  /**
+   * Entry of a Polyglot book. All values are stored big endian and the
+   * entries are sorted by key. A position has one entry per book move.
+   */
+  struct PolyglotEntry {
+    uint64_t key;
+    uint16_t move;
+    uint16_t weight;
+    uint32_t learn;
+  };
+  static_assert(sizeof(PolyglotEntry) == 16);
+
 private:
   std::mutex bookMutex;
   bool isInitialized = false;
@@ -64,22 +111,53 @@ private:
   uint64_t gamesTotal = 0;
   uint64_t gamesProcessed = 0;
 
+  // books are read in chunks to keep the memory bounded for large files
+  static constexpr std::size_t LINES_PER_CHUNK = 100'000;
+  static constexpr std::size_t GAMES_PER_CHUNK = 1'000;
+
+  // memory mapped binary or polyglot book (BookFormat::BINARY, POLYGLOT)
+  struct BinaryBook;
+  std::unique_ptr<BinaryBook> pBinaryBook{};
+
 public:
   explicit OpeningBook(const std::string &bookPath, const BookFormat &bFormat);
+  ~OpeningBook();
 
+  /**
+   * Reads the book. A text or PGN book is replaced by a compiled binary
+   * book with the same path plus ".bin" if this was compiled from the
+   * unchanged source book.
+   */
   void initialize();
-  uint64_t size() { return bookMap.size(); }
+
+  /** number of positions - for polyglot books the number of entries */
+  uint64_t size() const;
+
+  /** weighted random book move for the given zobrist key (not for polyglot books) */
   Move getRandomMove(Key zobrist);
 
+  /** weighted random book move for the position - works with all book formats */
+  Move getRandomMove(const Position &position);
+
+  /**
+   * Writes the initialized book as a binary book (positions with moves only)
+   * which can be read with BookFormat::BINARY without any parsing.
+   */
+  bool saveBinary(const std::string &filePath) const;
+
 private:
   void readBookFromFile(const std::string &filePath);
-  std::vector<std::string> getLinesFromFile(std::ifstream &ifstream);
+  bool readBinaryBook(const std::string &filePath, const std::string &sourcePath = "");
+  Move getBinaryMove(Key zobrist) const;
+  bool readPolyglotBook(const std::string &filePath);
+  Move getPolyglotMove(const Position &position) const;
+  bool getLinesFromFile(std::ifstream &ifstream, std::vector<std::string> &lines);
   void processAllLines(std::vector<std::string> &lines);
   void processLine(std::string &line);
-  void processSimpleLine(std::string &line);
-  void processSANLine(std::string &line);
-  void processPGNFileFifo(std::vector<std::string> &lines);
-  void processPGNFile(std::vector<std::string> &lines);
+  void processSimpleLine(std::string_view line);
+  void processSANLine(std::string_view line);
+  void processPGNFileFifo(std::ifstream &ifstream);
+  void processPGNFile(std::ifstream &ifstream);
   void processGames(std::vector<PGN_Game>* ptrGames);
   void processGame(PGN_Game &game);
   void addToBook(Position &currentPosition, const Move &move);
@@ -28,6 +28,7 @@
 #include "PGN_Reader.h"
 #include "misc.h"
 #include "Fifo.h"
+#include "Tokenizer.h"
 
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/regex.hpp>
@@ -37,16 +38,14 @@ using namespace std::string_literals;
 
 static const boost::regex trailingComments(R"(;.*$)");
 static const boost::regex tagPairs(R"(\[\w+ +".*?"\])");
+static const boost::regex tagPair(R"(\[(\w+) +"(.*?)\"\])");
 static const boost::regex doubleWhiteSpace(R"(\s+)");
 static const boost::regex moveSectionStart(R"(^(\d+.)|([KQRBN]?[a-h][1-8]))");
-static const boost::regex moveSectionEnd(R"(.*((1-0)|(0-1)|(1/2-1/2)|\*)$)");
-static const boost::regex nagAnnotation(R"((\$\d{1,3}))"); // no NAG annotation supported
-static const boost::regex bracketComments(R"(\{[^{}]*\})"); // bracket comments
-static const boost::regex reservedSymbols(R"(<[^<>]*>)"); // reserved symbols < >
-static const boost::regex ravVariants(R"(\([^()]*\))"); // RAV variant comments < >
-static const boost::regex resultsRgx(R"(((1-0)|(0-1)|(1/2-1/2)|\*))");
-static const boost::regex moveNumbers(R"(\d{1,3}( )*(\.{1,3}))");
-static const boost::regex moveRgx(R"(([NBRQK])?([a-h])?([1-8])?x?([a-h][1-8]|O-O-O|O-O)(=([NBRQ]))?([!?+#]*)?)");
+
+/** true if the line ends the move section of a game (result not in a trailing comment) */
+static inline bool isMoveSectionEnd(std::string_view line) {
+  return Tokenizer::endsWithResult(line.substr(0, line.find(';')));
+}
 
 PGN_Reader::PGN_Reader(std::vector<std::string> &lines) {
   inputLines = std::make_shared<std::vector<std::string>>(lines);
@@ -55,18 +54,18 @@ PGN_Reader::PGN_Reader(std::vector<std::string> &lines) {
 bool PGN_Reader::process(Fifo<PGN_Game> &gamesFifo) {
   LOG__TRACE(Logger::get().BOOK_LOG, "Finding games in {:n} lines.", inputLines->size());
   const auto start = std::chrono::high_resolution_clock::now();
-  // loop over all input lines
+  // loop over all input lines - the games are only handed to the fifo
   VectorIterator linesIter = inputLines->begin();
   while (linesIter < inputLines->end()) {
-    LOG__TRACE(Logger::get().BOOK_LOG, "Finding game {:n}", games.size() + 1);
-    PGN_Game game = processOneGame(linesIter);
-    games.push_back(game);
-    gamesFifo.push(game);
+    LOG__TRACE(Logger::get().BOOK_LOG, "Finding game {:n}", gamesFound + 1);
+    gamesFifo.push(processOneGame(linesIter, inputLines->end()));
+    gamesFound++;
+    logProgress(linesIter);
     LOG__TRACE(Logger::get().BOOK_LOG, "Game Fifo has {:n} games", gamesFifo.size());
   }
   const auto stop = std::chrono::high_resolution_clock::now();
   const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
-  LOG__INFO(Logger::get().BOOK_LOG, "Found {:n} games in {:n} ms", games.size(), elapsed.count());
+  LOG__INFO(Logger::get().BOOK_LOG, "Found {:n} games in {:n} ms", gamesFound, elapsed.count());
   return true;
 }
 
@@ -77,7 +76,9 @@ bool PGN_Reader::process() {
   VectorIterator linesIter = inputLines->begin();
   while (linesIter < inputLines->end()) {
     LOG__TRACE(Logger::get().BOOK_LOG, "Processing game {:n}", games.size() + 1);
-    games.push_back(processOneGame(linesIter));
+    games.push_back(processOneGame(linesIter, inputLines->end()));
+    gamesFound++;
+    logProgress(linesIter);
   }
   const auto stop = std::chrono::high_resolution_clock::now();
   const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
@@ -85,7 +86,48 @@ bool PGN_Reader::process() {
   return true;
 }
 
-inline PGN_Game PGN_Reader::processOneGame(VectorIterator &iterator) {
+uint64_t PGN_Reader::process(std::istream &input, const std::function<void(PGN_Game &&)> &consumer) {
+  LOG__TRACE(Logger::get().BOOK_LOG, "Finding games in stream.");
+  const auto start = std::chrono::high_resolution_clock::now();
+  // collect the lines of one game until the end of its move section
+  std::vector<std::string> gameLines;
+  auto processGameLines = [&] {
+    VectorIterator linesIter = gameLines.begin();
+    while (linesIter < gameLines.end()) {
+      consumer(processOneGame(linesIter, gameLines.end()));
+      if (++gamesFound % 10'000 == 0) {
+        LOG__DEBUG(Logger::get().BOOK_LOG, "Finding games: {:n} games", gamesFound);
+      }
+    }
+    gameLines.clear();
+  };
+  std::string line;
+  while (std::getline(input, line)) {
+    trim(line);
+    if (line.empty()) continue;
+    gameLines.push_back(line);
+    if (starts_with(line, "[") || starts_with(line, "%")) continue;
+    if (isMoveSectionEnd(line)) processGameLines();
+  }
+  // last game without a result
+  if (!gameLines.empty()) processGameLines();
+  const auto stop = std::chrono::high_resolution_clock::now();
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+  LOG__INFO(Logger::get().BOOK_LOG, "Found {:n} games in {:n} ms", gamesFound, elapsed.count());
+  return gamesFound;
+}
+
+inline void PGN_Reader::logProgress(const VectorIterator &iterator) {
+  const uint64_t dist = inputLines->size() - std::distance(iterator, inputLines->end());
+  // x % 0 is undefined in c++
+  // avgLinesPerGameTimesProgressSteps = 12*15 as 12 is avg game lines and 15 steps
+  const uint64_t progressInterval = 1 + (inputLines->size() / avgLinesPerGameTimesProgressSteps);
+  if (gamesFound % progressInterval == 0) {
+    LOG__DEBUG(Logger::get().BOOK_LOG, "Finding games: {:s}", Misc::printProgress(static_cast<double>(dist) / inputLines->size()));
+  }
+}
+
+inline PGN_Game PGN_Reader::processOneGame(VectorIterator &iterator, const VectorIterator &end) {
   bool gameEndReached = false;
   PGN_Game game{};
   do {
@@ -94,7 +136,16 @@ inline PGN_Game PGN_Reader::processOneGame(VectorIterator &iterator) {
     trim(*iterator);
     // ignore comment lines
     if (starts_with(*iterator, "%")) continue;
-    // ignore meta data tags for now
+    // keep meta data tags (e.g. the result for tuning)
+    if (starts_with(*iterator, "[")) {
+      std::string_view name, value;
+      if (Tokenizer::parseTagPair(*iterator, name, value)) {
+        game.tags[std::string(name)] = std::string(value);
+        continue;
+      }
+      boost::smatch match;
+      if (boost::regex_search(*iterator, match, tagPair)) game.tags[match[1]] = match[2];
+    }
     replace_all_regex(*iterator, tagPairs, " "s);
     // trailing comments
     erase_regex(*iterator, trailingComments);
@@ -104,68 +155,35 @@ inline PGN_Game PGN_Reader::processOneGame(VectorIterator &iterator) {
     trim(*iterator);
     // process move section
     if (find_regex(*iterator, moveSectionStart)) {
-      handleMoveSection(iterator, game);
+      handleMoveSection(iterator, end, game);
       gameEndReached = true;
-      if (iterator >= inputLines->end()) break;
+      if (iterator >= end) break;
     }
-  } while (++iterator < inputLines->end() && !gameEndReached);
-  const uint64_t dist = inputLines->size() - std::distance(iterator, inputLines->end());
-  // x % 0 is undefined in c++
-  // avgLinesPerGameTimesProgressSteps = 12*15 as 12 is avg game lines and 15 steps
-  const uint64_t progressInterval = 1 + (inputLines->size() / avgLinesPerGameTimesProgressSteps);
-  if (games.size() % progressInterval == 0) {
-    LOG__DEBUG(Logger::get().BOOK_LOG, "Finding games: {:s}", Misc::printProgress(static_cast<double>(dist) / inputLines->size()));
-  }
+  } while (++iterator < end && !gameEndReached);
   return game;
 }
 
-inline void PGN_Reader::handleMoveSection(VectorIterator &iterator, PGN_Game &game) {
+inline void PGN_Reader::handleMoveSection(VectorIterator &iterator, const VectorIterator &end, PGN_Game &game) {
   LOG__TRACE(Logger::get().BOOK_LOG, "Move section line: {}    (length={})", *iterator, iterator->size());
 
   // read and concatenate all lines belonging to the move section of  one game
-  std::ostringstream os;
+  // (line breaks are kept as they end ; comments)
+  std::string moveSection;
   do {
-    trim(*iterator);
     // ignore comment lines
     if (starts_with(*iterator, "%")) continue;
-    // trailing comments
-    erase_regex(*iterator, trailingComments);
-    // append line
-    os << *iterator << " ";
+    moveSection += *iterator;
+    moveSection += '\n';
     // look for end pattern
-    if (find_regex(*iterator, moveSectionEnd)) break;
-  } while (++iterator < inputLines->end());
-  std::string moveSection = os.str();
+    if (isMoveSectionEnd(*iterator)) break;
+  } while (++iterator < end);
   LOG__TRACE(Logger::get().BOOK_LOG, "Move section: {} (length={})", moveSection, moveSection.size());
 
-  // eliminate unwanted stuff
-  replace_all_regex(moveSection, nagAnnotation, " "s);
-  replace_all_regex(moveSection, bracketComments, " "s);
-  replace_all_regex(moveSection, reservedSymbols, " "s);
-  // handle nested RAV variation comments
-  do { // no RAV variations supported (could be nested)
-    replace_all_regex(moveSection, ravVariants, " "s);
-  } while (find_regex(moveSection, ravVariants));
-  // remove result from line
-  replace_all_regex(moveSection, resultsRgx, ""s);
-  // remove move numbers
-  replace_all_regex(moveSection, moveNumbers, " "s);
-  // eliminate double whitespace
-  replace_all_regex(moveSection, doubleWhiteSpace, " "s);
-  trim(moveSection);
-  LOG__TRACE(Logger::get().BOOK_LOG, "Move section clean (length={}): {} ", moveSection.size(), moveSection);
-
-  // add to game
-  std::vector<std::string> moves{};
-  split(moves, moveSection, is_space(), token_compress_on);
-  LOG__TRACE(Logger::get().BOOK_LOG, "Moves extracted: {} ", moves.size());
-  // move detection
-  for (auto m : moves) {
-    if (find_regex(m, moveRgx)) {
-      LOG__TRACE(Logger::get().BOOK_LOG, "Move: {} ", m);
-      game.moves.push_back(m);
-    }
-  }
+  // comments, variations, NAGs, move numbers and results are skipped
+  Tokenizer::forEachMovetextToken(moveSection, [&](std::string_view move) {
+    LOG__TRACE(Logger::get().BOOK_LOG, "Move: {} ", move);
+    game.moves.emplace_back(move);
+  });
 }
 
 /**
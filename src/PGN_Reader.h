@@ -64,6 +64,8 @@
  * =============================================================================
  */
 
+#include <functional>
+#include <istream>
 #include <string>
 #include <vector>
 #include <map>
@@ -87,16 +89,29 @@ struct PGN_Game {
 class PGN_Reader {
   std::shared_ptr<std::vector<std::string>> inputLines{};
   std::vector<PGN_Game> games{};
+  uint64_t gamesFound = 0;
 
 public:
+  PGN_Reader() = default;
   PGN_Reader(std::vector<std::string> &lines);
   bool process(Fifo<PGN_Game> &gamesFifo);
   bool process();
+
+  /**
+   * Reads the games one by one from the stream and hands each game to the
+   * consumer. Only the lines of the current game are kept in memory and
+   * the games are not stored in the reader.
+   * @return number of games found
+   */
+  uint64_t process(std::istream &input, const std::function<void(PGN_Game &&)> &consumer);
+
   std::vector<PGN_Game> & getGames() { return games; }
+  uint64_t getGamesFound() const { return gamesFound; }
 
 private:
-  PGN_Game processOneGame(VectorIterator &iterator);
-  void handleMoveSection(VectorIterator &iterator, PGN_Game &game);
+  PGN_Game processOneGame(VectorIterator &iterator, const VectorIterator &end);
+  void handleMoveSection(VectorIterator &iterator, const VectorIterator &end, PGN_Game &game);
+  void logProgress(const VectorIterator &iterator);
 };
 
 
@@ -0,0 +1,66 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "PackedPosition.h"
+#include "Bitboards.h"
+#include "Position.h"
+
+PackedPosition PackedPosition::pack(const Position &position, uint8_t result) {
+  PackedPosition packed;
+  packed.occupied = position.getOccupiedBB();
+  packed.nextPlayer = static_cast<uint8_t>(position.getNextPlayer());
+  packed.result = result;
+  Bitboard occupied = packed.occupied;
+  for (int i = 0; occupied; i++) {
+    const Square sq = Bitboards::popLSB(occupied);
+    packed.pieces[i / 2] |= static_cast<uint8_t>(position.getPiece(sq) << (4 * (i & 1)));
+  }
+  return packed;
+}
+
+std::string PackedPosition::fen() const {
+  Piece board[SQ_LENGTH]{};
+  Bitboard bb = occupied;
+  for (int i = 0; bb; i++) board[Bitboards::popLSB(bb)] = piece(i);
+  std::string fen;
+  fen.reserve(80);
+  for (int r = RANK_8; r >= RANK_1; r--) {
+    int empty = 0;
+    for (int f = FILE_A; f <= FILE_H; f++) {
+      const Piece pc = board[r * 8 + f];
+      if (pc == PIECE_NONE) {
+        empty++;
+        continue;
+      }
+      if (empty) fen += char('0' + empty);
+      empty = 0;
+      fen += pieceToChar[pc];
+    }
+    if (empty) fen += char('0' + empty);
+    if (r > RANK_1) fen += '/';
+  }
+  fen += nextPlayer == WHITE ? " w - - 0 1" : " b - - 0 1";
+  return fen;
+}
@@ -0,0 +1,58 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef FRANKYCPP_PACKEDPOSITION_H
+#define FRANKYCPP_PACKEDPOSITION_H
+
+#include <string>
+#include "types.h"
+
+// forward declared dependencies
+class Position;
+
+/**
+ * Board and side to move in 32 bytes for storing and evaluating large
+ * numbers of positions. Castling rights and en passant are not stored as
+ * they do not change the static evaluation. A Position can be set up from
+ * a PackedPosition without going through a FEN (Position::setup()).
+ */
+struct PackedPosition {
+  Bitboard occupied = 0;
+  // 4 bit piece codes in the order of the squares in occupied
+  uint8_t pieces[16]{};
+  uint8_t nextPlayer = WHITE;
+  // free for the user - e.g. the game result for tuning
+  uint8_t result = 0;
+
+  static PackedPosition pack(const Position &position, uint8_t result = 0);
+
+  /** piece of the i-th occupied square */
+  Piece piece(int i) const { return Piece((pieces[i / 2] >> (4 * (i & 1))) & 0xF); }
+
+  std::string fen() const;
+};
+static_assert(sizeof(PackedPosition) == 32);
+
+#endif //FRANKYCPP_PACKEDPOSITION_H
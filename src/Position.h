@@ -29,10 +29,13 @@
 #include <array>
 #include <algorithm>
 #include "types.h"
+#include "Material.h"
+#include "NNUE.h"
 #include "gtest/gtest_prod.h"
 
 // circle reference between Position and MoveGenerator - this make it possible
 class MoveGenerator;
+struct PackedPosition;
 
 namespace Zobrist {
   // zobrist key for pieces - piece, board
@@ -40,8 +43,35 @@ namespace Zobrist {
   extern Key castlingRights[CR_LENGTH];
   extern Key enPassantFile[FILE_LENGTH];
   extern Key nextPlayer;
+  // start value of the pawn key so positions without pawns have a key != 0
+  extern Key noPawns;
 } // namespace Zobrist
 
+/**
+ * Cuckoo tables with the zobrist key differences of all reversible piece
+ * moves (no pawns) on an empty board and the corresponding moves.
+ * Used to detect upcoming repetitions (Marcel van Kervinck's algorithm).
+ */
+namespace Cuckoo {
+  constexpr int SIZE = 8192;
+  inline int h1(const Key key) { return static_cast<int>(key & 0x1FFF); }
+  inline int h2(const Key key) { return static_cast<int>((key >> 16) & 0x1FFF); }
+  extern Key keys[SIZE];
+  extern Move moves[SIZE];
+} // namespace Cuckoo
+
+/**
+ * Random numbers of the Polyglot opening book format. Polyglot books are
+ * indexed with keys built from these instead of our own zobrist keys.
+ */
+namespace Polyglot {
+  constexpr int RANDOM_LENGTH = 781;
+  constexpr int CASTLING_OFFSET = 768;
+  constexpr int EN_PASSANT_OFFSET = 772;
+  constexpr int TURN_OFFSET = 780;
+  extern const Key random64[RANDOM_LENGTH];
+} // namespace Polyglot
+
 /**
  * This class represents the chess board and its position.<br>
  * It uses a 8x8 piece board and bitboards, a stack for undo moves, zobrist keys
@@ -64,6 +94,16 @@ class Position {
   // state variables change.
   Key zobristKey{};
 
+  // Zobrist key of the pawns only to index the pawn table of the evaluator.
+  // Also updated incrementally.
+  Key pawnKey{};
+
+  // Number of pieces of each piece packed into one key (see Material.h) to
+  // look up the precomputed material table. Also updated incrementally.
+  Key materialKey{};
+  // index into the material table (sum of Material::INDEX_DELTA of all pieces)
+  int materialIndex{};
+
   // **********************************************************
   // Board State START ----------------------------------------
   // unique chess position (exception is 3-fold repetition
@@ -126,6 +166,12 @@ class Position {
   };
   std::array<HistoryState, MAX_HISTORY> historyState{};
 
+  // counts the zobrist keys of the positions in the history by their lower
+  // bits. A position can only be a repetition if its counter is not zero
+  // which saves scanning the history for most positions.
+  constexpr static std::size_t REPETITION_FILTER_SIZE = 1 << 12;
+  std::array<uint16_t, REPETITION_FILTER_SIZE> repetitionFilter{};
+
   // Calculated by doMove/undoMove
 
   // Material value will always be up to date
@@ -133,8 +179,11 @@ class Position {
   int materialNonPawn[COLOR_LENGTH]{};
 
   // Positional value will always be up to date
-  int psqMidValue[COLOR_LENGTH]{};
-  int psqEndValue[COLOR_LENGTH]{};
+  Score psqScore[COLOR_LENGTH]{};
+
+  // NNUE first layer accumulator - updated incrementally when a network is
+  // enabled and (re)computed lazily by NNUE::evaluate
+  mutable NNUE::Accumulator accumulator;
 
   // Game phase value
   int gamePhase{};
@@ -168,6 +217,13 @@ public:
    */
   explicit Position(const std::string &fen);
 
+  /**
+   * Creates a board position from a packed position (no castling rights and
+   * no en passant)
+   * @param packed
+   */
+  explicit Position(const PackedPosition &packed);
+
   /**
    * Copy constructor - creates a copy of the given Position
    * @param op
@@ -197,6 +253,14 @@ public:
    */
   ~Position() = default;
 
+  /**
+   * Sets up this position again from a packed position. Cheaper than
+   * creating a new Position as the move history is not cleared but only
+   * its counter reset. Used to evaluate many positions with one object.
+   * @param packed
+   */
+  void setup(const PackedPosition &packed);
+
   /**
    * Returns a String representation of the chess position of this Position as
    * a FEN String.
@@ -284,6 +348,29 @@ public:
    */
   bool isAttacked(Square sq, Color byColor) const;
 
+  /**
+   * All pieces of both colors attacking the given square with the given
+   * occupancy. Pieces removed from the occupancy do not attack and sliders
+   * behind them (x-ray) are included.
+   *
+   * @param sq
+   * @param occupied
+   * @return bitboard of all attackers (not masked with occupied)
+   */
+  Bitboard attacksTo(Square sq, Bitboard occupied) const;
+
+  /**
+   * Static Exchange Evaluation - the material balance of the capture sequence
+   * on the target square of the move when both sides always recapture with
+   * their least valuable attacker and may stop capturing at any time.
+   * Pins and checks are not considered.
+   * https://www.chessprogramming.org/Static_Exchange_Evaluation
+   *
+   * @param move
+   * @return material gain of the move for the side to move
+   */
+  Value see(Move move) const;
+
   /**
    * This checks if the  move is legal by checking if it leaves the king in
    * check or if it would pass an attacked square when castling.
@@ -296,6 +383,13 @@ public:
    */
   bool isLegalPosition() const;
 
+  /**
+   * Computes the key of the position as defined by the Polyglot book format.
+   * En passant is only part of the key if a pawn of the next player is able
+   * to capture. Not incrementally updated - only used for book lookups.
+   */
+  Key getPolyglotKey() const;
+
   /**
    * The fifty-move rule if during the previous 50 moves no pawn has been
    * moved and no capture has been made, either player may claim a draw.
@@ -327,13 +421,35 @@ public:
    */
   int countRepetitions() const;
 
+  /**
+   * Detects if the next player has a reversible move which leads to a
+   * position already in the history (upcoming repetition). Uses the cuckoo
+   * tables instead of generating and making moves.
+   * Repetitions of positions before the search root only count if the
+   * position has been repeated already.
+   *
+   * @param ply the distance of this position to the search root
+   * @return true if the next player can repeat a position
+   */
+  bool hasUpcomingRepetition(int ply) const;
+
   /**
    * FIDE Draws - Evaluation might define some more draw values.
+   * Also includes KNNK where a mate can't be forced.
    *
    * @return true if neither side can win
    */
   bool checkInsufficientMaterial() const;
 
+  /**
+   * Dead positions where no sequence of moves leads to a mate (KK, KNK, KBK
+   * and KBKB with bishops on same colored squares). Other than
+   * checkInsufficientMaterial() this is safe to cut the search with.
+   *
+   * @return true if neither side can mate
+   */
+  bool checkDeadMaterial() const;
+
   /**
    * Returns the last move. Returns Move.NOMOVE if there is no last move.
    *
@@ -357,6 +473,10 @@ public:
   ///// GETTER / SETTER
   inline Piece getPiece(const Square square) const { return board[square]; }
   inline Key getZobristKey() const { return zobristKey; }
+  inline Key getPawnKey() const { return pawnKey; }
+  inline Key getMaterialKey() const { return materialKey; }
+  inline int getMaterialIndex() const { return materialIndex; }
+  inline const Material::Entry* getMaterialEntry() const { return Material::probe(materialKey, materialIndex); }
   inline Color getNextPlayer() const { return nextPlayer; }
   inline Square getEnPassantSquare() const { return enPassantSquare; }
   inline Square getKingSquare(const Color color) const {
@@ -399,11 +519,12 @@ public:
   inline int getMaterialNonPawn(const Color c) const {
     return materialNonPawn[c];
   }
-  inline int getMidPosValue(const Color c) const { return psqMidValue[c]; }
-  inline int getEndPosValue(const Color c) const { return psqEndValue[c]; }
+  inline Score getPosScore(const Color c) const { return psqScore[c]; }
+  inline int getMidPosValue(const Color c) const { return mgValue(psqScore[c]); }
+  inline int getEndPosValue(const Color c) const { return egValue(psqScore[c]); }
+  inline NNUE::Accumulator &getAccumulator() const { return accumulator; }
   inline int getPosValue(const Color c) const {
-    return static_cast<int>(getGamePhaseFactor() * psqMidValue[c] +
-                            (1 - getGamePhaseFactor()) * psqEndValue[c]);
+    return taper(psqScore[c], getGamePhaseFactor());
   }
 
   /** 24 for beginning, 0 at the end */
@@ -429,8 +550,11 @@ private:
   ///// FUNC
 
   FRIEND_TEST(PositionTest, PosValue);
+  FRIEND_TEST(PositionTest, repetitionSimple);
+  FRIEND_TEST(PerformanceTests, Repetition_PPS);
 
   void initializeBoard();
+  void clearBoard();
   void setupBoard(const char *fen);
   void movePiece(Square fromSq, Square toSq);
   void putPiece(Piece piece, Square square);
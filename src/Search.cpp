@@ -24,12 +24,15 @@
  */
 
 #include <iostream>
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include "Logging.h"
 #include "Search.h"
 #include "Bitboards.h"
 #include "Evaluator.h"
+#include "Bitbase.h"
+#include "Material.h"
 #include "Engine.h"
 #include "SearchConfig.h"
 #include "Position.h"
@@ -47,6 +50,7 @@ Search::Search(Engine* pEng) : Search(pEng, SearchConfig::TT_SIZE_MB) {}
 Search::Search(Engine* pEng, int ttSizeInByte) {
   pEngine = pEng;
   pEvaluator = std::make_unique<Evaluator>();
+  pEvaluator->updatePolicy();
   pOpeningBook = std::make_unique<OpeningBook>(
     FrankyCPP_PROJECT_ROOT + SearchConfig::BOOK_PATH,
     SearchConfig::BOOK_TYPE);
@@ -180,7 +184,9 @@ void Search::run(Position position) {
   // Initialize for new search
   myColor = position.getNextPlayer();
   lastSearchResult = SearchResult();
-  timeLimit = extraTime = 0;
+  timeLimit = extraTime = softTimeLimit = 0;
+  nodeTimeCheck = false;
+  nodesAtTimerStart = 0;
   searchStats = SearchStats();
 
   // store the start time of the search
@@ -227,7 +233,7 @@ void Search::run(Position position) {
       && searchLimitsPtr->isTimeControl()
       // when we got a list of possible moves from UCI we skip the opening book 
       && searchLimitsPtr->getMoves().empty()) {
-    lastSearchResult.bestMove = pOpeningBook->getRandomMove(position.getZobristKey());
+    lastSearchResult.bestMove = pOpeningBook->getRandomMove(position);
     if (lastSearchResult.bestMove != MOVE_NONE) {
       hadBookMove = true;
     }
@@ -237,7 +243,12 @@ void Search::run(Position position) {
   // ###########################################################################
   // start iterative deepening
   if (!SearchConfig::USE_BOOK || lastSearchResult.bestMove == MOVE_NONE) {
-    lastSearchResult = iterativeDeepening(position);
+    if (searchLimitsPtr->getMate() && SearchConfig::USE_MATE_SOLVER) {
+      lastSearchResult = mateSearch(position);
+    }
+    else {
+      lastSearchResult = iterativeDeepening(position);
+    }
   }
   else {
     LOG__DEBUG(Logger::get().SEARCH_LOG, "Book Move: {}", printMoveVerbose(lastSearchResult.bestMove));
@@ -260,6 +271,7 @@ void Search::run(Position position) {
   // print result of the search
   LOG__INFO(Logger::get().SEARCH_LOG, "Search statistics: {}", searchStats.str());
   if (SearchConfig::USE_TT) { LOG__INFO(Logger::get().SEARCH_LOG, tt->str()); }
+  LOG__INFO(Logger::get().SEARCH_LOG, pEvaluator->evalCacheStats());
   LOG__INFO(Logger::get().SEARCH_LOG, "Search Depth was {} ({})", searchStats.currentSearchDepth, searchStats.currentExtraSearchDepth);
   LOG__INFO(Logger::get().SEARCH_LOG, "Search took {},{:03} sec ({:n} nps)", (searchStats.lastSearchTime % 1'000'000) / 1'000, (searchStats.lastSearchTime % 1'000), (searchStats.nodesVisited * 1'000) / (searchStats.lastSearchTime + 1));
   LOG__INFO(Logger::get().SEARCH_LOG, "Search Result was: {} ({})", printMove(lastSearchResult.bestMove), printMove(lastSearchResult.ponderMove));
@@ -311,10 +323,19 @@ SearchResult Search::iterativeDeepening(Position &position) {
     return searchResult;
   }
 
+  // the production search has its features as compile time constants -
+  // changed runtime flags need the slower configurable search
+  staticSearch = SearchConfig::USE_STATIC_SEARCH && StaticSearchPolicy::matchesConfig();
+  LOG__DEBUG(Logger::get().SEARCH_LOG, "Search features: {}", staticSearch ? "static" : "runtime");
+  // same for the evaluation terms
+  pEvaluator->updatePolicy();
+  LOG__DEBUG(Logger::get().SEARCH_LOG, "Evaluation: {}", pEvaluator->isStatic() ? "static" : "runtime");
+
   Depth iterationDepth = searchLimitsPtr->getStartDepth();
 
   // generate all legal root moves
   rootMoves = generateRootMoves(position);
+  searchStats.rootMoveNodes.assign(rootMoves.size(), 0);
 
   // add some extra time for the move after the last book move
   if (hadBookMove && searchLimitsPtr->isTimeControl()) {
@@ -340,6 +361,7 @@ SearchResult Search::iterativeDeepening(Position &position) {
   Value bestValue = VALUE_NONE;
   bestRootMove = MOVE_NONE;
   bestRootMoveValue = VALUE_NONE;
+  Value lastIterationValue = VALUE_NONE;
 
   // check search requirements
   assert(!rootMoves.empty() && "No root moves to search");
@@ -357,6 +379,9 @@ SearchResult Search::iterativeDeepening(Position &position) {
     }
     searchStats.bestMoveChanges = 0;
     searchStats.nodesVisited++;
+    const uint64_t iterationStartNodes = searchStats.nodesVisited;
+    // node counts of this iteration only - including aspiration re-searches
+    std::fill(searchStats.rootMoveNodes.begin(), searchStats.rootMoveNodes.end(), 0);
 
     // protect the TT from being resized or cleared during search
     tt_lock.lock();
@@ -364,7 +389,7 @@ SearchResult Search::iterativeDeepening(Position &position) {
     // ###########################################
     // ### CALL SEARCH for iterationDepth
     if (searchLimitsPtr->isPerft()) {
-      search<PERFT, PV>(position, iterationDepth, PLY_ROOT, alpha, beta, Do_Null_Move);
+      searchRoot<PERFT>(position, iterationDepth, alpha, beta);
     }
     else {
       if (SearchConfig::USE_ASPIRATION_WINDOW // ASPIRATION
@@ -374,7 +399,7 @@ SearchResult Search::iterativeDeepening(Position &position) {
         bestValue = aspiration_search(position, iterationDepth, bestValue);
       }
       else { // ALPHA_BETA
-        bestValue = search<ROOT, PV>(position, iterationDepth, PLY_ROOT, alpha, beta, Do_Null_Move);
+        bestValue = searchRoot<ROOT>(position, iterationDepth, alpha, beta);
       }
     }
     // ###########################################
@@ -384,7 +409,7 @@ SearchResult Search::iterativeDeepening(Position &position) {
 
     // sort root moves based on value for the next iteration
     if (!stopConditions()) {
-      std::stable_sort(rootMoves.begin(), rootMoves.end(), rootMovesSort);
+      sortRootMoves();
       bestRootMove = rootMoves[0];
       bestRootMoveValue = valueOf(rootMoves[0]);
       if (bestValue != bestRootMoveValue) {
@@ -395,6 +420,13 @@ SearchResult Search::iterativeDeepening(Position &position) {
     // update UCI GUI
     sendIterationEndInfoToEngine();
 
+    // stop early if another iteration is not worth the time
+    if (!stopConditions()
+        && softTimeLimitReached(searchStats.nodesVisited - iterationStartNodes, lastIterationValue)) {
+      _stopSearchFlag = true;
+    }
+    lastIterationValue = bestRootMoveValue;
+
     LOG__TRACE(Logger::get().SEARCH_LOG, "Iteration Depth={} END", iterationDepth);
 
   } while (++iterationDepth <= searchLimitsPtr->getMaxDepth() && !stopConditions());
@@ -433,6 +465,79 @@ SearchResult Search::iterativeDeepening(Position &position) {
   return searchResult;
 }
 
+SearchResult Search::mateSearch(Position &position) {
+  // positions without legal moves are handled by iterativeDeepening
+  if (!MoveGenerator::hasLegalMove(position)) {
+    return iterativeDeepening(position);
+  }
+
+  if (!pMateSolver) {
+    pMateSolver = std::make_unique<MateSolver>(SearchConfig::MATE_SOLVER_SIZE_MB);
+  }
+
+  LOG__INFO(Logger::get().SEARCH_LOG, "Mate solver searching mate in {} in position: {}", searchLimitsPtr->getMate(), position.printFen());
+
+  // stopConditions() only stops when we have a best move - use any legal
+  // move until the solver has found a mate
+  rootMoves = generateRootMoves(position);
+  pv[PLY_ROOT] = {rootMoves.front()};
+
+  // with time control the solver only gets a share of the time and the
+  // normal search continues with the rest if no mate has been found
+  const auto solverTimeLimit = searchLimitsPtr->isTimeControl()
+                               ? static_cast<MilliSec>(timeLimit * SearchConfig::MATE_SOLVER_TIME_SHARE) : 0;
+
+  // protect the mate solver table from being cleared during search
+  tt_lock.lock();
+  const Value value = pMateSolver->solve(position, searchLimitsPtr->getMate(), [&] {
+    searchStats.nodesVisited++;
+    return stopConditions() || (solverTimeLimit && elapsedTime(startTime) >= solverTimeLimit);
+  });
+  tt_lock.unlock();
+
+  if (value == VALUE_NONE || pMateSolver->getPV().empty()) {
+    if (stopConditions()) {
+      // stopped without a mate and without time for a normal search - the
+      // move from the TT if there is one or any legal move and no score
+      const TT::Entry* ttEntryPtr = tt->probe(position.getZobristKey());
+      const Move ttMove = ttEntryPtr ? moveOf(ttEntryPtr->move) : MOVE_NONE;
+      const bool ttMoveLegal = std::any_of(rootMoves.begin(), rootMoves.end(),
+                                           [&](Move m) { return moveOf(m) == ttMove; });
+      SearchResult searchResult;
+      searchResult.bestMove = ttMove != MOVE_NONE && ttMoveLegal ? ttMove : moveOf(rootMoves.front());
+      searchResult.bestMoveValue = VALUE_NONE;
+      searchResult.time = elapsedTime(startTime);
+      searchStats.lastSearchTime = searchResult.time;
+      LOG__INFO(Logger::get().SEARCH_LOG, "Mate solver stopped without a result for mate in {} ({:n} nodes)",
+                searchLimitsPtr->getMate(), pMateSolver->getNodes());
+      return searchResult;
+    }
+    LOG__INFO(Logger::get().SEARCH_LOG, "Mate solver {} mate in {} ({:n} nodes) - starting normal search",
+              pMateSolver->wasAborted() ? "found no mate in its time for" : "found no", searchLimitsPtr->getMate(), pMateSolver->getNodes());
+    pv[PLY_ROOT].clear();
+    return iterativeDeepening(position);
+  }
+
+  // update search state and send the result to the UCI GUI
+  pv[PLY_ROOT] = pMateSolver->getPV();
+  bestRootMove = pv[PLY_ROOT].front();
+  setValue(bestRootMove, value);
+  bestRootMoveValue = value;
+  searchStats.currentSearchDepth = static_cast<Ply>(VALUE_CHECKMATE - value);
+  searchStats.currentExtraSearchDepth = static_cast<Ply>(VALUE_CHECKMATE - value);
+  sendIterationEndInfoToEngine();
+
+  SearchResult searchResult;
+  searchResult.bestMove = bestRootMove;
+  searchResult.bestMoveValue = value;
+  searchResult.ponderMove = pv[PLY_ROOT].size() > 1 ? pv[PLY_ROOT][1] : MOVE_NONE;
+  searchResult.depth = searchStats.currentSearchDepth;
+  searchResult.extraDepth = searchStats.currentExtraSearchDepth;
+  searchResult.time = elapsedTime(startTime);
+  searchStats.lastSearchTime = searchResult.time;
+  return searchResult;
+}
+
 Value Search::aspiration_search(Position &position, Depth depth, Value bestValue) {
   LOG__TRACE(Logger::get().SEARCH_LOG, "Aspiration for depth {}: START", depth);
   assert(bestValue != VALUE_NONE);
@@ -444,7 +549,7 @@ Value Search::aspiration_search(Position &position, Depth depth, Value bestValue
   Value alpha = std::max(VALUE_MIN, bestValue - 30);
   Value beta = std::min(VALUE_MAX, bestValue + 30);
   LOG__TRACE(Logger::get().SEARCH_LOG, "Aspiration for depth {}: START 1st window {}/{} (bestValue={})", depth, alpha, beta, bestValue);
-  value = search<ROOT, PV>(position, depth, PLY_ROOT, alpha, beta, Do_Null_Move);
+  value = searchRoot<ROOT>(position, depth, alpha, beta);
   // ##########################################################
 
   // if search has been stopped and value has missed window return current best value
@@ -463,7 +568,7 @@ Value Search::aspiration_search(Position &position, Depth depth, Value bestValue
     addExtraTime(1.3);
     alpha = std::max(VALUE_MIN, bestValue - 200);
     LOG__TRACE(Logger::get().SEARCH_LOG, "Aspiration for depth {}: START 2nd window {}/{}", depth, alpha, beta);
-    value = search<ROOT, PV>(position, depth, PLY_ROOT, alpha, beta, Do_Null_Move);
+    value = searchRoot<ROOT>(position, depth, alpha, beta);
   }
     // FAIL HIGH - increase upper bound
   else if (value >= beta) {
@@ -472,7 +577,7 @@ Value Search::aspiration_search(Position &position, Depth depth, Value bestValue
     searchStats.aspirationResearches++;
     beta = std::min(VALUE_MAX, bestValue + 200);
     LOG__TRACE(Logger::get().SEARCH_LOG, "Aspiration for depth {}: START 2nd window {}/{}", depth, alpha, beta);
-    value = search<ROOT, PV>(position, depth, PLY_ROOT, alpha, beta, Do_Null_Move);
+    value = searchRoot<ROOT>(position, depth, alpha, beta);
   }
   // ##########################################################
 
@@ -494,7 +599,7 @@ Value Search::aspiration_search(Position &position, Depth depth, Value bestValue
     alpha = VALUE_MIN;
     beta = VALUE_MAX;
     LOG__TRACE(Logger::get().SEARCH_LOG, "Aspiration for depth {}: START 3rd window {}/{}", depth, alpha, beta);
-    value = search<ROOT, PV>(position, depth, PLY_ROOT, alpha, beta, Do_Null_Move);
+    value = searchRoot<ROOT>(position, depth, alpha, beta);
   }
   // ##########################################################
 
@@ -503,12 +608,19 @@ Value Search::aspiration_search(Position &position, Depth depth, Value bestValue
   return stopConditions() ? bestValue : value;
 }
 
+template<Search::Search_Type ST>
+inline Value Search::searchRoot(Position &position, Depth depth, Value alpha, Value beta) {
+  return staticSearch
+         ? search<ST, PV, StaticSearchPolicy>(position, depth, PLY_ROOT, alpha, beta, Do_Null_Move)
+         : search<ST, PV, RuntimeSearchPolicy>(position, depth, PLY_ROOT, alpha, beta, Do_Null_Move);
+}
+
 /**
  * This is the templated search function for root, non-root and quiescence
  * searches. Through the template the compiler will generate specialized
  * versions of this method for each case.
  */
-template<Search::Search_Type ST, Search::Node_Type NT>
+template<Search::Search_Type ST, Search::Node_Type NT, class SP>
 Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
                      Value beta, Do_Null doNull) {
 
@@ -523,8 +635,8 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
     case ROOT: // fall through
     case NONROOT:
       if (depth <= DEPTH_NONE || ply >= PLY_MAX - 1) {
-        if (SearchConfig::USE_QUIESCENCE) {
-          return search<QUIESCENCE, NT>(position, depth, ply, alpha, beta, doNull);
+        if (SP::USE_QUIESCENCE) {
+          return search<QUIESCENCE, NT, SP>(position, depth, ply, alpha, beta, doNull);
         }
         else {
           Value eval = evaluate(position);
@@ -538,7 +650,7 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
       // limit max quiescence depth
       if (ply > static_cast<Ply>(currentIterationDepth + SearchConfig::MAX_EXTRA_QDEPTH)
           || ply >= PLY_MAX - 1) {
-        Value eval = evaluate(position);
+        Value eval = evaluate(position, alpha, beta);
         LOG__TRACE(Logger::get().SEARCH_LOG, "{:>{}} Evaluation: {} {}", "", ply, printMoveListUCI(currentVariation), eval);
         return eval;
       }
@@ -555,11 +667,55 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
       }
   }
 
+  // ###############################################
+  // Upcoming Repetition
+  // If we can repeat a position the value of this
+  // node is at least a draw.
+  if (SP::USE_UPCOMING_REP
+      && ST != ROOT && ST != PERFT
+      && alpha < VALUE_DRAW
+      && position.hasUpcomingRepetition(ply)) {
+    alpha = VALUE_DRAW;
+    if (alpha >= beta) {
+      searchStats.upcomingRepetitionCuts++;
+      LOG__TRACE(Logger::get().SEARCH_LOG, "{:>{}}Search in ply {} for depth {}: UPCOMING REPETITION CUT", "", ply, ply, depth);
+      return alpha;
+    }
+  }
+  // ###############################################
+
+  // ###############################################
+  // Material Draws and KPK Bitbase
+  // Positions where neither side can mate at all are
+  // draws (KNNK is not cut here as a mate can still
+  // happen if the defender errs). King+Pawn vs. King positions
+  // are either won or drawn. Drawn positions don't
+  // need to be searched. Won positions are scored by
+  // the evaluator.
+  if (ST != ROOT && ST != PERFT) {
+    const Material::Entry* const material = position.getMaterialEntry();
+    if (SP::USE_MATERIAL_DRAW
+        && material->draw != Material::DRAW_NONE
+        && position.checkDeadMaterial()) {
+      searchStats.materialDraws++;
+      LOG__TRACE(Logger::get().SEARCH_LOG, "{:>{}}Search in ply {} for depth {}: INSUFFICIENT MATERIAL DRAW", "", ply, ply, depth);
+      return VALUE_DRAW;
+    }
+    if (SP::USE_KPK_BITBASE
+        && material->endgame == Material::ENDGAME_KPK
+        && !Bitbase::probeKPK(position)) {
+      searchStats.bitbaseDraws++;
+      LOG__TRACE(Logger::get().SEARCH_LOG, "{:>{}}Search in ply {} for depth {}: KPK BITBASE DRAW", "", ply, ply, depth);
+      return VALUE_DRAW;
+    }
+  }
+  // ###############################################
+
   // ###############################################
   // Mate Distance Pruning
   // Did we already find a shorter mate then ignore
   // this one.
-  if (SearchConfig::USE_MDP && ST != ROOT && ST != PERFT) {
+  if (SP::USE_MDP && ST != ROOT && ST != PERFT) {
     if (alpha < -VALUE_CHECKMATE + ply) { alpha = -VALUE_CHECKMATE + ply; }
     if (beta > VALUE_CHECKMATE - ply) { beta = VALUE_CHECKMATE - ply; }
     if (alpha >= beta) {
@@ -583,8 +739,8 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
   // ###############################################
   // TT Lookup
   const TT::Entry* ttEntryPtr = nullptr;
-  if (SearchConfig::USE_TT &&
-      (SearchConfig::USE_TT_QSEARCH || ST != QUIESCENCE)
+  if (SP::USE_TT &&
+      (SP::USE_TT_QSEARCH || ST != QUIESCENCE)
       && ST != PERFT
       && ST != ROOT
     ) {
@@ -647,10 +803,26 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
   // ###############################################
 
   // if we are not in check we allow prunings and search tree reductions
+  Value staticEval = VALUE_NONE;
+  // a lazy evaluation is only a bound and must not be stored in the TT
+  bool lazyEval = false;
   if (!position.hasCheck() && ST != PERFT) {
 
     // get an evaluation for the position
-    Value staticEval = evaluate(position);
+    // reuse the static evaluation stored in the TT by an earlier visit
+    if (SP::USE_TT_EVAL && ttEntryPtr && ttEntryPtr->eval != VALUE_NONE) {
+      staticEval = ttEntryPtr->eval;
+      searchStats.ttEvalHits++;
+    }
+    // quiescence only needs to know if the stand pat is outside of the
+    // window which allows a lazy evaluation
+    else if (ST == QUIESCENCE) {
+      staticEval = evaluate(position, alpha, beta);
+      lazyEval = pEvaluator->wasLazy();
+    }
+    else {
+      staticEval = evaluate(position);
+    }
 
     // ###############################################
     // Quiescence StandPat
@@ -658,13 +830,13 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
     // https://www.chessprogramming.org/Quiescence_Search#Standing_Pat
     // Assumption is that there is at least on move which would improve the
     // current position. So if we are already >beta we don't need to look at it.
-    if (SearchConfig::USE_QS_STANDPAT_CUT
+    if (SP::USE_QS_STANDPAT_CUT
         && ST == QUIESCENCE
       ) {
       if (staticEval >= beta) {
-        if (SearchConfig::USE_TT_QSEARCH) {
+        if (SP::USE_TT_QSEARCH) {
           storeTT(position, staticEval, TYPE_BETA, DEPTH_NONE, ply, MOVE_NONE,
-                  mateThreat[ply]);
+                  mateThreat[ply], lazyEval ? VALUE_NONE : staticEval);
         }
         LOG__TRACE(Logger::get().SEARCH_LOG, "{:>{}}Quiescence in ply {}: STANDPAT CUT ({} > {} beta)", "", ply, ply, staticEval, beta);
         searchStats.qStandpatCuts++;
@@ -686,7 +858,7 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
     // https://www.chessprogramming.org/Reverse_Futility_Pruning
     // Anticipate likely alpha low in the next ply by a beta cut
     // off before making and evaluating the move
-    if (SearchConfig::USE_RFP
+    if (SP::USE_RFP
         && NT == NonPV
         && ST == NONROOT
       ) {
@@ -711,7 +883,7 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
     // - in check - this would lead to an illegal situation where the king is
     // captured
     // - recursive null moves should be avoided
-    if (SearchConfig::USE_NMP && ply > 1        // start with my color
+    if (SP::USE_NMP && ply > 1        // start with my color
         && NT == NonPV
         && depth >= SearchConfig::NMP_DEPTH     // don't do it too close to leaf nodes
         && doNull                               // don't do recursive null moves
@@ -724,16 +896,16 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
       // do a null move search with a null window
       position.doNullMove();
       Value nullValue =
-        -search<NONROOT, NonPV>(position, newDepth, ply + 1, -beta, -beta + 1, No_Null_Move);
+        -search<NONROOT, NonPV, SP>(position, newDepth, ply + 1, -beta, -beta + 1, No_Null_Move);
       position.undoNullMove();
 
-      if (SearchConfig::NMP_VERIFICATION
+      if (SP::NMP_VERIFICATION
           && depth > SearchConfig::NMP_V_REDUCTION
           && nullValue >= beta) {
         searchStats.nullMoveVerifications++;
         newDepth = depth - SearchConfig::NMP_V_REDUCTION;
         // confirm >beta by doing a shallow normal search on the position
-        nullValue = search<NONROOT, PV>(position, newDepth, ply, alpha, beta, No_Null_Move);
+        nullValue = search<NONROOT, PV, SP>(position, newDepth, ply, alpha, beta, No_Null_Move);
       }
 
       // Check for mate threat and do not return an unproven mate value
@@ -742,12 +914,60 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
       if (nullValue >= beta) { // cut off node
         searchStats.nullMovePrunings++;
         LOG__TRACE(Logger::get().SEARCH_LOG, "{:>{}}Search in ply {} for depth {}: NULL CUT", "", ply, ply, depth);
-        storeTT(position, nullValue, TYPE_BETA, newDepth, ply, MOVE_NONE, mateThreat[ply]);
+        storeTT(position, nullValue, TYPE_BETA, newDepth, ply, MOVE_NONE, mateThreat[ply], staticEval);
         return nullValue;
       }
     }
     // ###############################################
 
+    // ###############################################
+    // PROBCUT
+    // https://www.chessprogramming.org/ProbCut
+    // If a good capture fails high against a raised beta
+    // in a reduced search we assume that a full depth
+    // search would fail high against beta as well.
+    // Only captures whose SEE already reaches the raised
+    // beta from the static eval are tried. Each is first
+    // verified by quiescence search and then by the
+    // reduced search.
+    if (SP::USE_PROBCUT
+        && NT == NonPV
+        && ST == NONROOT
+        && depth >= SearchConfig::PROBCUT_DEPTH
+        && !isCheckMateValue(beta)
+      ) {
+      const Value probCutBeta = std::min(VALUE_CHECKMATE_THRESHOLD - 1, beta + SearchConfig::PROBCUT_MARGIN);
+      const Depth probCutDepth = depth - SearchConfig::PROBCUT_REDUCTION;
+      Move move;
+      while ((move = moveGenerators[ply].getNextPseudoLegalMove<MoveGenerator::GENCAP>(position)) != MOVE_NONE) {
+        if (position.see(move) < probCutBeta - staticEval) continue;
+        position.doMove(move);
+        if (!position.isLegalPosition()) {
+          position.undoMove();
+          continue;
+        }
+        searchStats.probCutTries++;
+        searchStats.nodesVisited++;
+        currentVariation.push_back(move);
+        Value probCutValue = -search<QUIESCENCE, NonPV, SP>(position, DEPTH_NONE, ply + 1, -probCutBeta, -probCutBeta + 1, Do_Null_Move);
+        if (probCutValue >= probCutBeta) {
+          probCutValue = -search<NONROOT, NonPV, SP>(position, probCutDepth, ply + 1, -probCutBeta, -probCutBeta + 1, Do_Null_Move);
+        }
+        currentVariation.pop_back();
+        position.undoMove();
+        if (stopConditions()) { return VALUE_NONE; }
+        if (probCutValue >= probCutBeta) {
+          searchStats.probCutPrunings++;
+          LOG__TRACE(Logger::get().SEARCH_LOG, "{:>{}}Search in ply {} for depth {}: PROBCUT CUT", "", ply, ply, depth);
+          storeTT(position, probCutValue, TYPE_BETA, probCutDepth + DEPTH_ONE, ply, move, mateThreat[ply], staticEval);
+          return probCutValue;
+        }
+      }
+      // the move generator is used again in the move loop
+      moveGenerators[ply].resetOnDemand();
+    }
+    // ###############################################
+
   } // not check and not perft
   // ###############################################
 
@@ -757,7 +977,7 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
   // ###############################################
   // PV MOVE SORT
   // make sure the pv move is returned first by the move generator
-  if (SearchConfig::USE_PV_MOVE_SORT && ST != ROOT && ST != PERFT) {
+  if (SP::USE_PV_MOVE_SORT && ST != ROOT && ST != PERFT) {
     if (ttMove != MOVE_NONE) {
       assert(moveGenerators[ply].validateMove(position, ttMove));
       moveGenerators[ply].setPV(ttMove);
@@ -795,7 +1015,7 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
     // Skip non queen or knight promotion as they are
     // redundant. Exception would be stale mate situations
     // which we ignore.
-    if (SearchConfig::USE_MPP
+    if (SP::USE_MPP
         && ST != ROOT
         && ST != PERFT
         && typeOf(move) == PROMOTION
@@ -810,7 +1030,7 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
     // ###############################################
     // EXTENSIONS
     Depth extension = DEPTH_NONE;
-    if (SearchConfig::USE_EXTENSIONS
+    if (SP::USE_EXTENSIONS
         && ST != QUIESCENCE
         && ST != PERFT
         && depth <= DEPTH_PRE_FRONTIER // to limit search extensions and avoid search explosion
@@ -863,7 +1083,7 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
       // ###############################################
       // Extended Futility Pruning
       // http://people.csail.mit.edu/heinz/dt/node25.html
-      if (SearchConfig::USE_EFP
+      if (SP::USE_EFP
           && depth == DEPTH_PRE_FRONTIER
         ) {
         const Value testValue = gainedValue + SearchConfig::EFP_MARGIN;
@@ -887,7 +1107,7 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
       // Futility margin is the margin by that a move can
       // increase the value of a position by positional
       // evaluations only (without material difference)
-      if (SearchConfig::USE_FP
+      if (SP::USE_FP
           && depth == DEPTH_FRONTIER
         ) {
         Value testValue = gainedValue + SearchConfig::FP_MARGIN;
@@ -904,7 +1124,7 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
 
       // ###############################################
       // Late Move Reduction
-      if (SearchConfig::USE_LMR
+      if (SP::USE_LMR
           && NT == NonPV
           && depth >= SearchConfig::LMR_MIN_DEPTH
           && movesSearched >= SearchConfig::LMR_MIN_MOVES
@@ -922,6 +1142,7 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
 
     // ###############################################
     // Execute move
+    const uint64_t nodesBeforeMove = searchStats.nodesVisited;
     position.doMove(move);
 
     // if available on platform tells the cpu to
@@ -957,18 +1178,18 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
       // in quiescence we do not have depth any more
       if (ST == QUIESCENCE || newDepth < DEPTH_NONE) newDepth = DEPTH_NONE;
 
-      if (!SearchConfig::USE_PVS || movesSearched == 0 || ST == PERFT) {
+      if (!SP::USE_PVS || movesSearched == 0 || ST == PERFT) {
         // AlphaBeta Search or initial search in PVS
-        value = -search<nextST, PV>(position, newDepth, ply + 1, -beta, -alpha, doNull);
+        value = -search<nextST, PV, SP>(position, newDepth, ply + 1, -beta, -alpha, doNull);
       }
       else {
         // #############################
         // PVS Search /START
-        value = -search<nextST, NonPV>(position, newDepth, ply + 1, -alpha - 1, -alpha, doNull);
+        value = -search<nextST, NonPV, SP>(position, newDepth, ply + 1, -alpha - 1, -alpha, doNull);
         if (value > alpha && value < beta && !stopConditions()) {
           if (ST == ROOT) { searchStats.pvs_root_researches++; }
           else { searchStats.pvs_researches++; }
-          value = -search<nextST, PV>(position, newDepth, ply + 1, -beta, -alpha, doNull);
+          value = -search<nextST, PV, SP>(position, newDepth, ply + 1, -beta, -alpha, doNull);
         }
         else {
           if (ST == ROOT) { searchStats.pvs_root_cutoffs++; }
@@ -993,6 +1214,7 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
     // For root moves encode value into the move
     // so we can sort the move before the next iteration
     if (ST == ROOT) {
+      searchStats.rootMoveNodes[currentMoveIndex] += searchStats.nodesVisited - nodesBeforeMove;
       setValue(rootMoves.at(currentMoveIndex++), value);
     }
 
@@ -1012,7 +1234,7 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
       bestNodeValue = value;
 
       // AlphaBeta
-      if (SearchConfig::USE_ALPHABETA) {
+      if (SP::USE_ALPHABETA) {
 
         /*
         Did we find a better move than in previous nodes in ply
@@ -1048,7 +1270,7 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
            earlier in another node of the ply.
           */
           if (value >= beta) {
-            if (SearchConfig::USE_KILLER_MOVES && !position.isCapturingMove(move)) {
+            if (SP::USE_KILLER_MOVES && !position.isCapturingMove(move)) {
               moveGenerators[ply].storeKiller(move, SearchConfig::NO_KILLER_MOVES);
             }
             searchStats.prunings++;
@@ -1094,7 +1316,7 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
 
   // do some checks
   ASSERT_START
-    if (ST != PERFT && SearchConfig::USE_ALPHABETA) {
+    if (ST != PERFT && SP::USE_ALPHABETA) {
       // In an EXACT node we should have a best move and a PV
       if (ttType == TYPE_EXACT) {
         assert(ttStoreMove);
@@ -1165,15 +1387,15 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
   // store TT data
   switch (ST) {
     case NONROOT:
-      if (SearchConfig::USE_TT) {
+      if (SP::USE_TT) {
         LOG__TRACE(Logger::get().SEARCH_LOG, "{:>{}}Search storing into TT: {} {} {} {} {} {} {}", "", ply, position.getZobristKey(), bestNodeValue, TT::str(ttType), depth, printMove(ttStoreMove), false, position.printFen());
-        storeTT(position, bestNodeValue, ttType, depth, ply, ttStoreMove, mateThreat[ply]);
+        storeTT(position, bestNodeValue, ttType, depth, ply, ttStoreMove, mateThreat[ply], staticEval);
       }
       break;
     case QUIESCENCE:
-      if (SearchConfig::USE_TT && SearchConfig::USE_TT_QSEARCH) {
+      if (SP::USE_TT && SP::USE_TT_QSEARCH) {
         LOG__TRACE(Logger::get().SEARCH_LOG, "{:>{}}Quiescence storing into TT: {} {} {} {} {} {} {}", "", ply, position.getZobristKey(), bestNodeValue, TT::str(ttType), depth, printMove(ttStoreMove), false, position.printFen());
-        storeTT(position, bestNodeValue, ttType, DEPTH_NONE, ply, ttStoreMove, mateThreat[ply]);
+        storeTT(position, bestNodeValue, ttType, DEPTH_NONE, ply, ttStoreMove, mateThreat[ply], lazyEval ? VALUE_NONE : staticEval);
       }
       break;
     case ROOT: // no TT storing in root
@@ -1184,7 +1406,7 @@ Value Search::search(Position &position, Depth depth, Ply ply, Value alpha,
   return bestNodeValue;
 }
 
-Value Search::evaluate(Position &position) {
+Value Search::evaluate(Position &position, Value alpha, Value beta) {
   // count all leaf nodes evaluated
   searchStats.leafPositionsEvaluated++;
 
@@ -1199,7 +1421,9 @@ Value Search::evaluate(Position &position) {
     return VALUE_ONE;
   }
 
-  return pEvaluator->evaluate(position);
+  const Value value = pEvaluator->evaluate(position, alpha, beta);
+  if (pEvaluator->wasLazy()) searchStats.lazyEvaluations++;
+  return value;
 }
 
 /**
@@ -1282,7 +1506,7 @@ bool Search::goodCapture(Position &position, Move move) {
 }
 
 inline void Search::storeTT(Position &position, Value value, Value_Type ttType,
-                            Depth depth, Ply ply, Move move, bool _mateThreat) {
+                            Depth depth, Ply ply, Move move, bool _mateThreat, Value staticEval) {
 
   if (!SearchConfig::USE_TT || searchLimitsPtr->isPerft() || _stopSearchFlag) {
     return;
@@ -1294,7 +1518,7 @@ inline void Search::storeTT(Position &position, Value value, Value_Type ttType,
   // correct the value for mate distance and remove the value from the move to
   // later be able to easier compare it wh read from TT
   tt->put(position.getZobristKey(), depth, move, valueToTT(value, ply),
-          ttType, _mateThreat);
+          ttType, staticEval, _mateThreat);
 }
 
 inline Value Search::valueToTT(Value value, Ply ply) {
@@ -1333,6 +1557,9 @@ inline bool Search::stopConditions() {
   if (_stopSearchFlag) {
     return true;
   }
+  if (nodeTimeCheck && searchStats.nodesVisited >= nextTimeCheckNodes) {
+    checkTime();
+  }
   if (searchLimitsPtr->getNodes() && searchStats.nodesVisited >= searchLimitsPtr->getNodes()) {
     LOG__INFO(Logger::get().SEARCH_LOG, "Stop Flag - stopping search");
     _stopSearchFlag = true;
@@ -1384,7 +1611,51 @@ void Search::addExtraTime(const double d) {
   }
 }
 
+bool Search::softTimeLimitReached(const uint64_t iterationNodes, const Value lastValue) {
+  if (!SearchConfig::USE_SOFT_TIME_LIMIT
+      || !searchLimitsPtr->isTimeControl()
+      || searchLimitsPtr->getMoveTime()) {
+    return false;
+  }
+
+  double factor = 1.0;
+
+  // the first best move in an iteration is always counted as change
+  if (searchStats.bestMoveChanges > 1) {
+    factor *= 1.0 + SearchConfig::TIME_BEST_MOVE_CHANGE_FACTOR * (searchStats.bestMoveChanges - 1);
+  }
+
+  // the value dropped since the last iteration
+  if (lastValue != VALUE_NONE && bestRootMoveValue < lastValue - SearchConfig::TIME_SCORE_DROP_MARGIN) {
+    factor *= SearchConfig::TIME_SCORE_DROP_FACTOR;
+  }
+
+  // most nodes spent on the best move usually means an obvious move
+  const double nodeShare = iterationNodes ? static_cast<double>(searchStats.rootMoveNodes.front()) / iterationNodes : 0.0;
+  factor *= SearchConfig::TIME_NODE_SHARE_BASE - nodeShare;
+
+  const MilliSec hardTimeLimit = timeLimit + extraTime;
+  softTimeLimit = std::min(hardTimeLimit, static_cast<MilliSec>(hardTimeLimit * SearchConfig::SOFT_TIME_RATIO * factor));
+  const MilliSec elapsed = elapsedTime(startTime);
+  LOG__DEBUG(Logger::get().SEARCH_LOG, "Soft time limit {:n} ms (factor {:.2f}, best move changes {}, node share {:.2f}), elapsed {:n} ms", softTimeLimit, factor, searchStats.bestMoveChanges, nodeShare, elapsed);
+  if (elapsed >= softTimeLimit) {
+    LOG__INFO(Logger::get().SEARCH_LOG, "Stop search by soft time limit after wall time: {:n} ms (soft time limit {:n} ms)", elapsed, softTimeLimit);
+    return true;
+  }
+  return false;
+}
+
 void Search::startTimer() {
+  if (SearchConfig::USE_NODE_TIME_CHECK) {
+    LOG__DEBUG(Logger::get().SEARCH_LOG, "Node based time check started with time limit of {:n} ms", timeLimit);
+    // might be called from the UCI thread (ponderhit) - the search thread
+    // does not change nextTimeCheckNodes while nodeTimeCheck is false and
+    // picks up the restart with the immediate next check
+    timerRestarted = true;
+    nextTimeCheckNodes = 0;
+    nodeTimeCheck = true;
+    return;
+  }
   this->timerThread = std::thread([&] {
     LOG__DEBUG(Logger::get().SEARCH_LOG, "Timer started with time limit of {:n} ms", timeLimit);
     // relaxed busy wait
@@ -1396,6 +1667,22 @@ void Search::startTimer() {
   });
 }
 
+void Search::checkTime() {
+  searchStats.timeChecks++;
+  if (timerRestarted.exchange(false)) nodesAtTimerStart = searchStats.nodesVisited;
+  const MilliSec elapsed = elapsedTime(startTime);
+  if (elapsed >= timeLimit + extraTime) {
+    nodeTimeCheck = false;
+    _stopSearchFlag = true;
+    LOG__INFO(Logger::get().SEARCH_LOG, "Stop search by node time check after wall time: {:n} ms (time limit {:n} ms and extra time {:n})", elapsed, timeLimit, extraTime);
+    return;
+  }
+  // adapt the number of nodes until the next check to the current nps
+  const uint64_t nodesPerInterval = getNps() * SearchConfig::TIME_CHECK_INTERVAL / 1'000;
+  const uint64_t interval = std::clamp(nodesPerInterval, SearchConfig::TIME_CHECK_MIN_NODES, SearchConfig::TIME_CHECK_MAX_NODES);
+  nextTimeCheckNodes = searchStats.nodesVisited + interval;
+}
+
 inline MilliSec Search::elapsedTime(const MilliSec t) {
   return elapsedTime(t, now());
 }
@@ -1409,7 +1696,7 @@ inline MilliSec Search::now() {
   // this C function is much faster than c++ chrono
 return clock_gettime_nsec_np(CLOCK_UPTIME_RAW_APPROX) / 1'000'000;
 #else
-  const std::chrono::time_point timePoint = std::chrono::high_resolution_clock::now();
+  const std::chrono::time_point timePoint = std::chrono::steady_clock::now();
   const std::chrono::duration timeSinceEpoch
     = std::chrono::duration_cast<std::chrono::milliseconds>(timePoint.time_since_epoch());
   return timeSinceEpoch.count();
@@ -1417,7 +1704,7 @@ return clock_gettime_nsec_np(CLOCK_UPTIME_RAW_APPROX) / 1'000'000;
 }
 
 inline uint64_t Search::getNps() const {
-  return 1000 * searchStats.nodesVisited / (elapsedTime(startTime) + 1); // +1 to avoid division by zero};
+  return 1000 * (searchStats.nodesVisited - nodesAtTimerStart) / (elapsedTime(startTime) + 1); // +1 to avoid division by zero
 }
 
 inline void Search::savePV(Move move, MoveList &src, MoveList &dest) {
@@ -1470,11 +1757,43 @@ bool Search::rootMovesSort(Move m1, Move m2) {
   return (valueOf(m1) > valueOf(m2));
 }
 
+void Search::sortRootMoves() {
+  // sort moves and node counts together
+  std::vector<std::pair<Move, uint64_t>> moves{};
+  moves.reserve(rootMoves.size());
+  for (MoveList::size_type i = 0; i < rootMoves.size(); i++) {
+    moves.emplace_back(rootMoves[i], searchStats.rootMoveNodes[i]);
+  }
+
+  if (SearchConfig::USE_ROOT_MOVE_NODE_SORT) {
+    // best move first - the first move with the highest value
+    const auto best = std::max_element(moves.begin(), moves.end(), [](const auto &m1, const auto &m2) {
+      return valueOf(m1.first) < valueOf(m2.first);
+    });
+    std::rotate(moves.begin(), best, best + 1);
+    std::stable_sort(moves.begin() + 1, moves.end(), [](const auto &m1, const auto &m2) {
+      return m1.second > m2.second;
+    });
+  }
+  else {
+    std::stable_sort(moves.begin(), moves.end(), [](const auto &m1, const auto &m2) {
+      return rootMovesSort(m1.first, m2.first);
+    });
+  }
+
+  for (MoveList::size_type i = 0; i < moves.size(); i++) {
+    rootMoves[i] = moves[i].first;
+    searchStats.rootMoveNodes[i] = moves[i].second;
+  }
+}
+
 void Search::clearHash() {
   LOG__TRACE(Logger::get().SEARCH_LOG, "Search: Clear Hash command received!");
   std::chrono::milliseconds timeout(2500);
   if (tt_lock.try_lock_for(timeout)) {
     tt->clear();
+    if (pMateSolver) { pMateSolver->clear(); }
+    pEvaluator->clearEvalCache();
     tt_lock.unlock();
   }
   else {
@@ -1494,6 +1813,32 @@ void Search::setHashSize(int sizeInMB) {
   }
 }
 
+void Search::setMateSolverSize(int sizeInMB) {
+  LOG__TRACE(Logger::get().SEARCH_LOG, "Search: Set MateSolverSize to {} MB command received!", sizeInMB);
+  std::chrono::milliseconds timeout(2500);
+  if (tt_lock.try_lock_for(timeout)) {
+    SearchConfig::MATE_SOLVER_SIZE_MB = sizeInMB;
+    // created with the new size for the next mate search
+    pMateSolver.reset();
+    tt_lock.unlock();
+  }
+  else {
+    LOG__WARN(Logger::get().SEARCH_LOG, "Could not set mate solver size while searching.");
+  }
+}
+
+void Search::setEvalCacheSize(int sizeInMB) {
+  LOG__TRACE(Logger::get().SEARCH_LOG, "Search: Set EvalCacheSize to {} MB command received!", sizeInMB);
+  std::chrono::milliseconds timeout(2500);
+  if (tt_lock.try_lock_for(timeout)) {
+    pEvaluator->resizeEvalCache(sizeInMB);
+    tt_lock.unlock();
+  }
+  else {
+    LOG__WARN(Logger::get().SEARCH_LOG, "Could not set eval cache size while searching.");
+  }
+}
+
 void Search::sendIterationEndInfoToEngine() const {
   ASSERT_START
     if (pv[PLY_ROOT].empty()) {
@@ -1557,6 +1902,7 @@ void Search::sendSearchUpdateToEngine() {
 
     LOG__DEBUG(Logger::get().SEARCH_LOG, "Search statistics: {}", searchStats.str());
     LOG__DEBUG(Logger::get().SEARCH_LOG, "Eval   statistics: {}", pEvaluator->pawnTableStats());
+    LOG__DEBUG(Logger::get().SEARCH_LOG, "Eval   statistics: {}", pEvaluator->evalCacheStats());
     LOG__DEBUG(Logger::get().SEARCH_LOG, "TT     statistics: {}", tt->str());
 
     if (!pEngine) {
@@ -38,6 +38,7 @@
 #include "MoveGenerator.h"
 #include "gtest/gtest_prod.h"
 #include "OpeningBook.h"
+#include "MateSolver.h"
 
 // forward declared dependencies
 class Engine;
@@ -99,12 +100,25 @@ class Search {
   // transposition table (singleton)
   TT *tt{};
 
-    // search start time
-  MilliSec startTime{};
+    // search start time (reset by ponderhit from the UCI thread)
+  std::atomic<MilliSec> startTime{};
   MilliSec stopTime{};
   MilliSec timeLimit{};
   std::atomic_int64_t extraTime{};
 
+  // node based time checks - search polls the clock itself when the next
+  // check node count is reached
+  std::atomic_bool nodeTimeCheck = false;
+  std::atomic_uint64_t nextTimeCheckNodes{};
+  // set by startTimer() - the search thread then stores the node count of
+  // the timer start with its next time check so the nps for the check
+  // interval does not include the nodes searched while pondering
+  std::atomic_bool timerRestarted = false;
+  uint64_t nodesAtTimerStart{};
+
+  // soft time limit - checked after each iteration
+  MilliSec softTimeLimit{};
+
   // the color of the searching player
   Color myColor = NOCOLOR;
 
@@ -134,10 +148,16 @@ class Search {
   // Evaluator
   std::unique_ptr<Evaluator> pEvaluator;
 
+  // search features are compile time constants (see StaticSearchPolicy)
+  bool staticSearch = false;
+
   // opening book
   std::unique_ptr<OpeningBook> pOpeningBook;
   bool hadBookMove = false;
 
+  // proof number mate solver for mate searches (created on first use)
+  std::unique_ptr<MateSolver> pMateSolver;
+
 public:
   // for code re-using through templating we use search types when calling
   // search()
@@ -202,6 +222,12 @@ public:
   /** resize the hash to the given value in MB */
   void setHashSize(int sizeInMB);
 
+  /** resize the mate solver table to the given value in MB */
+  void setMateSolverSize(int sizeInMB);
+
+  /** resize the evaluator's eval cache to the given value in MB (0 = off) */
+  void setEvalCacheSize(int sizeInMB);
+
 private:
   ////////////////////////////////////////////////
   ///// PRIVATE
@@ -219,6 +245,13 @@ private:
    */
   SearchResult iterativeDeepening(Position &refPosition);
 
+  /**
+   * Searches for a mate with the proof number mate solver when the search
+   * limits ask for a mate search. Falls back to iterativeDeepening when no
+   * mate could be found.
+   */
+  SearchResult mateSearch(Position &position);
+
   /**
     * Aspiration search works with the assumption that the value from previous
     * searches will not change too much and therefore the search can be tried
@@ -236,13 +269,20 @@ private:
    * Template parameter node type will distinguish between PV and NonPV nodes
    * for PVS search.
    */
-  template <Search_Type ST, Node_Type NT>
+  template <Search_Type ST, Node_Type NT, class SP>
   Value search(Position &position, Depth depth, Ply ply, Value alpha, Value beta, Do_Null doNull);
 
+  /**
+   * Calls search() for the root node with the StaticSearchPolicy when
+   * staticSearch is set and with the RuntimeSearchPolicy otherwise.
+   */
+  template <Search_Type ST>
+  Value searchRoot(Position &position, Depth depth, Value alpha, Value beta);
+
   /**
    * Calculates an evaluation value for the given position
    */
-  Value evaluate(Position &position);
+  Value evaluate(Position &position, Value alpha = VALUE_MIN, Value beta = VALUE_MAX);
 
   /**
    * Returns true if we either have a 3-fold repetition ot have more than 100 reversible moves.
@@ -272,6 +312,15 @@ private:
    */
   static bool rootMovesSort(Move m1, Move m2);
 
+  /**
+   * Sorts the root moves after an iteration. The best move (highest value) is
+   * always first. If SearchConfig::USE_ROOT_MOVE_NODE_SORT is set the other
+   * moves are ordered by the number of nodes searched below them as their
+   * values are only bounds. Otherwise all moves are sorted by value.
+   * The node counts in searchStats.rootMoveNodes are kept in the same order.
+   */
+  void sortRootMoves();
+
   /**
    * Used to filter out only valuable captures in quiescence search.
    * Will be replaced by SEE in the future.
@@ -291,10 +340,11 @@ private:
   void getPVLine(Position &position, MoveList &pvRoot, Depth depth);
 
   /**
-   * Stores search result of a node to the transposition table
+   * Stores search result of a node to the transposition table together
+   * with the static evaluation of the node if available (VALUE_NONE otherwise)
    */
   void storeTT(Position &position, Value value, Value_Type ttType, Depth depth,
-               Ply ply, Move move, bool mateThreat);
+               Ply ply, Move move, bool mateThreat, Value staticEval);
 
   /**
    * correct any mate values which are sent to TT so that
@@ -326,12 +376,34 @@ private:
    */
   void addExtraTime(double d);
 
+  /**
+   * Checks after an iteration if we should not start another one. The soft
+   * time limit is a part of the hard time limit (timeLimit + extraTime)
+   * which is increased for unstable searches (best move changes, score drops)
+   * and reduced when most of the nodes have been spent on the best move.
+   * Expects sorted root moves with the best move first.
+   * @param iterationNodes nodes searched in the last iteration
+   * @param lastValue best value of the iteration before
+   * @return true if the soft time limit has been reached
+   */
+  bool softTimeLimitReached(uint64_t iterationNodes, Value lastValue);
+
   /**
    * Starts a thread which waits for the timeLimit + extraTime amount
    * of time and then sets the stopSearchFlag to true;
+   * If SearchConfig::USE_NODE_TIME_CHECK is set no thread is started but
+   * the search itself polls the clock every n nodes (see checkTime()).
    */
   void startTimer();
 
+  /**
+   * Called from stopConditions() every n nodes when node based time checks
+   * are used. Sets the stopSearchFlag when the time is up and otherwise
+   * adapts n to the current nps so that the clock is polled about every
+   * SearchConfig::TIME_CHECK_INTERVAL ms.
+   */
+  void checkTime();
+
   /**
    * @param t time point since the elapsed time
    * @return the elapsed time from the start of the search to the given t
@@ -352,7 +424,8 @@ private:
   static inline MilliSec now();
 
   /**
-   * Returns the current nodes per second value
+   * Returns the current nodes per second value counting the nodes since
+   * the start of the timer (see startTimer())
    */
   inline uint64_t getNps() const;
 
@@ -372,6 +445,11 @@ private:
 
   FRIEND_TEST(SearchTest, goodCapture);
   FRIEND_TEST(SearchTest, timerTest);
+  FRIEND_TEST(SearchTest, lazyEval);
+  FRIEND_TEST(SearchTest, staticSearch);
+  FRIEND_TEST(SearchTest, pawnTable);
+  FRIEND_TEST(SearchTest, evalCache);
+  FRIEND_TEST(PerformanceTests, SearchFeatures_NPS);
 };
 
 #endif // FRANKYCPP_SEARCH_H
@@ -38,6 +38,22 @@ namespace SearchConfig {
   inline std::string             BOOK_PATH = "/books/book_smalltest.txt";
   inline OpeningBook::BookFormat BOOK_TYPE = OpeningBook::BookFormat::SIMPLE;
 
+  // time control
+  inline bool     USE_NODE_TIME_CHECK          = true;    // poll the clock every n nodes instead of a timer thread
+  inline MilliSec TIME_CHECK_INTERVAL          = 2;       // targeted ms between two polls - n adapts to the nps
+  inline uint64_t TIME_CHECK_MIN_NODES         = 256;     // lower bound for n
+  inline uint64_t TIME_CHECK_MAX_NODES         = 100'000; // upper bound for n
+  inline bool     USE_SOFT_TIME_LIMIT          = true;    // no new iteration when the soft time limit is reached
+  inline double   SOFT_TIME_RATIO              = 0.5;     // soft limit as part of the hard limit for a stable search
+  inline double   TIME_BEST_MOVE_CHANGE_FACTOR = 0.2;     // soft limit increase per best move change
+  inline Value    TIME_SCORE_DROP_MARGIN       = Value{30}; // score drop between iterations seen as unstable
+  inline double   TIME_SCORE_DROP_FACTOR       = 1.5;     // soft limit factor after a score drop
+  inline double   TIME_NODE_SHARE_BASE         = 1.5;     // soft limit factor is this minus the best move's node share
+
+  // use the compile time search features (StaticSearchPolicy) when the
+  // runtime flags have their default values
+  inline bool USE_STATIC_SEARCH       = true;
+
   // basic search strategies and features
   inline bool USE_ASPIRATION_WINDOW   = true;
   inline Depth ASPIRATION_START_DEPTH = Depth{4};
@@ -48,13 +64,22 @@ namespace SearchConfig {
   // Transposition Table
   inline bool USE_TT                  = true; // use transposition table
   inline bool USE_TT_QSEARCH          = true; // use transposition table also in quiescence search
+  inline bool USE_TT_EVAL             = true; // reuse the static evaluation stored in the TT
   inline int TT_SIZE_MB               = 64;   // size of TT in MB
+  // Mate solver
+  inline bool USE_MATE_SOLVER         = true; // use the proof number mate solver for "go mate"
+  inline int MATE_SOLVER_SIZE_MB      = 32;   // size of the mate solver table in MB
+  inline double MATE_SOLVER_TIME_SHARE = 0.8; // part of the time limit for the mate solver before normal search
   // Move Sorting Features
   inline bool USE_KILLER_MOVES        = true; // Store refutation moves (>beta) for move ordering
   inline int NO_KILLER_MOVES          = 2;    // number of killers stored
   inline bool USE_PV_MOVE_SORT        = true; // tell the move gen the current pv to return first
+  inline bool USE_ROOT_MOVE_NODE_SORT = true; // order root moves after the best move by their subtree size
 
   // Pruning features
+  inline bool USE_UPCOMING_REP        = true; // draw value if the side to move can repeat a position
+  inline bool USE_MATERIAL_DRAW       = true; // return draw when neither side can mate (KK, KNK, KBK, KBKB)
+  inline bool USE_KPK_BITBASE         = true; // return draw for KPK positions known as draw
   inline bool USE_MDP                 = true; // mate distance pruning
   inline bool USE_MPP                 = true; // minor promotion pruning
   inline bool USE_QS_STANDPAT_CUT     = true; // RFP for quiescence
@@ -68,6 +93,11 @@ namespace SearchConfig {
   inline bool NMP_VERIFICATION        = true;
   inline Depth NMP_V_REDUCTION        = Depth{3};
 
+  inline bool USE_PROBCUT             = true; // ProbCut - good captures failing high in a reduced search
+  inline Depth PROBCUT_DEPTH          = Depth{5};
+  inline Value PROBCUT_MARGIN         = Value{200}; // raised beta for the reduced search
+  inline Depth PROBCUT_REDUCTION      = Depth{4};
+
   inline bool USE_EXTENSIONS          = true; // extensions
 
   inline bool USE_FP                  = true; // futility pruning
@@ -100,4 +130,91 @@ namespace SearchConfig {
 
 }
 
+/**
+ * The search features checked in every node of the search tree as compile
+ * time constants for the production search. Disabled features and their
+ * branches are removed by the compiler. The values have to be the defaults
+ * of SearchConfig - otherwise the search falls back to the RuntimeSearchPolicy.
+ */
+struct StaticSearchPolicy {
+  // @formatter:off
+  static constexpr bool USE_ALPHABETA       = true;
+  static constexpr bool USE_PVS             = true;
+  static constexpr bool USE_QUIESCENCE      = true;
+  static constexpr bool USE_TT              = true;
+  static constexpr bool USE_TT_QSEARCH      = true;
+  static constexpr bool USE_TT_EVAL         = true;
+  static constexpr bool USE_KILLER_MOVES    = true;
+  static constexpr bool USE_PV_MOVE_SORT    = true;
+  static constexpr bool USE_UPCOMING_REP    = true;
+  static constexpr bool USE_MATERIAL_DRAW   = true;
+  static constexpr bool USE_KPK_BITBASE     = true;
+  static constexpr bool USE_MDP             = true;
+  static constexpr bool USE_MPP             = true;
+  static constexpr bool USE_QS_STANDPAT_CUT = true;
+  static constexpr bool USE_RFP             = true;
+  static constexpr bool USE_NMP             = true;
+  static constexpr bool NMP_VERIFICATION    = true;
+  static constexpr bool USE_PROBCUT         = true;
+  static constexpr bool USE_EXTENSIONS      = true;
+  static constexpr bool USE_FP              = true;
+  static constexpr bool USE_EFP             = true;
+  static constexpr bool USE_LMR             = true;
+  // @formatter:on
+
+  /** true if the runtime flags in SearchConfig have the values of this policy */
+  static bool matchesConfig() {
+    return USE_ALPHABETA == SearchConfig::USE_ALPHABETA &&
+           USE_PVS == SearchConfig::USE_PVS &&
+           USE_QUIESCENCE == SearchConfig::USE_QUIESCENCE &&
+           USE_TT == SearchConfig::USE_TT &&
+           USE_TT_QSEARCH == SearchConfig::USE_TT_QSEARCH &&
+           USE_TT_EVAL == SearchConfig::USE_TT_EVAL &&
+           USE_KILLER_MOVES == SearchConfig::USE_KILLER_MOVES &&
+           USE_PV_MOVE_SORT == SearchConfig::USE_PV_MOVE_SORT &&
+           USE_UPCOMING_REP == SearchConfig::USE_UPCOMING_REP &&
+           USE_MATERIAL_DRAW == SearchConfig::USE_MATERIAL_DRAW &&
+           USE_KPK_BITBASE == SearchConfig::USE_KPK_BITBASE &&
+           USE_MDP == SearchConfig::USE_MDP &&
+           USE_MPP == SearchConfig::USE_MPP &&
+           USE_QS_STANDPAT_CUT == SearchConfig::USE_QS_STANDPAT_CUT &&
+           USE_RFP == SearchConfig::USE_RFP &&
+           USE_NMP == SearchConfig::USE_NMP &&
+           NMP_VERIFICATION == SearchConfig::NMP_VERIFICATION &&
+           USE_PROBCUT == SearchConfig::USE_PROBCUT &&
+           USE_EXTENSIONS == SearchConfig::USE_EXTENSIONS &&
+           USE_FP == SearchConfig::USE_FP &&
+           USE_EFP == SearchConfig::USE_EFP &&
+           USE_LMR == SearchConfig::USE_LMR;
+  }
+};
+
+/** The search features read from the SearchConfig flags (tests and tuning) */
+struct RuntimeSearchPolicy {
+  // @formatter:off
+  static inline bool &USE_ALPHABETA       = SearchConfig::USE_ALPHABETA;
+  static inline bool &USE_PVS             = SearchConfig::USE_PVS;
+  static inline bool &USE_QUIESCENCE      = SearchConfig::USE_QUIESCENCE;
+  static inline bool &USE_TT              = SearchConfig::USE_TT;
+  static inline bool &USE_TT_QSEARCH      = SearchConfig::USE_TT_QSEARCH;
+  static inline bool &USE_TT_EVAL         = SearchConfig::USE_TT_EVAL;
+  static inline bool &USE_KILLER_MOVES    = SearchConfig::USE_KILLER_MOVES;
+  static inline bool &USE_PV_MOVE_SORT    = SearchConfig::USE_PV_MOVE_SORT;
+  static inline bool &USE_UPCOMING_REP    = SearchConfig::USE_UPCOMING_REP;
+  static inline bool &USE_MATERIAL_DRAW   = SearchConfig::USE_MATERIAL_DRAW;
+  static inline bool &USE_KPK_BITBASE     = SearchConfig::USE_KPK_BITBASE;
+  static inline bool &USE_MDP             = SearchConfig::USE_MDP;
+  static inline bool &USE_MPP             = SearchConfig::USE_MPP;
+  static inline bool &USE_QS_STANDPAT_CUT = SearchConfig::USE_QS_STANDPAT_CUT;
+  static inline bool &USE_RFP             = SearchConfig::USE_RFP;
+  static inline bool &USE_NMP             = SearchConfig::USE_NMP;
+  static inline bool &NMP_VERIFICATION    = SearchConfig::NMP_VERIFICATION;
+  static inline bool &USE_PROBCUT         = SearchConfig::USE_PROBCUT;
+  static inline bool &USE_EXTENSIONS      = SearchConfig::USE_EXTENSIONS;
+  static inline bool &USE_FP              = SearchConfig::USE_FP;
+  static inline bool &USE_EFP             = SearchConfig::USE_EFP;
+  static inline bool &USE_LMR             = SearchConfig::USE_LMR;
+  // @formatter:on
+};
+
 #endif //FRANKYCPP_SEARCHCONFIG_H
@@ -36,6 +36,11 @@ std::ostream &operator<<(std::ostream &os, const std::array<uint64_t, MAX_MOVES>
   return os;
 }
 
+std::ostream &operator<<(std::ostream &os, const std::vector<uint64_t> &vector) {
+  for (auto n : vector) { os << n << " "; };
+  return os;
+}
+
 std::string SearchStats::str() const {
   std::stringstream os;
   os.imbue(deLocale);
@@ -46,6 +51,8 @@ std::string SearchStats::str() const {
     << " nonLeafPositionsEvaluated: " << nonLeafPositionsEvaluated
     << " tt_Cuts: " << tt_Cuts
     << " tt_NoCuts: " << tt_NoCuts
+    << " ttEvalHits: " << ttEvalHits
+    << " lazyEvaluations: " << lazyEvaluations
     << " quiescenceStandpatCuts: " << qStandpatCuts
     << " prunings: " << prunings
     << " pvs_cutoffs: " << pvs_cutoffs
@@ -56,8 +63,13 @@ std::string SearchStats::str() const {
     << " noTTMoveForPVsorting: " << no_moveForPVsorting
     << " nullMovePrunings: " << nullMovePrunings
     << " nullMoveVerifications: " << nullMoveVerifications
+    << " probCutTries: " << probCutTries
+    << " probCutPrunings: " << probCutPrunings
     << " minorPromotionPrunings: " << minorPromotionPrunings
     << " mateDistancePrunings: " << mateDistancePrunings
+    << " upcomingRepetitionCuts: " << upcomingRepetitionCuts
+    << " bitbaseDraws: " << bitbaseDraws
+    << " materialDraws: " << materialDraws
     << " extensions: " << extensions
     << "   "
     << " checkCounter: " << checkCounter
@@ -79,9 +91,11 @@ std::string SearchStats::str() const {
     //    << " lmrReductions: " << lmrReductions
     //    << " deltaPrunings: " << deltaPrunings
     //    << "   "
+    << " timeChecks: " << timeChecks
     << " bestMoveChanges: " << bestMoveChanges
     << " currentRootMove: " << currentRootMove
     << " lastSearchTime: " << lastSearchTime
+    << " rootMoveNodes: " << rootMoveNodes
     << " currentSearchDepth: " << currentSearchDepth
     << " currentExtraSearchDepth: " << currentExtraSearchDepth
     << "   "
@@ -28,6 +28,7 @@
 
 #include <ostream>
 #include <array>
+#include <vector>
 #include "types.h"
 
 /** data structure to cluster all search statistical values */
@@ -45,9 +46,15 @@ struct SearchStats {
   int bestMoveDepth = 0;
   MilliSec lastSearchTime = 0;
 
+  // nodes searched below each root move in the last iteration including
+  // aspiration re-searches (0 if not searched) - same order as the root
+  // moves of the search (best move first after each iteration)
+  std::vector<uint64_t> rootMoveNodes{};
+
   // performance statistics
   uint64_t movesGenerated = 0;
   uint64_t nodesVisited = 0; // legal nodes visited
+  uint64_t timeChecks = 0;   // clock polls when node based time checks are used
 
   // PERFT Values
   uint64_t leafPositionsEvaluated = 0;
@@ -74,8 +81,15 @@ struct SearchStats {
   uint64_t qStandpatCuts = 0;
   uint64_t minorPromotionPrunings = 0;
   uint64_t mateDistancePrunings = 0;
+  uint64_t upcomingRepetitionCuts = 0;
+  uint64_t bitbaseDraws = 0;
+  uint64_t materialDraws = 0;
+  uint64_t ttEvalHits = 0;
+  uint64_t lazyEvaluations = 0;
   uint64_t nullMovePrunings = 0;
   uint64_t nullMoveVerifications = 0;
+  uint64_t probCutTries = 0;
+  uint64_t probCutPrunings = 0;
   uint64_t extensions = 0;
   uint64_t rfpPrunings = 0;
   uint64_t razorReductions = 0;
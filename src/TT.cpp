@@ -78,6 +78,7 @@ void TT::clear() {
         _data[i].move = MOVE_NONE;
         _data[i].depth = DEPTH_NONE;
         _data[i].value = VALUE_NONE;
+        _data[i].eval = VALUE_NONE;
         _data[i].type = TYPE_NONE;
         _data[i].age = 1;
         _data[i].mateThreat = false;
@@ -99,7 +100,7 @@ void TT::clear() {
 }
 
 void TT::put(const Key key, const Depth depth, const Move move, const Value value,
-             const Value_Type type, const bool mateThreat, const bool forced) {
+             const Value_Type type, const Value eval, const bool mateThreat, const bool forced) {
   assert (value > VALUE_NONE);
   assert (depth >= 0);
 
@@ -118,7 +119,7 @@ void TT::put(const Key key, const Depth depth, const Move move, const Value valu
   // New entry
   if (entryDataPtr->key == 0) {
     numberOfEntries++;
-    writeEntry(entryDataPtr, key, depth, pureMove, value, type, mateThreat, 1);
+    writeEntry(entryDataPtr, key, depth, pureMove, value, type, eval, mateThreat, 1);
     return;
   }
 
@@ -131,7 +132,7 @@ void TT::put(const Key key, const Depth depth, const Move move, const Value valu
     if (depth > entryDataPtr->depth ||
         (depth == entryDataPtr->depth && (forced || entryDataPtr->age > 0))) {
       numberOfOverwrites++;
-      writeEntry(entryDataPtr, key, depth, pureMove, value, type, mateThreat, 1);
+      writeEntry(entryDataPtr, key, depth, pureMove, value, type, eval, mateThreat, 1);
     }
     return;
   }
@@ -142,8 +143,9 @@ void TT::put(const Key key, const Depth depth, const Move move, const Value valu
     // we always update as the stored moved can't be any good otherwise
     // we would have found this during the search in a previous probe
     // and we would not have come to store it again
-    writeEntry(entryDataPtr, key, depth, pureMove ? pureMove : entryDataPtr->move,
-               value, type, mateThreat, 1);
+    // the static evaluation of the position does not change
+    writeEntry(entryDataPtr, key, depth, pureMove ? pureMove : Move(entryDataPtr->move),
+               value, type, eval != VALUE_NONE ? eval : entryDataPtr->eval, mateThreat, 1);
     return;
   }
 
@@ -165,11 +167,12 @@ const TT::Entry* TT::probe(const Key &key) {
 
 inline void
 TT::writeEntry(Entry* const entryPtr, const Key key, const Depth depth, const Move move,
-               const Value value, const Value_Type type, bool mateThreat, uint8_t age) {
+               const Value value, const Value_Type type, const Value eval, bool mateThreat, uint8_t age) {
   entryPtr->key = key;
   entryPtr->move = move;
   entryPtr->depth = depth;
   entryPtr->value = value;
+  entryPtr->eval = eval;
   entryPtr->type = type;
   entryPtr->age = age;
   entryPtr->mateThreat = mateThreat;
@@ -211,7 +214,7 @@ std::string TT::str() {
 
 std::ostream &operator<<(std::ostream &os, const TT::Entry &entry) {
   os << "key: " << entry.key << " depth: " << entry.depth << " move: " << entry.move << " value: "
-     << entry.value << " type: " << entry.type << " mateThreat: " << entry.mateThreat
+     << entry.value << " eval: " << entry.eval << " type: " << entry.type << " mateThreat: " << entry.mateThreat
      << " age: " << entry.age;
   return os;
 
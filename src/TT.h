@@ -66,8 +66,9 @@ public:
     // sorted by size to achieve smallest struct size
     // using bitfield for smallest size
     Key key = 0; // 64 bit
-    Move move = MOVE_NONE; // 32 bit
+    Move move:16; // 16 bit - moves are stored without value
     Value value = VALUE_NONE; // 16 bit signed
+    Value eval = VALUE_NONE; // 16 bit signed - static evaluation
     Depth depth:7; // 0-127
     uint8_t age:3; // 0-7
     Value_Type type:2; // 4 values
@@ -144,10 +145,26 @@ public:
     * @param move best move of the node (when BETA best move until cut off)
     * @param value Value of the position between VALUE_MIN and VALUE_MAX
     * @param type EXACT, ALPHA or BETA
+    * @param eval static evaluation of the position or VALUE_NONE to keep the stored one
     * @param mateThreat node had a mate threat in the ply
     */
-  void
-  put(Key key, Depth depth, Move move, Value value, Value_Type type, bool mateThreat, bool forced);
+  void put(Key key, Depth depth, Move move, Value value, Value_Type type, Value eval, bool mateThreat,
+           bool forced);
+
+  /**
+    * Stores the node value and the depth it has been calculated at.
+    * Also stores the best move and the static evaluation for the node.
+    * @param key Position key (usually Zobrist key)
+    * @param depth 0-DEPTH_MAX (usually 127)
+    * @param move best move of the node (when BETA best move until cut off)
+    * @param value Value of the position between VALUE_MIN and VALUE_MAX
+    * @param type EXACT, ALPHA or BETA
+    * @param eval static evaluation of the position or VALUE_NONE to keep the stored one
+    * @param mateThreat node had a mate threat in the ply
+    */
+  void put(Key key, Depth depth, Move move, Value value, Value_Type type, Value eval, bool mateThreat) {
+    put(key, depth, move, value, type, eval, mateThreat, false);
+  }
 
   /**
     * Stores the node value and the depth it has been calculated at.
@@ -159,7 +176,7 @@ public:
     * @param mateThreat node had a mate threat in the ply
     */
   void put(Key key, Depth depth, Move move, Value value, Value_Type type, bool mateThreat) {
-    put(key, depth, move, value, type, mateThreat, false);
+    put(key, depth, move, value, type, VALUE_NONE, mateThreat, false);
   }
 
   /**
@@ -214,7 +231,7 @@ private:
 
   static void
   writeEntry(Entry* entryPtr, Key key, Depth depth, Move move,
-             Value value, Value_Type type, bool mateThreat, uint8_t age);
+             Value value, Value_Type type, Value eval, bool mateThreat, uint8_t age);
 
   /* generates the index hash key from the position key  */
   inline std::size_t getHash(const Key key) const {
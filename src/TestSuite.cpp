@@ -30,6 +30,7 @@
 #include "TestSuite.h"
 #include "Position.h"
 #include "Search.h"
+#include "SearchConfig.h"
 #include "misc.h"
 
 #include <boost/algorithm/string.hpp>
@@ -124,8 +125,11 @@ TestSuite::runSingleTest(Search &search, SearchLimits &searchLimits, TestSuite::
       searchLimits.setMate(t.mateDepth);
 
       // start search
+      const bool mateSolverConfig = SearchConfig::USE_MATE_SOLVER;
+      SearchConfig::USE_MATE_SOLVER = useMateSolver;
       search.startSearch(position, searchLimits);
       search.waitWhileSearching();
+      SearchConfig::USE_MATE_SOLVER = mateSolverConfig;
 
       // check and store result
       if ("mate " + t.expectedString == printValue(search.getLastSearchResult().bestMoveValue)) {
@@ -95,6 +95,9 @@ private:
 
   std::vector<Test> testCases;
 
+  // use the proof number mate solver for direct mate tests
+  bool useMateSolver = true;
+
   TestSuiteResult tr{};
 public:
 
@@ -108,6 +111,9 @@ public:
   TestSuite(const std::string_view &_filePath, MilliSec _searchTime, Depth _depth)
     : filePath(_filePath), searchTime(_searchTime), searchDepth(_depth) {}
 
+  /** selects the proof number mate solver or the normal search for direct mate tests */
+  void setUseMateSolver(bool use) { useMateSolver = use; }
+
   /** runs the tests specified in the given EPD file */
   void runTestSuite();
 
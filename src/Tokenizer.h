@@ -0,0 +1,249 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef FRANKYCPP_TOKENIZER_H
+#define FRANKYCPP_TOKENIZER_H
+
+#include <cctype>
+#include <string_view>
+
+/**
+ * Allocation free helpers to split and classify the tokens of opening book
+ * lines and PGN move sections. Replaces regular expressions which were
+ * built and matched for every line and every move while reading books.
+ */
+namespace Tokenizer {
+
+  inline bool isSpace(const char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+  }
+  inline bool isDigit(const char c) { return c >= '0' && c <= '9'; }
+  inline bool isFile(const char c) { return c >= 'a' && c <= 'h'; }
+  inline bool isRank(const char c) { return c >= '1' && c <= '8'; }
+  inline bool isPieceLetter(const char c) {
+    return c == 'N' || c == 'B' || c == 'R' || c == 'Q' || c == 'K';
+  }
+  inline bool isPromotionLetter(const char c) {
+    return c == 'N' || c == 'B' || c == 'R' || c == 'Q';
+  }
+
+  /** the view without leading and trailing white space */
+  inline std::string_view trim(std::string_view s) {
+    while (!s.empty() && isSpace(s.front())) s.remove_prefix(1);
+    while (!s.empty() && isSpace(s.back())) s.remove_suffix(1);
+    return s;
+  }
+
+  /** calls f for every white space separated token of s */
+  template<typename F>
+  inline void forEachToken(std::string_view s, F &&f) {
+    std::size_t i = 0;
+    while (i < s.size()) {
+      while (i < s.size() && isSpace(s[i])) i++;
+      const std::size_t start = i;
+      while (i < s.size() && !isSpace(s[i])) i++;
+      if (i > start) f(s.substr(start, i - start));
+    }
+  }
+
+  /** true if there is a UCI move without promotion at pos (e.g. e2e4) */
+  inline bool isUCIMoveAt(std::string_view s, const std::size_t pos) {
+    return pos + 4 <= s.size()
+           && isFile(s[pos]) && isRank(s[pos + 1])
+           && isFile(s[pos + 2]) && isRank(s[pos + 3]);
+  }
+
+  /** true if s is a UCI move with optional promotion (e.g. e2e4, a7a8q) */
+  inline bool isUCIMove(std::string_view s) {
+    if (s.size() == 4) return isUCIMoveAt(s, 0);
+    if (s.size() != 5) return false;
+    const char p = s[4];
+    return isUCIMoveAt(s, 0)
+           && (isPromotionLetter(p) || p == 'n' || p == 'b' || p == 'r' || p == 'q');
+  }
+
+  /**
+   * Calls f for every UCI move found in s - the moves do not need to be
+   * separated (e.g. e2e4e7e5g1f3). A promotion letter is only taken if it
+   * does not start the next move.
+   */
+  template<typename F>
+  inline void forEachUCIMove(std::string_view s, F &&f) {
+    std::size_t i = 0;
+    while (i + 4 <= s.size()) {
+      if (isUCIMoveAt(s, i)) {
+        std::size_t length = 4;
+        if (i + 4 < s.size() && isUCIMove(s.substr(i, 5)) && !isUCIMoveAt(s, i + 4)) length = 5;
+        f(s.substr(i, length));
+        i += length;
+      }
+      else i++;
+    }
+  }
+
+  /** true if s is a move number (e.g. 12. or 12...) */
+  inline bool isMoveNumber(std::string_view s) {
+    std::size_t i = 0;
+    while (i < s.size() && isDigit(s[i])) i++;
+    if (i == 0 || i == s.size()) return false;
+    while (i < s.size() && s[i] == '.') i++;
+    return i == s.size();
+  }
+
+  /** true if s is a game termination marker (1-0, 0-1, 1/2-1/2, *) */
+  inline bool isResult(std::string_view s) {
+    return s == "1-0" || s == "0-1" || s == "1/2-1/2" || s == "*";
+  }
+
+  /** true if s (ignoring trailing white space) ends with a game termination marker */
+  inline bool endsWithResult(std::string_view s) {
+    s = trim(s);
+    for (const std::string_view result : {"1-0", "0-1", "1/2-1/2", "*"}) {
+      if (s.size() >= result.size() && s.substr(s.size() - result.size()) == result) return true;
+    }
+    return false;
+  }
+
+  /** Parts of a move in SAN notation. Characters not given are 0. */
+  struct SAN {
+    char piece = 0;
+    char file = 0;
+    char rank = 0;
+    // target square or O-O / O-O-O
+    std::string_view target{};
+    char promotion = 0;
+  };
+
+  /**
+   * Splits a SAN move (e.g. Nbxd2+, e8=Q, O-O-O!?) into its parts.
+   * @return false if s is not in SAN notation
+   */
+  inline bool parseSAN(std::string_view s, SAN &san) {
+    san = SAN{};
+    // annotations and check signs
+    while (!s.empty() && (s.back() == '!' || s.back() == '?' || s.back() == '+' || s.back() == '#')) {
+      s.remove_suffix(1);
+    }
+    if (!s.empty() && isPromotionLetter(s.back())) {
+      san.promotion = s.back();
+      s.remove_suffix(1);
+      if (!s.empty() && s.back() == '=') s.remove_suffix(1);
+    }
+    std::size_t targetLength;
+    if (s.size() >= 5 && s.substr(s.size() - 5) == "O-O-O") targetLength = 5;
+    else if (s.size() >= 3 && s.substr(s.size() - 3) == "O-O") targetLength = 3;
+    else if (s.size() >= 2 && isFile(s[s.size() - 2]) && isRank(s.back())) targetLength = 2;
+    else return false;
+    san.target = s.substr(s.size() - targetLength);
+    s.remove_suffix(targetLength);
+    // piece, disambiguation and capture in this order and all optional
+    std::size_t i = 0;
+    if (i < s.size() && isPieceLetter(s[i])) san.piece = s[i++];
+    if (i < s.size() && isFile(s[i])) san.file = s[i++];
+    if (i < s.size() && isRank(s[i])) san.rank = s[i++];
+    if (i < s.size() && s[i] == 'x') i++;
+    return i == s.size();
+  }
+
+  /** true if s contains a square or a castling (candidate for a move) */
+  inline bool containsMove(std::string_view s) {
+    if (s.find("O-O") != std::string_view::npos) return true;
+    for (std::size_t i = 0; i + 1 < s.size(); i++) {
+      if (isFile(s[i]) && isRank(s[i + 1])) return true;
+    }
+    return false;
+  }
+
+  /**
+   * Splits a PGN tag pair line (e.g. [White "Kasparov"]) into name and value.
+   * @return false if the line is not a single tag pair
+   */
+  inline bool parseTagPair(std::string_view line, std::string_view &name, std::string_view &value) {
+    line = trim(line);
+    if (line.size() < 5 || line.front() != '[' || line.back() != ']') return false;
+    line = line.substr(1, line.size() - 2);
+    std::size_t i = 0;
+    while (i < line.size() && (std::isalnum(static_cast<unsigned char>(line[i])) || line[i] == '_')) i++;
+    if (i == 0) return false;
+    name = line.substr(0, i);
+    while (i < line.size() && line[i] == ' ') i++;
+    if (i == name.size() || i >= line.size() || line[i] != '"' || line.back() != '"' || i == line.size() - 1) return false;
+    value = line.substr(i + 1, line.size() - i - 2);
+    return true;
+  }
+
+  /**
+   * Calls f for every move of a PGN move section. Comments ({...}, ;...),
+   * reserved symbols (<...>), variations (also nested), NAGs, move numbers
+   * and results are skipped. Move numbers and NAGs also end a move which is
+   * not followed by white space (e.g. d5!!2.c4$1).
+   */
+  template<typename F>
+  inline void forEachMovetextToken(std::string_view s, F &&f) {
+    auto skipTo = [&](std::size_t i, const char end) {
+      const std::size_t pos = s.find(end, i);
+      return pos == std::string_view::npos ? s.size() : pos + 1;
+    };
+    auto isDelimiter = [](const char c) {
+      return isSpace(c) || c == '{' || c == '(' || c == ')' || c == '<' || c == ';';
+    };
+    std::size_t i = 0;
+    int variationDepth = 0;
+    while (i < s.size()) {
+      const char c = s[i];
+      if (c == '{') i = skipTo(i, '}');
+      else if (c == '<') i = skipTo(i, '>');
+      else if (c == ';') i = skipTo(i, '\n');
+      else if (c == '(') {
+        variationDepth++;
+        i++;
+      }
+      else if (c == ')') {
+        if (variationDepth > 0) variationDepth--;
+        i++;
+      }
+      else if (variationDepth > 0 || isSpace(c)) i++;
+      else {
+        const std::size_t start = i;
+        while (i < s.size() && !isDelimiter(s[i]) && s[i] != '.' && s[i] != '$') i++;
+        std::string_view token = s.substr(start, i - start);
+        if (i < s.size() && s[i] == '.') {
+          // move number (1.e4, 12...Nf6) - the digits in front of the dots
+          while (!token.empty() && isDigit(token.back())) token.remove_suffix(1);
+          while (i < s.size() && s[i] == '.') i++;
+        }
+        else if (i < s.size() && s[i] == '$') {
+          // numeric annotation glyph ($1)
+          i++;
+          while (i < s.size() && isDigit(s[i])) i++;
+        }
+        if (token.empty() || isResult(token) || !containsMove(token)) continue;
+        f(token);
+      }
+    }
+  }
+}
+
+#endif //FRANKYCPP_TOKENIZER_H
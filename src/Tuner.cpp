@@ -0,0 +1,345 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include "Tuner.h"
+#include "Logging.h"
+#include "Values.h"
+#include "Position.h"
+#include "MoveGenerator.h"
+#include "Evaluator.h"
+#include "PGN_Reader.h"
+#include "misc.h"
+
+namespace Tuner {
+
+  // opening positions are mostly from books and say little about the eval
+  constexpr int SKIP_PLIES = 8;
+  // limits the quiescence search when resolving positions
+  constexpr int MAX_QS_PLY = 8;
+
+  Result parseResult(const std::string &str) {
+    if (str == "1-0" || str == "1.0" || str == "1") return WHITE_WIN;
+    if (str == "0-1" || str == "0.0" || str == "0") return BLACK_WIN;
+    if (str == "1/2-1/2" || str == "0.5" || str == "1/2") return DRAW;
+    return NO_RESULT;
+  }
+
+  namespace {
+    /** capture search which also returns its principal variation */
+    Value qsearch(Position &position, Evaluator &evaluator, MoveGenerator &mg,
+                  Value alpha, Value beta, int ply, std::vector<Move> &pv) {
+      pv.clear();
+      const Value standPat = evaluator.evaluate(position);
+      if (ply >= MAX_QS_PLY || standPat >= beta) return standPat;
+      if (standPat > alpha) alpha = standPat;
+      const MoveList moves = *mg.generateLegalMoves<MoveGenerator::GENCAP>(position);
+      std::vector<Move> childPv;
+      for (Move move : moves) {
+        position.doMove(move);
+        const Value value = static_cast<Value>(-qsearch(position, evaluator, mg, static_cast<Value>(-beta),
+                                                         static_cast<Value>(-alpha), ply + 1, childPv));
+        position.undoMove();
+        if (value > alpha) {
+          alpha = value;
+          pv.assign(1, move);
+          pv.insert(pv.end(), childPv.begin(), childPv.end());
+          if (value >= beta) break;
+        }
+      }
+      return alpha;
+    }
+
+    /** result of an EPD line - c9 opcode, [1.0] style marker or a plain result token */
+    Result epdResult(const std::string &line) {
+      std::string::size_type pos = line.find("c9 \"");
+      if (pos != std::string::npos) {
+        const auto end = line.find('"', pos + 4);
+        return parseResult(line.substr(pos + 4, end - pos - 4));
+      }
+      pos = line.find('[');
+      if (pos != std::string::npos) {
+        const auto end = line.find(']', pos + 1);
+        return parseResult(line.substr(pos + 1, end - pos - 1));
+      }
+      std::istringstream in(line);
+      Result result = NO_RESULT;
+      for (std::string token; in >> token;) {
+        if (token.back() == ';') token.pop_back();
+        if (token.size() > 1 && token.front() == '"') token = token.substr(1, token.size() - 2);
+        if (token.size() > 2 && parseResult(token) != NO_RESULT) result = parseResult(token);
+      }
+      return result;
+    }
+
+    std::vector<std::string> readLines(const std::string &fileName) {
+      std::vector<std::string> lines;
+      std::ifstream file(fileName);
+      if (!file.is_open()) {
+        LOG__ERROR(Logger::get().MAIN_LOG, "Could not open file: {}", fileName);
+        return lines;
+      }
+      for (std::string line; std::getline(file, line);) {
+        if (!line.empty()) lines.push_back(line);
+      }
+      return lines;
+    }
+  }
+
+  namespace {
+    // every position is evaluated once per error computation - caches
+    // would only cost time and lazy evaluation would distort the values
+    EvaluatorConfig tuningConfig() {
+      EvaluatorConfig config;
+      config.USE_PAWN_TABLE = false;
+      config.USE_EVAL_CACHE = false;
+      config.USE_LAZY_EVAL = false;
+      return config;
+    }
+  }
+
+  Tuner::Tuner(std::size_t threads)
+    : config(tuningConfig()), batch(threads, config) {
+    for (PieceType pt = KING; pt <= QUEEN; ++pt) {
+      for (int i = 0; i < SQ_LENGTH; i++) originalPosScore[pt][i] = Values::getPosScore(pt, i);
+    }
+  }
+
+  Tuner::~Tuner() {
+    for (PieceType pt = KING; pt <= QUEEN; ++pt) {
+      for (int i = 0; i < SQ_LENGTH; i++) Values::setPosScore(pt, i, originalPosScore[pt][i]);
+    }
+  }
+
+  std::size_t Tuner::loadPGN(const std::string &fileName, std::size_t maxPositions) {
+    std::vector<std::string> lines = readLines(fileName);
+    PGN_Reader reader(lines);
+    if (!reader.process()) return 0;
+    std::size_t added = 0;
+    for (const PGN_Game &game : reader.getGames()) {
+      const auto tag = game.tags.find("Result");
+      if (tag == game.tags.end()) continue;
+      const Result result = parseResult(tag->second);
+      if (result == NO_RESULT) continue;
+      Position position;
+      int ply = 0;
+      for (const std::string &san : game.moves) {
+        const Move move = Misc::getMoveFromSAN(position, san);
+        if (move == MOVE_NONE) break;
+        position.doMove(move);
+        if (++ply <= SKIP_PLIES || position.hasCheck()) continue;
+        if (addPosition(position, result) && ++added >= maxPositions) break;
+      }
+      if (added >= maxPositions) break;
+    }
+    LOG__INFO(Logger::get().MAIN_LOG, "Tuner: {:n} positions from {:n} games in {}",
+              added, reader.getGames().size(), fileName);
+    return added;
+  }
+
+  std::size_t Tuner::loadEPD(const std::string &fileName, std::size_t maxPositions) {
+    std::size_t added = 0;
+    for (const std::string &line : readLines(fileName)) {
+      const Result result = epdResult(line);
+      if (result == NO_RESULT) continue;
+      std::istringstream in(line);
+      std::string board, color, castling, ep;
+      in >> board >> color >> castling >> ep;
+      const Position position(board + " " + color + " " + castling + " " + ep);
+      if (position.hasCheck()) continue;
+      if (addPosition(position, result) && ++added >= maxPositions) break;
+    }
+    LOG__INFO(Logger::get().MAIN_LOG, "Tuner: {:n} positions from {}", added, fileName);
+    return added;
+  }
+
+  bool Tuner::addPosition(Position position, Result result) {
+    MoveGenerator mg;
+    std::vector<Move> pv;
+    qsearch(position, batch.getEvaluator(), mg, VALUE_MIN, VALUE_MAX, 0, pv);
+    for (Move move : pv) position.doMove(move);
+    if (position.hasCheck()) return false;
+    positions.push_back(PackedPosition::pack(position, result));
+    return true;
+  }
+
+#define TUNER_TERM(name) Parameter{#name, &EvaluatorConfig::name}
+
+  void Tuner::addConfigParameters() {
+    // pure weights (multipliers) and the special endgame boni are not tuned
+    for (const Parameter &p : {TUNER_TERM(TEMPO),
+                               TUNER_TERM(ISOLATED_PAWN_MID_WEIGHT), TUNER_TERM(ISOLATED_PAWN_END_WEIGHT),
+                               TUNER_TERM(DOUBLED_PAWN_MID_WEIGHT), TUNER_TERM(DOUBLED_PAWN_END_WEIGHT),
+                               TUNER_TERM(PASSED_PAWN_MID_WEIGHT), TUNER_TERM(PASSED_PAWN_END_WEIGHT),
+                               TUNER_TERM(BLOCKED_PAWN_MID_WEIGHT), TUNER_TERM(BLOCKED_PAWN_END_WEIGHT),
+                               TUNER_TERM(PHALANX_PAWN_MID_WEIGHT), TUNER_TERM(PHALANX_PAWN_END_WEIGHT),
+                               TUNER_TERM(SUPPORTED_PAWN_MID_WEIGHT), TUNER_TERM(SUPPORTED_PAWN_END_WEIGHT),
+                               TUNER_TERM(CHECK_VALUE),
+                               TUNER_TERM(BISHOP_PAIR), TUNER_TERM(KNIGHT_PAIR), TUNER_TERM(ROOK_PAIR),
+                               TUNER_TERM(KING_SAFETY_PAWNSHIELD),
+                               TUNER_TERM(TRAPPED_ROOK_PENALTY), TUNER_TERM(TRAPPED_BISHOP_PENALTY),
+                               TUNER_TERM(KING_ZONE_ATTACK_PENALTY),
+                               TUNER_TERM(HANGING_PIECE_PENALTY), TUNER_TERM(THREAT_BY_PAWN_PENALTY),
+                               TUNER_TERM(THREAT_BY_MINOR_PENALTY)}) {
+      parameters.push_back(p);
+    }
+  }
+
+  void Tuner::addConfigParameters(const std::vector<std::string> &names) {
+    std::vector<Parameter> all;
+    std::swap(all, parameters);
+    addConfigParameters();
+    std::swap(all, parameters);
+    for (const Parameter &p : all) {
+      if (std::find(names.begin(), names.end(), p.name) != names.end()) parameters.push_back(p);
+    }
+  }
+
+#undef TUNER_TERM
+
+  void Tuner::addPSTParameters() {
+    for (PieceType pt = KING; pt <= QUEEN; ++pt) {
+      for (bool endGame : {false, true}) {
+        for (int i = 0; i < SQ_LENGTH; i++) {
+          // no pawns on the first and last rank
+          if (pt == PAWN && (i < 8 || i >= 56)) continue;
+          Parameter p;
+          p.name = fmt::format("{}{}[{}]", pieceTypeToString[pt], endGame ? "_END" : "_MID", i);
+          p.pieceType = pt;
+          p.index = i;
+          p.endGame = endGame;
+          parameters.push_back(p);
+        }
+      }
+    }
+  }
+
+  int Tuner::getValue(const Parameter &p) const {
+    if (p.term) return config.*p.term;
+    const Score score = Values::getPosScore(p.pieceType, p.index);
+    return p.endGame ? egValue(score) : mgValue(score);
+  }
+
+  void Tuner::setValue(const Parameter &p, int value) {
+    if (p.term) {
+      config.*p.term = value;
+      batch.setConfig(config);
+      return;
+    }
+    const Score score = Values::getPosScore(p.pieceType, p.index);
+    Values::setPosScore(p.pieceType, p.index,
+                        p.endGame ? makeScore(mgValue(score), value) : makeScore(value, egValue(score)));
+  }
+
+  double Tuner::sigmoid(double value) const {
+    return 1.0 / (1.0 + std::pow(10.0, -k * value / 400.0));
+  }
+
+  double Tuner::error() {
+    if (positions.empty()) return 0.0;
+    scores.resize(positions.size());
+    batch.evaluate(positions.data(), positions.size(), scores.data());
+    double sum = 0.0;
+    for (std::size_t i = 0; i < positions.size(); i++) {
+      const double white = positions[i].nextPlayer == WHITE ? scores[i] : -scores[i];
+      const double diff = positions[i].result / 2.0 - sigmoid(white);
+      sum += diff * diff;
+    }
+    return sum / positions.size();
+  }
+
+  double Tuner::computeK() {
+    double best = error();
+    for (double step : {0.1, 0.01, 0.001}) {
+      for (int direction : {1, -1}) {
+        while (k + direction * step > 0) {
+          k += direction * step;
+          const double e = error();
+          if (e < best) {
+            best = e;
+            continue;
+          }
+          k -= direction * step;
+          break;
+        }
+      }
+    }
+    LOG__INFO(Logger::get().MAIN_LOG, "Tuner: K = {:.3f} error = {:.6f}", k, best);
+    return k;
+  }
+
+  double Tuner::tune(int iterations) {
+    double best = error();
+    LOG__INFO(Logger::get().MAIN_LOG, "Tuner: {:n} positions {:n} parameters start error = {:.6f}",
+              positions.size(), parameters.size(), best);
+    for (int iteration = 1; iteration <= iterations; iteration++) {
+      int changed = 0;
+      for (const Parameter &p : parameters) {
+        const int value = getValue(p);
+        for (int delta : {1, -1}) {
+          setValue(p, value + delta);
+          const double e = error();
+          if (e < best) {
+            best = e;
+            changed++;
+            break;
+          }
+          setValue(p, value);
+        }
+      }
+      LOG__INFO(Logger::get().MAIN_LOG, "Tuner: iteration {} changed {:n} parameters error = {:.6f}",
+                iteration, changed, best);
+      if (!changed) break;
+    }
+    return best;
+  }
+
+  std::string Tuner::print() const {
+    std::ostringstream os;
+    bool pst = false;
+    for (const Parameter &p : parameters) {
+      if (p.term) os << fmt::format("   int {} = {};\n", p.name, getValue(p));
+      else pst = true;
+    }
+    if (!pst) return os.str();
+    static const char* names[] = {"", "king", "pawns", "knight", "bishop", "rook", "queen"};
+    for (PieceType pt = KING; pt <= QUEEN; ++pt) {
+      for (bool endGame : {false, true}) {
+        os << fmt::format("  constexpr int {}{}[SQ_LENGTH] = {{\n", names[pt], endGame ? "EndGame" : "MidGame");
+        for (int i = 0; i < SQ_LENGTH; i++) {
+          const Score score = Values::getPosScore(pt, i);
+          if (i % 8 == 0) os << "    ";
+          os << fmt::format("{:3}", endGame ? egValue(score) : mgValue(score));
+          os << (i == SQ_LENGTH - 1 ? "\n" : i % 8 == 7 ? ",\n" : ",");
+        }
+        os << "  };\n";
+      }
+    }
+    return os.str();
+  }
+}
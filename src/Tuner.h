@@ -0,0 +1,142 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef FRANKYCPP_TUNER_H
+#define FRANKYCPP_TUNER_H
+
+#include <string>
+#include <vector>
+#include "types.h"
+#include "EvaluatorConfig.h"
+#include "PackedPosition.h"
+#include "BatchEvaluator.h"
+
+// forward declared dependencies
+class Position;
+
+/**
+ * Texel style tuner for the evaluation.
+ *
+ * Quiet positions with the game result are loaded from PGN (result tag)
+ * or EPD files (c9 opcode or result markers like [0.5]). Each position is
+ * resolved once to the leaf of its quiescence principal variation and then
+ * stored as a PackedPosition.
+ *
+ * The parameters are the int terms of the EvaluatorConfig and the piece
+ * square tables of Values. The tuner minimises the mean squared error
+ * between the game results and sigmoid(K * eval) with a local search of
+ * +/- 1 steps per parameter. The positions are evaluated in parallel by
+ * a BatchEvaluator.
+ */
+namespace Tuner {
+
+  /** game results from the view of white (stored in PackedPosition::result) */
+  enum Result : uint8_t {
+    BLACK_WIN = 0,
+    DRAW = 1,
+    WHITE_WIN = 2,
+    NO_RESULT = 3
+  };
+
+  /** reads "1-0", "0-1", "1/2-1/2" or "1.0", "0.0", "0.5" - NO_RESULT otherwise */
+  Result parseResult(const std::string &str);
+
+  /** a tunable int of the evaluation */
+  struct Parameter {
+    std::string name;
+    // either a term of the EvaluatorConfig
+    int EvaluatorConfig::* term = nullptr;
+    // or a piece square table entry (upright index)
+    PieceType pieceType = PIECETYPE_NONE;
+    int index = 0;
+    bool endGame = false;
+  };
+
+  class Tuner {
+    std::vector<PackedPosition> positions{};
+    std::vector<Parameter> parameters{};
+    EvaluatorConfig config{};
+    BatchEvaluator batch;
+    std::vector<Value> scores{};
+    // piece square tables before tuning - restored on destruction
+    Score originalPosScore[PT_LENGTH][SQ_LENGTH]{};
+    double k = 1.0;
+
+  public:
+    explicit Tuner(std::size_t threads = 0);
+    ~Tuner();
+    Tuner(const Tuner &) = delete;
+    Tuner &operator=(const Tuner &) = delete;
+
+    /**
+     * Loads positions from a PGN file. The first plies of each game and
+     * positions in check are skipped.
+     * @return number of positions added
+     */
+    std::size_t loadPGN(const std::string &fileName, std::size_t maxPositions = SIZE_MAX);
+
+    /** Loads positions with results from an EPD file - lines without result are skipped */
+    std::size_t loadEPD(const std::string &fileName, std::size_t maxPositions = SIZE_MAX);
+
+    /** adds a position (resolved to a quiet position first) */
+    bool addPosition(Position position, Result result);
+
+    /** all int terms of the EvaluatorConfig except the table sizes */
+    void addConfigParameters();
+
+    /** only the given int terms of the EvaluatorConfig (e.g. new terms) */
+    void addConfigParameters(const std::vector<std::string> &names);
+
+    /** all piece square table entries (without the pawn entries on rank 1 and 8) */
+    void addPSTParameters();
+
+    /** finds the scaling constant K with the minimal error for the current parameters */
+    double computeK();
+
+    /** mean squared error of all positions for the current parameters */
+    double error();
+
+    /**
+     * Local search over all parameters.
+     * @return the final error
+     */
+    double tune(int iterations);
+
+    /** the tuned values as C++ source for EvaluatorConfig.h and Values.h */
+    std::string print() const;
+
+    const std::vector<PackedPosition> &getPositions() const { return positions; }
+    const std::vector<Parameter> &getParameters() const { return parameters; }
+    const EvaluatorConfig &getConfig() const { return config; }
+    double getK() const { return k; }
+    int getValue(const Parameter &p) const;
+
+  private:
+    void setValue(const Parameter &p, int value);
+    double sigmoid(double value) const;
+  };
+}
+
+#endif //FRANKYCPP_TUNER_H
@@ -81,6 +81,7 @@ void UCI_Handler::loop(std::istream* pIstream) {
     else if (token == "ponderhit") { ponderHitCommand(); }
     else if (token == "register") { registerCommand(); }
     else if (token == "debug") { debugCommand(); }
+    else if (token == "eval") { evalCommand(); }
     else if (token == "noop") { /* noop */}
     else
       LOG__WARN(Logger::get().UCIHAND_LOG, "Unknown UCI command: {}", token);
@@ -322,6 +323,13 @@ void UCI_Handler::stopCommand() const { pEngine->stopSearch(); }
 
 void UCI_Handler::ponderHitCommand() const { pEngine->ponderHit(); }
 
+void UCI_Handler::evalCommand() const {
+  // not part of the UCI protocol - prints the evaluation terms of the
+  // current position for debugging
+  std::istringstream lines(pEngine->evalTrace());
+  for (std::string line; std::getline(lines, line);) send(line);
+}
+
 void UCI_Handler::registerCommand() {
   LOG__WARN(Logger::get().UCIHAND_LOG, "UCI Protocol Command: register not implemented!");
 }
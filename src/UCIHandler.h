@@ -61,6 +61,7 @@ public:
   void goCommand(std::istringstream &inStream);
   void stopCommand() const;
   void ponderHitCommand() const;
+  void evalCommand() const;
   static void registerCommand();
   static void debugCommand();
   void send(const std::string &toSend) const;
@@ -26,106 +26,41 @@
 #include "Values.h"
 
 namespace Values {
-  Value posMidValue[PIECE_LENGTH][SQ_LENGTH];
-  Value posEndValue[PIECE_LENGTH][SQ_LENGTH];
+  Score posScore[PIECE_LENGTH][SQ_LENGTH];
   Value posValue[PIECE_LENGTH][SQ_LENGTH][GAME_PHASE_MAX + 1];
 
-  inline int calcPosValueWhite(const Square &sq, int gamePhase,
-                                  const int posMidTable[],
-                                  const int posEndTable[]) {
-    return (gamePhase / GAME_PHASE_MAX) * posMidTable[63 - sq] +
-           (1 - (gamePhase / GAME_PHASE_MAX)) * posEndTable[63 - sq];
-  }
-
-  inline int calcPosValueBlack(const Square &sq, int gamePhase, const int posMidTable[], const int posEndTable[]) {
-    return (gamePhase / GAME_PHASE_MAX) * posMidTable[sq] + (1 - (gamePhase / GAME_PHASE_MAX)) * posEndTable[sq];
+  namespace {
+    void setScore(Piece pc, Square sq, Score score) {
+      posScore[pc][sq] = score;
+      for (int gp = GAME_PHASE_MAX; gp >= 0; gp--) {
+        posValue[pc][sq][gp] = static_cast<Value>(
+          taper(posScore[pc][sq], static_cast<double>(gp) / GAME_PHASE_MAX));
+      }
+    }
   }
 
   void init() {
-    // pre-compute piece on square values for mid and endgame and also for
-    // all game phases
+    // tables per piece type - indexed like PieceType
+    const int* midTables[] = {nullptr, kingMidGame, pawnsMidGame, knightMidGame,
+                              bishopMidGame, rookMidGame, queenMidGame};
+    const int* endTables[] = {nullptr, kingEndGame, pawnsEndGame, knightEndGame,
+                              bishopEndGame, rookEndGame, queenEndGame};
+
+    // pre-compute piece on square scores for mid and endgame and the tapered
+    // values for all game phases
     for (Piece pc = WHITE_KING; pc <= BLACK_QUEEN; ++pc) {
+      const PieceType pt = typeOf(pc);
+      if (pt < KING || pt > QUEEN) continue;
       for (Square sq = SQ_A1; sq <= SQ_H8; ++sq) {
-        for (int gp = GAME_PHASE_MAX; gp >= 0; gp--) {
-          switch (pc) {
-            case WHITE_KING:
-              posMidValue[pc][sq] = (Value) kingMidGame[63 - sq];
-              posEndValue[pc][sq] = (Value) kingEndGame[63 - sq];
-              posValue[pc][sq][gp] =
-                static_cast<Value>(calcPosValueWhite(sq, gp, kingMidGame, kingEndGame));
-              break;
-            case WHITE_PAWN:
-              posMidValue[pc][sq] = static_cast<Value>(pawnsMidGame[63 - sq]);
-              posEndValue[pc][sq] = static_cast<Value>(pawnsEndGame[63 - sq]);
-              posValue[pc][sq][gp] =
-                static_cast<Value>(calcPosValueWhite(sq, gp, pawnsMidGame, pawnsEndGame));
-              break;
-            case WHITE_KNIGHT:
-              posMidValue[pc][sq] = static_cast<Value>(knightMidGame[63 - sq]);
-              posEndValue[pc][sq] = static_cast<Value>(knightEndGame[63 - sq]);
-              posValue[pc][sq][gp] =
-                static_cast<Value>(calcPosValueWhite(sq, gp, knightMidGame, knightEndGame));
-              break;
-            case WHITE_BISHOP:
-              posMidValue[pc][sq] = static_cast<Value>(bishopMidGame[63 - sq]);
-              posEndValue[pc][sq] = static_cast<Value>(bishopEndGame[63 - sq]);
-              posValue[pc][sq][gp] =
-                static_cast<Value>(calcPosValueWhite(sq, gp, bishopMidGame, bishopEndGame));
-              break;
-            case WHITE_ROOK:
-              posMidValue[pc][sq] = static_cast<Value>(rookMidGame[63 - sq]);
-              posEndValue[pc][sq] = static_cast<Value>(rookEndGame[63 - sq]);
-              posValue[pc][sq][gp] =
-                static_cast<Value>(calcPosValueWhite(sq, gp, rookMidGame, rookEndGame));
-              break;
-            case WHITE_QUEEN:
-              posMidValue[pc][sq] = static_cast<Value>(queenMidGame[63 - sq]);
-              posEndValue[pc][sq] = static_cast<Value>(queenEndGame[63 - sq]);
-              posValue[pc][sq][gp] =
-                static_cast<Value>(calcPosValueWhite(sq, gp, queenMidGame, queenEndGame));
-              break;
-            case BLACK_KING:
-              posMidValue[pc][sq] = static_cast<Value>(kingMidGame[sq]);
-              posEndValue[pc][sq] = static_cast<Value>(kingEndGame[sq]);
-              posValue[pc][sq][gp] =
-                static_cast<Value>(calcPosValueBlack(sq, gp, kingMidGame, kingEndGame));
-              break;
-            case BLACK_PAWN:
-              posMidValue[pc][sq] = static_cast<Value>(pawnsMidGame[sq]);
-              posEndValue[pc][sq] = static_cast<Value>(pawnsEndGame[sq]);
-              posValue[pc][sq][gp] =
-                static_cast<Value>(calcPosValueBlack(sq, gp, pawnsMidGame, pawnsEndGame));
-              break;
-            case BLACK_KNIGHT:
-              posMidValue[pc][sq] = static_cast<Value>(knightMidGame[sq]);
-              posEndValue[pc][sq] = static_cast<Value>(knightEndGame[sq]);
-              posValue[pc][sq][gp] =
-                static_cast<Value>(calcPosValueBlack(sq, gp, knightMidGame, knightEndGame));
-              break;
-            case BLACK_BISHOP:
-              posMidValue[pc][sq] = static_cast<Value>(bishopMidGame[sq]);
-              posEndValue[pc][sq] = static_cast<Value>(bishopEndGame[sq]);
-              posValue[pc][sq][gp] =
-                static_cast<Value>(calcPosValueBlack(sq, gp, bishopMidGame, bishopEndGame));
-              break;
-            case BLACK_ROOK:
-              posMidValue[pc][sq] = static_cast<Value>(rookMidGame[sq]);
-              posEndValue[pc][sq] = static_cast<Value>(rookEndGame[sq]);
-              posValue[pc][sq][gp] =
-                static_cast<Value>(calcPosValueBlack(sq, gp, rookMidGame, rookEndGame));
-              break;
-            case BLACK_QUEEN:
-              posMidValue[pc][sq] = static_cast<Value>(queenMidGame[sq]);
-              posEndValue[pc][sq] = static_cast<Value>(queenEndGame[sq]);
-              posValue[pc][sq][gp] =
-                static_cast<Value>(calcPosValueBlack(sq, gp, queenMidGame, queenEndGame));
-              break;
-            case PIECE_NONE:
-            case PIECE_LENGTH:
-              break;
-          }
-        }
+        // tables are upright - white needs to be mirrored
+        const int index = colorOf(pc) == WHITE ? 63 - sq : sq;
+        setScore(pc, Square(sq), makeScore(midTables[pt][index], endTables[pt][index]));
       }
     }
   }
-}
\ No newline at end of file
+
+  void setPosScore(PieceType pt, int index, Score score) {
+    setScore(makePiece(WHITE, pt), Square(63 - index), score);
+    setScore(makePiece(BLACK, pt), Square(index), score);
+  }
+}
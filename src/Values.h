@@ -33,10 +33,21 @@ namespace Values {
   void init();
 
   // initialize in init();
-  extern Value posMidValue[PIECE_LENGTH][SQ_LENGTH];
-  extern Value posEndValue[PIECE_LENGTH][SQ_LENGTH];
+  extern Score posScore[PIECE_LENGTH][SQ_LENGTH];
   extern Value posValue[PIECE_LENGTH][SQ_LENGTH][GAME_PHASE_MAX + 1];
 
+  /**
+   * Changes the value of a piece type on a square of the upright tables for
+   * both colors (used by the tuner). Only positions set up after the change
+   * will use the new value.
+   */
+  void setPosScore(PieceType pt, int index, Score score);
+
+  /** value of a piece type on a square of the upright tables */
+  inline Score getPosScore(PieceType pt, int index) {
+    return posScore[makePiece(BLACK, pt)][index];
+  }
+
   /// Tables are upright for easier reading - will be transposed in init()
 
   // @formatter:off
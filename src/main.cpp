@@ -33,6 +33,7 @@
 
 #include "boost/program_options.hpp"
 #include "TestSuite.h"
+#include "OpeningBook.h"
 namespace po = boost::program_options;
 
 inline po::variables_map programOptions;
@@ -51,6 +52,8 @@ int main(int argc, char* argv[]) {
   std::string testsuite_File;
   int testsuite_Time;
   int testsuite_Depth;
+  std::string book_File;
+  std::string book_Format;
 
   // Command line options
   try {
@@ -69,7 +72,9 @@ int main(int argc, char* argv[]) {
             ("search_log_lvl,s", po::value<std::string>()->default_value("warn"), "set search log level <critical|error|warn|info|debug|trace>")
             ("testsuite", po::value<std::string>(&testsuite_File), "run testsuite in given file")
             ("tsTime", po::value<int>(&testsuite_Time)->default_value(1'000), "time in ms per test in testsuite")
-            ("tsDepth", po::value<int>(&testsuite_Depth)->default_value(0), "max search depth per test in testsuite");
+            ("tsDepth", po::value<int>(&testsuite_Depth)->default_value(0), "max search depth per test in testsuite")
+            ("compileBook", po::value<std::string>(&book_File), "compile the given opening book into <file>.bin which is then used instead of the book")
+            ("bookFormat", po::value<std::string>(&book_Format)->default_value("pgn"), "format of the book to compile <simple|san|pgn>");
 
     // Hidden options, will be allowed both on command line and in config file,
     // but will not be shown to the user.
@@ -132,6 +137,22 @@ int main(int argc, char* argv[]) {
       return 0;
     }
 
+    if (programOptions.count("compileBook")) {
+      INIT::init();
+      OpeningBook::BookFormat format = OpeningBook::BookFormat::PGN;
+      if (book_Format == "simple") format = OpeningBook::BookFormat::SIMPLE;
+      else if (book_Format == "san") format = OpeningBook::BookFormat::SAN;
+      else if (book_Format != "pgn") {
+        std::cerr << "Unknown book format: " << book_Format << "\n";
+        return 1;
+      }
+      // an existing binary book would be read instead of the book
+      std::remove((book_File + ".bin").c_str());
+      OpeningBook book(book_File, format);
+      book.initialize();
+      return book.saveBinary(book_File + ".bin") ? 0 : 1;
+    }
+
     if (programOptions.count("test")) {
       std::cout << "Test of hidden parameter." << "\n";
       std::cout << programOptions["test"].as<std::string>() << "\n";
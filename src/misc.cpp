@@ -23,7 +23,6 @@
  *
  */
 
-#include <regex>
 #include <string>
 #include <iostream>
 #include "fmt/printf.h"
@@ -31,24 +30,21 @@
 #include "Logging.h"
 #include "MoveGenerator.h"
 #include "Position.h"
+#include "Tokenizer.h"
 
 namespace Misc {
 
   Move getMoveFromUCI(Position &position, std::string moveStr) {
-    // Regex for UCI notation (UCI)
-    std::regex regexPattern("([a-h][1-8][a-h][1-8])([NBRQnbrq])?");
-    std::smatch matcher;
-
-    // Match the target string
-    if (!std::regex_match(moveStr, matcher, regexPattern)) {
+    // UCI notation with optional promotion
+    if (!Tokenizer::isUCIMove(moveStr)) {
       LOG__TRACE(Logger::get().MAIN_LOG, "No match found");
       return MOVE_NONE;
     }
 
     // pattern is move
     LOG__TRACE(Logger::get().MAIN_LOG, "Match found");
-    std::string matchedMove = matcher.str(1);
-    std::string promotion = toUpperCase(matcher.str(2));
+    std::string matchedMove = moveStr.substr(0, 4);
+    std::string promotion = toUpperCase(moveStr.substr(4));
     LOG__TRACE(Logger::get().MAIN_LOG, "move: {} promotion: {}", matchedMove, promotion);
 
     // create all moves on position and compare
@@ -66,24 +62,20 @@ namespace Misc {
   Move getMoveFromSAN(const Position &position, const std::string &sanMove) {
     LOG__TRACE(Logger::get().MAIN_LOG, "Checking SAN move {} in position {}", sanMove, position.printFen());
 
-    // Regex for short move notation (SAN)
-    std::regex regexPattern("([NBRQK])?([a-h])?([1-8])?x?([a-h][1-8]|O-O-O|O-O)(=?([NBRQ]))?([!?+#]*)?");
-    std::smatch matcher;
-
-    // Match the target string
-    if (!std::regex_match(sanMove, matcher, regexPattern)) {
+    // short move notation (SAN)
+    Tokenizer::SAN san;
+    if (!Tokenizer::parseSAN(sanMove, san)) {
       LOG__WARN(Logger::get().MAIN_LOG, "Given SAN move not valid: {}", sanMove);
       return MOVE_NONE;
     }
 
     // get the parts
-    std::string pieceType = matcher.str(1);
-    std::string disambFile = matcher.str(2);
-    std::string disambRank = matcher.str(3);
-    std::string toSquare = matcher.str(4);
-    std::string promotion = matcher.str(6);
-    std::string checkSign = matcher.str(7);
-    LOG__TRACE(Logger::get().MAIN_LOG, "SAN interpreted as: Piece Type: {} File: {} Row: {} Target: {} Promotion: {} CheckSign: {}", pieceType, disambFile, disambRank, toSquare, promotion, checkSign);
+    const char pieceType = san.piece;
+    const char disambFile = san.file;
+    const char disambRank = san.rank;
+    const std::string_view toSquare = san.target;
+    const char promotion = san.promotion;
+    LOG__TRACE(Logger::get().MAIN_LOG, "SAN interpreted as: Piece Type: {} File: {} Row: {} Target: {} Promotion: {}", pieceType, disambFile, disambRank, toSquare, promotion);
 
     // Generate all legal moves and loop through them to search for a matching move
     LOG__TRACE(Logger::get().MAIN_LOG, "Matching SAN move {} against all legal moves", sanMove);
@@ -97,7 +89,7 @@ namespace Misc {
       // castling move
       if (typeOf(m) == CASTLING) {
         const Square kingToSquare = getToSquare(m);
-        std::string castlingString;
+        std::string_view castlingString;
         switch (kingToSquare) {
           case SQ_G1: // white king side
           case SQ_G8: // black king side
@@ -126,13 +118,13 @@ namespace Misc {
 
         // Find out piece
         Piece movePiece = position.getPiece(getFromSquare(m));
-        const std::string pieceTypeChar(1, pieceTypeToChar[typeOf(movePiece)]);
+        const char pieceTypeChar = pieceTypeToChar[typeOf(movePiece)];
         LOG__TRACE(Logger::get().MAIN_LOG, "Legal move {} piece type is {}", printMove(m), pieceTypeChar);
 
-        if (!pieceType.empty() && pieceTypeChar == pieceType) {
+        if (pieceType && pieceTypeChar == pieceType) {
           LOG__TRACE(Logger::get().MAIN_LOG, "Legal move {} SAN move {}: piece type match", printMove(m), sanMove);
         }
-        else if (pieceType.empty() && typeOf(movePiece) == PAWN) {
+        else if (!pieceType && typeOf(movePiece) == PAWN) {
           LOG__TRACE(Logger::get().MAIN_LOG, "Legal move {} SAN move {}: piece type match", printMove(m), sanMove);
         }
         else {
@@ -141,8 +133,8 @@ namespace Misc {
         }
 
         // Disambiguation File
-        if (!disambFile.empty()) {
-          if (std::string(1, char('a' + fileOf(getFromSquare(m)))) == disambFile) {
+        if (disambFile) {
+          if (char('a' + fileOf(getFromSquare(m))) == disambFile) {
             LOG__TRACE(Logger::get().MAIN_LOG, "Legal move {} SAN move {}: file disambiguation match {}", printMove(m), sanMove, disambFile);
           }
           else {
@@ -152,8 +144,8 @@ namespace Misc {
         }
 
         // Disambiguation Rank
-        if (!disambRank.empty()) {
-          if (std::string(1, char('1' + rankOf(getFromSquare(m)))) == disambRank) {
+        if (disambRank) {
+          if (char('1' + rankOf(getFromSquare(m))) == disambRank) {
             LOG__TRACE(Logger::get().MAIN_LOG, "Legal move {} SAN move {}: rank disambiguation match {}", printMove(m), sanMove, disambRank);
           }
           else {
@@ -163,8 +155,8 @@ namespace Misc {
         }
 
         // promotion
-        if (!promotion.empty()) {
-          if (std::string(1, pieceToChar[promotionType(m)]) == promotion) {
+        if (promotion) {
+          if (pieceToChar[promotionType(m)] == promotion) {
             LOG__TRACE(Logger::get().MAIN_LOG, "Legal move {} SAN move {}: promotion match {}", printMove(m), sanMove, promotion);
           }
           else {
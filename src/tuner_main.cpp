@@ -0,0 +1,107 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <string>
+#include <iostream>
+#include <fstream>
+#include "version.h"
+#include "types.h"
+#include "Logging.h"
+#include "Tuner.h"
+
+#include "boost/program_options.hpp"
+namespace po = boost::program_options;
+
+/**
+ * Texel tuner for the evaluation. Reads positions with results from PGN and
+ * EPD files and prints the tuned values for EvaluatorConfig.h and Values.h.
+ */
+int main(int argc, char* argv[]) {
+
+  std::vector<std::string> pgnFiles;
+  std::vector<std::string> epdFiles;
+  std::vector<std::string> terms;
+  std::size_t maxPositions;
+  std::size_t threads;
+  int iterations;
+  std::string outputFile;
+
+  po::options_description options("Allowed options");
+  options.add_options()
+           ("help,?", "produce help message")
+           ("pgn", po::value<std::vector<std::string>>(&pgnFiles), "PGN file with result tags (repeatable)")
+           ("epd", po::value<std::vector<std::string>>(&epdFiles), "EPD file with results (repeatable)")
+           ("maxPositions", po::value<std::size_t>(&maxPositions)->default_value(1'000'000), "max number of positions per file")
+           ("threads", po::value<std::size_t>(&threads)->default_value(0), "number of threads (0 = all cores)")
+           ("iterations", po::value<int>(&iterations)->default_value(100), "max number of iterations")
+           ("term", po::value<std::vector<std::string>>(&terms), "tune only this EvaluatorConfig term (repeatable)")
+           ("pst", "also tune the piece square tables")
+           ("output,o", po::value<std::string>(&outputFile), "file for the tuned values (default stdout)");
+
+  po::variables_map programOptions;
+  try {
+    store(po::parse_command_line(argc, argv, options), programOptions);
+    notify(programOptions);
+  }
+  catch (std::exception &e) {
+    std::cerr << "error: " << e.what() << "\n";
+    return 1;
+  }
+
+  if (programOptions.count("help")) {
+    std::cout << options << "\n";
+    return 0;
+  }
+
+  INIT::init();
+  Logger::get().MAIN_LOG->set_level(spdlog::level::info);
+
+  if (pgnFiles.empty() && epdFiles.empty()) {
+    pgnFiles.push_back(std::string(FrankyCPP_PROJECT_ROOT) + "/books/superbook2.pgn");
+  }
+
+  Tuner::Tuner tuner(threads);
+  for (const std::string &file : pgnFiles) tuner.loadPGN(file, maxPositions);
+  for (const std::string &file : epdFiles) tuner.loadEPD(file, maxPositions);
+  if (tuner.getPositions().empty()) {
+    std::cerr << "no positions with results found\n";
+    return 1;
+  }
+
+  if (terms.empty()) tuner.addConfigParameters();
+  else tuner.addConfigParameters(terms);
+  if (programOptions.count("pst")) tuner.addPSTParameters();
+  tuner.computeK();
+  tuner.tune(iterations);
+
+  if (outputFile.empty()) {
+    std::cout << tuner.print();
+  }
+  else {
+    std::ofstream out(outputFile);
+    out << tuner.print();
+  }
+  return 0;
+}
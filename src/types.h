@@ -295,6 +295,37 @@ inline Value operator-(Value d1, Ply d2) {
   return static_cast<Value>(static_cast<int>(d1) - static_cast<int>(d2));
 }
 
+///////////////////////////////////
+//// SCORE
+/**
+ * A Score packs a mid game and an end game value into one int32 so both are
+ * added, subtracted and multiplied in one operation. The end game value is
+ * stored in the upper and the mid game value in the lower 16 bit.
+ */
+enum Score : int32_t {
+  SCORE_ZERO = 0
+};
+
+constexpr Score makeScore(int mg, int eg) {
+  return static_cast<Score>(static_cast<int32_t>(static_cast<uint32_t>(eg) << 16) + mg);
+}
+
+/** returns the mid game value of the score */
+constexpr int mgValue(Score s) {
+  return static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint32_t>(s)));
+}
+
+/** returns the end game value of the score (corrected for the borrow of a
+ * negative mid game value) */
+constexpr int egValue(Score s) {
+  return static_cast<int16_t>(static_cast<uint16_t>((static_cast<uint32_t>(s) + 0x8000) >> 16));
+}
+
+/** tapers the score by the game phase factor (1.0 mid game to 0.0 end game) */
+inline int taper(Score s, double gamePhaseFactor) {
+  return static_cast<int>(gamePhaseFactor * mgValue(s) + (1 - gamePhaseFactor) * egValue(s));
+}
+
 ///////////////////////////////////
 //// VALUE TYPE
 enum Value_Type : uint8_t {
@@ -549,6 +580,7 @@ ENABLE_FULL_OPERATORS_ON(Depth)
 ENABLE_FULL_OPERATORS_ON(Ply)
 ENABLE_FULL_OPERATORS_ON(Value)
 ENABLE_FULL_OPERATORS_ON(Direction)
+ENABLE_BASE_OPERATORS_ON(Score)
 ENABLE_INCR_OPERATORS_ON(PieceType)
 ENABLE_INCR_OPERATORS_ON(Piece)
 ENABLE_INCR_OPERATORS_ON(Color)
@@ -557,6 +589,12 @@ ENABLE_INCR_OPERATORS_ON(File)
 ENABLE_INCR_OPERATORS_ON(Rank)
 ENABLE_INCR_OPERATORS_ON(CastlingRights)
 
+// multiplication of both halves at once - division needs to unpack the score
+constexpr Score operator*(Score s, int i) { return static_cast<Score>(static_cast<int>(s) * i); }
+constexpr Score operator*(int i, Score s) { return s * i; }
+constexpr Score operator/(Score s, int i) { return makeScore(mgValue(s) / i, egValue(s) / i); }
+inline Score &operator*=(Score &s, int i) { return s = s * i; }
+
 #undef ENABLE_FULL_OPERATORS_ON
 #undef ENABLE_INCR_OPERATORS_ON
 #undef ENABLE_BASE_OPERATORS_ON
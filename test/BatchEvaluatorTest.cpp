@@ -0,0 +1,131 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include "types.h"
+#include "Logging.h"
+#include "Position.h"
+#include "PackedPosition.h"
+#include "Evaluator.h"
+#include "BatchEvaluator.h"
+#include "Test_Fens.h"
+
+using testing::Eq;
+
+class BatchEvaluatorTest : public ::testing::Test {
+public:
+  static void SetUpTestSuite() {
+    NEWLINE;
+    INIT::init();
+    NEWLINE;
+  }
+
+protected:
+  void SetUp() override {
+    Logger::get().TEST_LOG->set_level(spdlog::level::debug);
+  }
+
+  void TearDown() override {}
+
+  static std::vector<PackedPosition> packedFens() {
+    std::vector<PackedPosition> packed;
+    for (const std::string &fen : Test_Fens::getFENs()) {
+      const Position position(fen);
+      packed.push_back(PackedPosition::pack(position));
+    }
+    return packed;
+  }
+};
+
+TEST_F(BatchEvaluatorTest, setup) {
+  Position position;
+  for (const std::string &fen : Test_Fens::getFENs()) {
+    const Position expected(PackedPosition::pack(Position(fen)).fen());
+    position.setup(PackedPosition::pack(Position(fen)));
+    ASSERT_EQ(expected.printFen(), position.printFen());
+    ASSERT_EQ(expected.getZobristKey(), position.getZobristKey());
+    ASSERT_EQ(expected.getPawnKey(), position.getPawnKey());
+    ASSERT_EQ(expected.getMaterialKey(), position.getMaterialKey());
+    ASSERT_EQ(expected.getMaterialIndex(), position.getMaterialIndex());
+    ASSERT_EQ(expected.getPosScore(WHITE), position.getPosScore(WHITE));
+    ASSERT_EQ(expected.getPosScore(BLACK), position.getPosScore(BLACK));
+    ASSERT_EQ(expected.getGamePhase(), position.getGamePhase());
+    ASSERT_EQ(expected.hasCheck(), position.hasCheck());
+    ASSERT_EQ(MOVE_NONE, position.getLastMove());
+  }
+}
+
+TEST_F(BatchEvaluatorTest, evaluate) {
+  const std::vector<PackedPosition> packed = packedFens();
+  std::vector<Value> scores(packed.size());
+  for (std::size_t threads : {1, 3}) {
+    BatchEvaluator batch(threads);
+    batch.evaluate(packed.data(), packed.size(), scores.data());
+    Evaluator evaluator;
+    for (std::size_t i = 0; i < packed.size(); i++) {
+      ASSERT_EQ(evaluator.evaluate(Position(packed[i].fen())), scores[i]) << packed[i].fen();
+    }
+  }
+}
+
+TEST_F(BatchEvaluatorTest, setConfig) {
+  const std::vector<PackedPosition> packed = packedFens();
+  std::vector<Value> scores(packed.size());
+  std::vector<Value> noTempo(packed.size());
+  BatchEvaluator batch(2);
+  batch.evaluate(packed.data(), packed.size(), scores.data());
+  EvaluatorConfig config;
+  config.TEMPO = 0;
+  batch.setConfig(config);
+  batch.evaluate(packed.data(), packed.size(), noTempo.data());
+  int differences = 0;
+  for (std::size_t i = 0; i < packed.size(); i++) differences += scores[i] != noTempo[i];
+  ASSERT_GT(differences, 0);
+}
+
+TEST_F(BatchEvaluatorTest, throughput) {
+  using namespace std::chrono;
+  std::vector<PackedPosition> packed;
+  const std::vector<PackedPosition> fens = packedFens();
+  while (packed.size() < 200'000) packed.insert(packed.end(), fens.begin(), fens.end());
+  std::vector<Value> scores(packed.size());
+
+  // one Position from a FEN per evaluation
+  Evaluator evaluator;
+  int64_t sum = 0;
+  const auto start = high_resolution_clock::now();
+  for (const PackedPosition &p : packed) sum += evaluator.evaluate(Position(p.fen()));
+  const auto nanos = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count();
+  fprintln("{:>14}: {:n} positions/sec (checksum {})", "FEN",
+           static_cast<uint64_t>(packed.size() * 1e9 / nanos), sum);
+
+  for (std::size_t threads : {std::size_t(1), std::size_t(std::max(1u, std::thread::hardware_concurrency()))}) {
+    BatchEvaluator batch(threads);
+    batch.evaluate(packed.data(), packed.size(), scores.data());
+    fprintln("{:>11} {:2}: {:n} positions/sec {:n} positions/sec/core", "Batch", threads,
+             batch.positionsPerSecond(), batch.positionsPerSecondPerCore());
+  }
+}
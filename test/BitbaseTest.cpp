@@ -0,0 +1,192 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "Logging.h"
+#include "Bitbase.h"
+#include "Bitboards.h"
+#include "Position.h"
+#include "MoveGenerator.h"
+#include "Evaluator.h"
+#include "SearchConfig.h"
+#include "Search.h"
+
+using testing::Eq;
+
+class BitbaseTest : public ::testing::Test {
+public:
+  static void SetUpTestSuite() {
+    NEWLINE;
+    INIT::init();
+    NEWLINE;
+  }
+
+protected:
+  void SetUp() override {
+    Logger::get().TEST_LOG->set_level(spdlog::level::debug);
+    Logger::get().SEARCH_LOG->set_level(spdlog::level::info);
+    SearchConfig::USE_BOOK = false;
+  }
+
+  void TearDown() override {}
+};
+
+TEST_F(BitbaseTest, knownPositions) {
+  fprintln("KPK bitbase build time: {:n} ms", Bitbase::kpkBuildTime);
+
+  // king on the 6th rank in front of the pawn always wins
+  ASSERT_TRUE(Bitbase::probeKPK(Position("4k3/8/4K3/4P3/8/8/8/8 w - -")));
+  ASSERT_TRUE(Bitbase::probeKPK(Position("4k3/8/4K3/4P3/8/8/8/8 b - -")));
+
+  // pawn on 7th - stalemate or white wins by stepping aside
+  ASSERT_TRUE(Bitbase::probeKPK(Position("4k3/4P3/4K3/8/8/8/8/8 w - -")));
+  ASSERT_FALSE(Bitbase::probeKPK(Position("4k3/4P3/4K3/8/8/8/8/8 b - -")));
+
+  // pawn on 6th with the defending king in front
+  ASSERT_FALSE(Bitbase::probeKPK(Position("4k3/8/4P3/4K3/8/8/8/8 w - -")));
+
+  // opposition
+  ASSERT_FALSE(Bitbase::probeKPK(Position("8/8/8/8/8/4k3/4P3/4K3 w - -")));
+
+  // rook pawn with the defending king in the corner
+  ASSERT_FALSE(Bitbase::probeKPK(Position("k7/8/8/8/8/8/P7/7K w - -")));
+
+  // black king outside of the pawn's square
+  ASSERT_TRUE(Bitbase::probeKPK(Position("7k/8/8/8/8/8/P7/K7 w - -")));
+
+  // black can capture the undefended pawn
+  ASSERT_FALSE(Bitbase::probeKPK(Position("8/8/8/8/8/8/3kP3/7K b - -")));
+
+  // mirrored files and colors give the same results
+  ASSERT_TRUE(Bitbase::probeKPK(Position("8/8/8/8/3p4/3k4/8/3K4 w - -")) ==
+              Bitbase::probeKPK(Position("3k4/8/3K4/3P4/8/8/8/8 b - -")));
+  ASSERT_TRUE(Bitbase::probeKPK(Position("8/8/8/8/3p4/3k4/8/3K4 w - -")) ==
+              Bitbase::probeKPK(Position("4k3/8/4K3/4P3/8/8/8/8 b - -")));
+  ASSERT_FALSE(Bitbase::probeKPK(Position("7k/p7/8/8/8/8/8/K7 b - -")));
+
+  ASSERT_TRUE(Bitbase::isKPK(Position("8/8/8/8/3p4/3k4/8/3K4 w - -")));
+  ASSERT_FALSE(Bitbase::isKPK(Position("8/8/8/8/3p4/3k4/3P4/3K4 w - -")));
+  ASSERT_FALSE(Bitbase::isKPK(Position("8/8/8/8/3n4/3k4/8/3K4 w - -")));
+}
+
+/**
+ * Verifies the bitbase against its own moves for all positions with the
+ * pawn on d4: a position is won for white if one white move leads to a won
+ * position and for black if all black moves lead to won positions.
+ */
+TEST_F(BitbaseTest, consistency) {
+  MoveGenerator mg;
+  int positions = 0;
+  for (Square wk = SQ_A1; wk <= SQ_H8; ++wk) {
+    for (Square bk = SQ_A1; bk <= SQ_H8; ++bk) {
+      if (wk == SQ_D4 || bk == SQ_D4 || Bitboards::distance(wk, bk) <= 1) continue;
+      for (Color stm = WHITE; stm <= BLACK; ++stm) {
+        // the side not to move must not be in check
+        if (stm == WHITE && (Bitboards::pawnAttacks[WHITE][SQ_D4] & Bitboards::squareBB[bk])) continue;
+
+        std::string board(64, '1');
+        board[(7 - rankOf(wk)) * 8 + fileOf(wk)] = 'K';
+        board[(7 - rankOf(bk)) * 8 + fileOf(bk)] = 'k';
+        board[(7 - RANK_4) * 8 + FILE_D] = 'P';
+        std::string fen;
+        for (int r = 0; r < 8; ++r) {
+          fen += board.substr(r * 8, 8) + (r < 7 ? "/" : "");
+        }
+        fen += stm == WHITE ? " w - -" : " b - -";
+
+        Position position(fen);
+        const bool expected = Bitbase::probeKPK(position);
+        const MoveList moves = *mg.generateLegalMoves<MoveGenerator::GENALL>(position);
+        int wins = 0;
+        for (Move move : moves) {
+          position.doMove(move);
+          if (Bitbase::isKPK(position) && Bitbase::probeKPK(position)) wins++;
+          position.undoMove();
+        }
+        const bool actual = stm == WHITE ? wins > 0 : !moves.empty() && wins == static_cast<int>(moves.size());
+        ASSERT_EQ(expected, actual) << fen;
+        positions++;
+      }
+    }
+  }
+  fprintln("Verified {:n} positions", positions);
+}
+
+TEST_F(BitbaseTest, evaluator) {
+  Evaluator evaluator;
+  ASSERT_EQ(VALUE_DRAW, evaluator.evaluate(Position("4k3/4P3/4K3/8/8/8/8/8 b - -")));
+  ASSERT_GT(evaluator.evaluate(Position("4k3/8/4K3/4P3/8/8/8/8 w - -")), 500);
+  ASSERT_LT(evaluator.evaluate(Position("4k3/8/4K3/4P3/8/8/8/8 b - -")), -500);
+  ASSERT_LT(evaluator.evaluate(Position("8/8/8/8/3p4/3k4/8/3K4 w - -")), -500);
+}
+
+/**
+ * Compares the search tree size of K+P endgames with and without the
+ * bitbase draw cut in the search.
+ */
+TEST_F(BitbaseTest, searchNodes) {
+  const std::vector<std::string> fens = {
+    "8/8/8/8/8/4k3/4P3/4K3 w - -",
+    "8/8/8/8/8/4k3/4P3/4K3 b - -",
+    "k7/8/8/8/8/8/P7/7K w - -",
+    "8/8/8/2k5/8/8/3P4/3K4 w - -",
+    "8/8/1k6/8/8/8/5P2/5K2 b - -",
+    "8/8/8/8/3p4/8/8/K1k5 w - -",
+    "8/4k3/8/8/3K4/3P4/8/8 w - -",
+    "3k4/8/8/8/8/8/2KP4/8 b - -"
+  };
+
+  Search search;
+  SearchLimits searchLimits;
+  searchLimits.setDepth(14);
+
+  uint64_t nodesWith = 0, nodesWithout = 0;
+  for (const std::string &fen : fens) {
+    Position position(fen);
+
+    SearchConfig::USE_KPK_BITBASE = false;
+    search.clearHash();
+    search.startSearch(position, searchLimits);
+    search.waitWhileSearching();
+    const uint64_t without = search.getSearchStats().nodesVisited;
+    const Value valueWithout = search.getLastSearchResult().bestMoveValue;
+
+    SearchConfig::USE_KPK_BITBASE = true;
+    search.clearHash();
+    search.startSearch(position, searchLimits);
+    search.waitWhileSearching();
+    const uint64_t with = search.getSearchStats().nodesVisited;
+    const Value valueWith = search.getLastSearchResult().bestMoveValue;
+
+    fprintln("{:<32} without: {:>12n} ({:>5}) with: {:>12n} ({:>5}) draw cuts: {:n}",
+             fen, without, valueWithout, with, valueWith, search.getSearchStats().bitbaseDraws);
+    nodesWith += with;
+    nodesWithout += without;
+  }
+  fprintln("Nodes without bitbase: {:n} with bitbase: {:n} ({:.1f}%)",
+           nodesWithout, nodesWith, 100.0 * nodesWith / nodesWithout);
+  EXPECT_LT(nodesWith, nodesWithout);
+}
@@ -23,12 +23,15 @@
  *
  */
 
+#include <chrono>
 #include <gtest/gtest.h>
 #include <boost/timer/timer.hpp>
 #include "types.h"
 #include "Logging.h"
 #include "Evaluator.h"
+#include "Bitboards.h"
 #include "Position.h"
+#include "Material.h"
 #include "Test_Fens.h"
 
 using testing::Eq;
@@ -81,61 +84,125 @@ TEST_F(EvaluatorTest, evaluatePieceMobility) {
   evaluator.config.USE_PIECE_BONI = false;
 
   // start position
-  actual = evaluator.evaluatePiece<WHITE, KNIGHT>(position);
+  evaluator.computeAttacks(position);
+  actual = mgValue(evaluator.evaluatePiece<WHITE, KNIGHT>(position));
   ASSERT_EQ(4 * evaluator.config.MOBILITY_WEIGHT, actual);
-  actual = evaluator.evaluatePiece<BLACK, KNIGHT>(position);
+  actual = mgValue(evaluator.evaluatePiece<BLACK, KNIGHT>(position));
   ASSERT_EQ(4 * evaluator.config.MOBILITY_WEIGHT, actual);
-  actual = evaluator.evaluatePiece<WHITE, BISHOP>(position);
+  actual = mgValue(evaluator.evaluatePiece<WHITE, BISHOP>(position));
   ASSERT_EQ(0 * evaluator.config.MOBILITY_WEIGHT, actual);
-  actual = evaluator.evaluatePiece<BLACK, BISHOP>(position);
+  actual = mgValue(evaluator.evaluatePiece<BLACK, BISHOP>(position));
   ASSERT_EQ(0 * evaluator.config.MOBILITY_WEIGHT, actual);
-  actual = evaluator.evaluatePiece<WHITE, ROOK>(position);
+  actual = mgValue(evaluator.evaluatePiece<WHITE, ROOK>(position));
   ASSERT_EQ(0 * evaluator.config.MOBILITY_WEIGHT, actual);
-  actual = evaluator.evaluatePiece<BLACK, ROOK>(position);
+  actual = mgValue(evaluator.evaluatePiece<BLACK, ROOK>(position));
   ASSERT_EQ(0 * evaluator.config.MOBILITY_WEIGHT, actual);
-  actual = evaluator.evaluatePiece<WHITE, QUEEN>(position);
+  actual = mgValue(evaluator.evaluatePiece<WHITE, QUEEN>(position));
   ASSERT_EQ(0 * evaluator.config.MOBILITY_WEIGHT, actual);
-  actual = evaluator.evaluatePiece<BLACK, QUEEN>(position);
+  actual = mgValue(evaluator.evaluatePiece<BLACK, QUEEN>(position));
   ASSERT_EQ(0 * evaluator.config.MOBILITY_WEIGHT, actual);
 
   // total
   actual = 0;
-  actual += evaluator.evaluatePiece<WHITE, KNIGHT>(position) - evaluator.evaluatePiece<BLACK, KNIGHT>(position);
-  actual += evaluator.evaluatePiece<WHITE, BISHOP>(position) - evaluator.evaluatePiece<BLACK, BISHOP>(position);
-  actual += evaluator.evaluatePiece<WHITE, ROOK>(position) - evaluator.evaluatePiece<BLACK, ROOK>(position);
-  actual += evaluator.evaluatePiece<WHITE, QUEEN>(position) - evaluator.evaluatePiece<BLACK, QUEEN>(position);
+  actual += mgValue(evaluator.evaluatePiece<WHITE, KNIGHT>(position) - evaluator.evaluatePiece<BLACK, KNIGHT>(position));
+  actual += mgValue(evaluator.evaluatePiece<WHITE, BISHOP>(position) - evaluator.evaluatePiece<BLACK, BISHOP>(position));
+  actual += mgValue(evaluator.evaluatePiece<WHITE, ROOK>(position) - evaluator.evaluatePiece<BLACK, ROOK>(position));
+  actual += mgValue(evaluator.evaluatePiece<WHITE, QUEEN>(position) - evaluator.evaluatePiece<BLACK, QUEEN>(position));
   ASSERT_EQ(0 * evaluator.config.MOBILITY_WEIGHT, actual);
 
   // complex pos
   fen = "r3k2r/1ppn3p/2q1q1nb/4P2N/2q1Pp2/B5R1/pbp2PPP/1R4K1 w kq - 0 1";
   position = Position(fen);
-  actual = evaluator.evaluatePiece<WHITE, KNIGHT>(position);
+  evaluator.computeAttacks(position);
+  actual = mgValue(evaluator.evaluatePiece<WHITE, KNIGHT>(position));
   ASSERT_EQ(3 * evaluator.config.MOBILITY_WEIGHT, actual);
-  actual = evaluator.evaluatePiece<BLACK, KNIGHT>(position);
+  actual = mgValue(evaluator.evaluatePiece<BLACK, KNIGHT>(position));
   ASSERT_EQ(10 * evaluator.config.MOBILITY_WEIGHT, actual);
-  actual = evaluator.evaluatePiece<WHITE, BISHOP>(position);
+  actual = mgValue(evaluator.evaluatePiece<WHITE, BISHOP>(position));
   ASSERT_EQ(6 * evaluator.config.MOBILITY_WEIGHT, actual);
-  actual = evaluator.evaluatePiece<BLACK, BISHOP>(position);
+  actual = mgValue(evaluator.evaluatePiece<BLACK, BISHOP>(position));
   ASSERT_EQ(9 * evaluator.config.MOBILITY_WEIGHT, actual);
-  actual = evaluator.evaluatePiece<WHITE, ROOK>(position);
+  actual = mgValue(evaluator.evaluatePiece<WHITE, ROOK>(position));
   ASSERT_EQ(15 * evaluator.config.MOBILITY_WEIGHT, actual);
-  actual = evaluator.evaluatePiece<BLACK, ROOK>(position);
+  actual = mgValue(evaluator.evaluatePiece<BLACK, ROOK>(position));
   ASSERT_EQ(10 * evaluator.config.MOBILITY_WEIGHT, actual);
-  actual = evaluator.evaluatePiece<WHITE, QUEEN>(position);
+  actual = mgValue(evaluator.evaluatePiece<WHITE, QUEEN>(position));
   ASSERT_EQ(0 * evaluator.config.MOBILITY_WEIGHT, actual);
-  actual = evaluator.evaluatePiece<BLACK, QUEEN>(position);
+  actual = mgValue(evaluator.evaluatePiece<BLACK, QUEEN>(position));
   ASSERT_EQ(31 * evaluator.config.MOBILITY_WEIGHT, actual);
+  // mobility does not depend on the game phase
+  ASSERT_EQ(makeScore(actual, actual), (evaluator.evaluatePiece<BLACK, QUEEN>(position)));
 
   // total
   actual = 0;
-  actual += evaluator.evaluatePiece<WHITE, KNIGHT>(position) - evaluator.evaluatePiece<BLACK, KNIGHT>(position);
-  actual += evaluator.evaluatePiece<WHITE, BISHOP>(position) - evaluator.evaluatePiece<BLACK, BISHOP>(position);
-  actual += evaluator.evaluatePiece<WHITE, ROOK>(position) - evaluator.evaluatePiece<BLACK, ROOK>(position);
-  actual += evaluator.evaluatePiece<WHITE, QUEEN>(position) - evaluator.evaluatePiece<BLACK, QUEEN>(position);
+  actual += mgValue(evaluator.evaluatePiece<WHITE, KNIGHT>(position) - evaluator.evaluatePiece<BLACK, KNIGHT>(position));
+  actual += mgValue(evaluator.evaluatePiece<WHITE, BISHOP>(position) - evaluator.evaluatePiece<BLACK, BISHOP>(position));
+  actual += mgValue(evaluator.evaluatePiece<WHITE, ROOK>(position) - evaluator.evaluatePiece<BLACK, ROOK>(position));
+  actual += mgValue(evaluator.evaluatePiece<WHITE, QUEEN>(position) - evaluator.evaluatePiece<BLACK, QUEEN>(position));
   ASSERT_EQ(-36 * evaluator.config.MOBILITY_WEIGHT, actual);
 }
 
 
+TEST_F(EvaluatorTest, attacks) {
+  Position position;
+  Evaluator evaluator;
+
+  // start position
+  evaluator.computeAttacks(position);
+  ASSERT_EQ(Bitboards::Rank3BB, evaluator.attacks.byType[WHITE][PAWN]);
+  ASSERT_EQ(Bitboards::Rank6BB, evaluator.attacks.byType[BLACK][PAWN]);
+  ASSERT_EQ(SQ_A3 | SQ_C3 | SQ_F3 | SQ_H3 | SQ_D2 | SQ_E2, evaluator.attacks.byType[WHITE][KNIGHT]);
+  ASSERT_EQ(Bitboards::Rank3BB | Bitboards::Rank2BB | (Bitboards::Rank1BB & ~(SQ_A1 | SQ_H1)), evaluator.attacks.all[WHITE]);
+  // e2 is defended by king, queen, bishop and knight
+  ASSERT_TRUE(evaluator.attacks.twice[WHITE] & SQ_E2);
+  ASSERT_FALSE(evaluator.attacks.twice[WHITE] & SQ_B1);
+  ASSERT_TRUE(evaluator.attacks.twice[WHITE] & SQ_C3);
+
+  // attack maps of every piece agree with the attacks of the position
+  for (const std::string &fen : Test_Fens::getFENs()) {
+    position = Position(fen);
+    evaluator.computeAttacks(position);
+    for (Color c = WHITE; c <= BLACK; ++c) {
+      Bitboard all = Bitboards::EMPTY_BB;
+      Bitboard twice = Bitboards::EMPTY_BB;
+      for (Square sq = SQ_A1; sq <= SQ_H8; ++sq) {
+        const int attackers = Bitboards::popcount(position.attacksTo(sq, position.getOccupiedBB()) & position.getOccupiedBB(c));
+        if (attackers) all |= sq;
+        if (attackers > 1) twice |= sq;
+      }
+      ASSERT_EQ(all, evaluator.attacks.all[c]) << fen;
+      ASSERT_EQ(twice, evaluator.attacks.twice[c]) << fen;
+    }
+  }
+}
+
+TEST_F(EvaluatorTest, threats) {
+  Evaluator evaluator;
+  evaluator.config.USE_THREATS = true;
+  evaluator.config.HANGING_PIECE_PENALTY = -20;
+  evaluator.config.THREAT_BY_PAWN_PENALTY = -30;
+  evaluator.config.THREAT_BY_MINOR_PENALTY = -15;
+
+  // black knight on d5 is attacked by the c4 pawn and the white bishop on
+  // c8 attacks the black rook on a6 - the black pieces are undefended, the
+  // undefended white bishop is not attacked
+  Position position("2B1k3/8/r7/3n4/2P5/8/8/4K3 w - -");
+  evaluator.computeAttacks(position);
+  ASSERT_EQ(SCORE_ZERO, evaluator.evaluateThreats<WHITE>(position));
+  const int expected = 2 * evaluator.config.HANGING_PIECE_PENALTY
+                       + evaluator.config.THREAT_BY_PAWN_PENALTY
+                       + evaluator.config.THREAT_BY_MINOR_PENALTY;
+  ASSERT_EQ(makeScore(expected, expected), evaluator.evaluateThreats<BLACK>(position));
+
+  // defended pieces are not hanging
+  position = Position("2B1k3/8/r3p3/3n4/2P5/8/8/4K3 w - -");
+  evaluator.computeAttacks(position);
+  const int defended = evaluator.config.HANGING_PIECE_PENALTY
+                       + evaluator.config.THREAT_BY_PAWN_PENALTY
+                       + evaluator.config.THREAT_BY_MINOR_PENALTY;
+  ASSERT_EQ(makeScore(defended, defended), evaluator.evaluateThreats<BLACK>(position));
+}
+
 TEST_F(EvaluatorTest, evaluatePawns) {
   Position position;
   Evaluator evaluator;
@@ -146,9 +213,9 @@ TEST_F(EvaluatorTest, evaluatePawns) {
   evaluator.config.USE_PAWN_TABLE = true;
 
   // start position
-  actual = evaluator.pawnEval(position);
+  actual = taper(evaluator.pawnEval(position), position.getGamePhaseFactor());
   ASSERT_EQ(0, actual);
-  actual = evaluator.pawnEval(position);
+  actual = taper(evaluator.pawnEval(position), position.getGamePhaseFactor());
   ASSERT_EQ(0, actual);
 
   NEWLINE;
@@ -156,12 +223,76 @@ TEST_F(EvaluatorTest, evaluatePawns) {
   // complex pos
   fen = "r3k2r/1ppn3p/2q1q1nb/4P2N/2q1Pp2/B5RP/pbp2PP1/1R4K1 w kq - 0 1";
   position = Position(fen);
-  actual = evaluator.pawnEval(position);
+  actual = taper(evaluator.pawnEval(position), position.getGamePhaseFactor());
   ASSERT_EQ(-15, actual);
-  actual = evaluator.pawnEval(position);
+  actual = taper(evaluator.pawnEval(position), position.getGamePhaseFactor());
   ASSERT_EQ(-15, actual);
 }
 
+namespace {
+  // pawn by pawn classification with the per square masks as reference for
+  // the set-wise classification
+  Evaluator::PawnStructure pawnStructureLoop(const Color color, const Bitboard myPawns, const Bitboard oppPawns) {
+    using namespace Bitboards;
+    Evaluator::PawnStructure ps;
+    Bitboard pawns = myPawns;
+    while (pawns) {
+      const Square sq = popLSB(pawns);
+      const Bitboard neighbours = myPawns & neighbourFilesMask[sq];
+      ps.isolated |= neighbours ? EMPTY_BB : squareBB[sq];
+      ps.doubled |= ~squareBB[sq] & myPawns & sqToFileBB[sq];
+      ps.passed |= ((myPawns & sqToFileBB[sq]) | oppPawns) & passedPawnMask[color][sq] ? EMPTY_BB : squareBB[sq];
+      ps.blocked |= ((myPawns & sqToFileBB[sq]) | oppPawns) & rays[color == WHITE ? N : S][sq] ? squareBB[sq] : EMPTY_BB;
+      ps.phalanx |= myPawns & neighbours & sqToRankBB[sq];
+      ps.supported |= myPawns & neighbours & sqToRankBB[sq + (color == WHITE ? NORTH : SOUTH)];
+    }
+    return ps;
+  }
+}
+
+TEST_F(EvaluatorTest, pawnStructure) {
+  using namespace std::chrono;
+  std::vector<Position> positions;
+  for (const std::string &fen : Test_Fens::getFENs()) positions.emplace_back(fen);
+  positions.emplace_back("4k3/1p1p2pp/1P1P4/p3pP1P/P3P3/2p5/2P1P3/4K3 w - -");
+
+  for (const Position &position : positions) {
+    for (Color c = WHITE; c <= BLACK; ++c) {
+      const Bitboard myPawns = position.getPieceBB(c, PAWN);
+      const Bitboard oppPawns = position.getPieceBB(~c, PAWN);
+      const Evaluator::PawnStructure expected = pawnStructureLoop(c, myPawns, oppPawns);
+      const Evaluator::PawnStructure actual = Evaluator::pawnStructure(c, myPawns, oppPawns);
+      ASSERT_EQ(expected.isolated, actual.isolated) << position.printFen();
+      ASSERT_EQ(expected.doubled, actual.doubled) << position.printFen();
+      ASSERT_EQ(expected.passed, actual.passed) << position.printFen();
+      ASSERT_EQ(expected.blocked, actual.blocked) << position.printFen();
+      ASSERT_EQ(expected.phalanx, actual.phalanx) << position.printFen();
+      ASSERT_EQ(expected.supported, actual.supported) << position.printFen();
+    }
+  }
+
+  // microbenchmark
+  constexpr int ROUNDS = 2'000;
+  auto run = [&](const char* name, auto &&classify) {
+    Bitboard checksum = 0;
+    const auto start = high_resolution_clock::now();
+    for (int r = 0; r < ROUNDS; r++) {
+      for (const Position &position : positions) {
+        for (Color c = WHITE; c <= BLACK; ++c) {
+          const Evaluator::PawnStructure ps = classify(c, position.getPieceBB(c, PAWN), position.getPieceBB(~c, PAWN));
+          checksum += ps.isolated ^ ps.doubled ^ ps.passed ^ ps.blocked ^ ps.phalanx ^ ps.supported;
+        }
+      }
+    }
+    const auto nanos = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count();
+    const auto calls = 2ULL * ROUNDS * positions.size();
+    fprintln("{:>9}: {:n} classifications in {:n} ms = {:n} ns each (checksum {})", name, calls,
+             nanos / 1'000'000, nanos / calls, checksum);
+  };
+  run("per pawn", pawnStructureLoop);
+  run("set-wise", Evaluator::pawnStructure);
+}
+
 TEST_F(EvaluatorTest, pieceBoni) {
   Position position;
   Evaluator evaluator;
@@ -175,6 +306,8 @@ TEST_F(EvaluatorTest, pieceBoni) {
   evaluator.config.USE_MOBILITY = false;
   evaluator.config.USE_PIECE_BONI = true;
   evaluator.config.USE_KING_CASTLE_SAFETY = false;
+  evaluator.config.USE_KING_ATTACKS = false;
+  evaluator.config.USE_THREATS = false;
   evaluator.config.TEMPO = 0;
 
   // start position
@@ -204,6 +337,8 @@ TEST_F(EvaluatorTest, kingCastleSafety) {
   evaluator.config.USE_MOBILITY = false;
   evaluator.config.USE_PIECE_BONI = false;
   evaluator.config.USE_KING_CASTLE_SAFETY = true;
+  evaluator.config.USE_KING_ATTACKS = false;
+  evaluator.config.USE_THREATS = false;
   evaluator.config.TEMPO = 0;
 
   // start position
@@ -217,6 +352,19 @@ TEST_F(EvaluatorTest, kingCastleSafety) {
   position = Position(fen);
   actual = evaluator.evaluate(position);
   ASSERT_EQ(50, actual);
+
+  // the queen attacks f7 and h7 next to the black king
+  position = Position("6k1/5ppp/8/7Q/8/8/5PPP/6K1 w - -");
+  const Value withoutAttacks = evaluator.evaluate(position);
+  evaluator.config.USE_KING_ATTACKS = true;
+  evaluator.config.KING_ZONE_ATTACK_PENALTY = -10;
+  ASSERT_GT(evaluator.evaluate(position), withoutAttacks);
+
+  // attacks on the king zone are part of the king castle safety
+  evaluator.config.USE_KING_CASTLE_SAFETY = false;
+  const Value noSafety = evaluator.evaluate(position);
+  evaluator.config.USE_KING_ATTACKS = false;
+  ASSERT_EQ(noSafety, evaluator.evaluate(position));
 }
 
 TEST_F(EvaluatorTest, total) {
@@ -239,6 +387,148 @@ TEST_F(EvaluatorTest, total) {
 }
 
 
+TEST_F(EvaluatorTest, evalCache) {
+  Evaluator evaluator;
+  evaluator.resizeEvalCache(2);
+  Evaluator noCache;
+  noCache.config.USE_EVAL_CACHE = false;
+
+  Position position("r3k2r/1ppn3p/2q1q1n1/8/2q1Pp2/6R1/p1p2PPP/1R4K1 b kq e3");
+  const Value value = noCache.evaluate(position);
+  ASSERT_EQ(value, evaluator.evaluate(position));
+  ASSERT_EQ(value, evaluator.evaluate(position));
+  LOG__INFO(Logger::get().TEST_LOG, evaluator.evalCacheStats());
+  ASSERT_NE(std::string::npos, evaluator.evalCacheStats().find("hits 1 misses 1 hit rate 50.0%"));
+
+  // transposed positions are found in the cache with the same value
+  for (const std::string &fen : Test_Fens::getFENs()) {
+    position = Position(fen);
+    ASSERT_EQ(noCache.evaluate(position), evaluator.evaluate(position)) << fen;
+    ASSERT_EQ(noCache.evaluate(position), evaluator.evaluate(position)) << fen;
+  }
+
+  // a config change needs a cleared cache
+  evaluator.config.USE_MOBILITY = false;
+  evaluator.clearEvalCache();
+  noCache.config.USE_MOBILITY = false;
+  position = Position("r3k2r/1ppn3p/2q1q1n1/8/2q1Pp2/6R1/p1p2PPP/1R4K1 b kq e3");
+  ASSERT_EQ(noCache.evaluate(position), evaluator.evaluate(position));
+
+  // size 0 turns the cache off
+  evaluator.resizeEvalCache(0);
+  ASSERT_EQ(noCache.evaluate(position), evaluator.evaluate(position));
+  ASSERT_NE(std::string::npos, evaluator.evalCacheStats().find("capacity 0 hits 0 misses 0"));
+}
+
+TEST_F(EvaluatorTest, lazyEval) {
+  Evaluator evaluator;
+  Evaluator full;
+  full.config.USE_LAZY_EVAL = false;
+  const int margin = evaluator.config.LAZY_EVAL_MARGIN;
+
+  // a full window never allows a lazy exit
+  Position position("r3k2r/1ppn3p/2q1q1n1/8/2q1Pp2/6R1/p1p2PPP/1R4K1 b kq e3");
+  ASSERT_EQ(full.evaluate(position), evaluator.evaluate(position));
+  ASSERT_FALSE(evaluator.wasLazy());
+
+  // a lazy value must lie on the same side of the window as the full
+  // evaluation and is off by less than the margin
+  int lazyCount = 0;
+  int maxError = 0;
+  for (const std::string &fen : Test_Fens::getFENs()) {
+    position = Position(fen);
+    const Value value = full.evaluate(position);
+    for (int window : {-600, -400, -200, 0, 200, 400, 600}) {
+      const auto alpha = static_cast<Value>(window - 50);
+      const auto beta = static_cast<Value>(window + 50);
+      const Value lazyValue = evaluator.evaluate(position, alpha, beta);
+      if (!evaluator.wasLazy()) {
+        ASSERT_EQ(value, lazyValue) << fen;
+        continue;
+      }
+      lazyCount++;
+      maxError = std::max(maxError, std::abs(value - lazyValue));
+      if (lazyValue <= alpha) EXPECT_LE(value, alpha) << fen;
+      else EXPECT_GE(value, beta) << fen;
+    }
+  }
+  LOG__INFO(Logger::get().TEST_LOG, "Lazy evaluations {} max error {} ({})", lazyCount, maxError, evaluator.lazyEvalStats());
+  EXPECT_GT(lazyCount, 0);
+  EXPECT_LT(maxError, margin);
+}
+
+TEST_F(EvaluatorTest, staticPolicy) {
+  using namespace std::chrono;
+  std::vector<Position> positions;
+  for (const std::string &fen : Test_Fens::getFENs()) positions.emplace_back(fen);
+
+  // same values with the default config
+  Evaluator tunable;
+  Evaluator fixed;
+  ASSERT_FALSE(tunable.isStatic());
+  fixed.updatePolicy();
+  ASSERT_TRUE(fixed.isStatic());
+  for (const Position &p : positions) {
+    ASSERT_EQ(tunable.evaluate(p), fixed.evaluate(p)) << p.printFen();
+  }
+
+  // a changed config falls back to the runtime evaluation
+  tunable.config.USE_MOBILITY = fixed.config.USE_MOBILITY = false;
+  fixed.updatePolicy();
+  ASSERT_FALSE(fixed.isStatic());
+  Position position("r3k2r/1ppn3p/2q1q1n1/8/2q1Pp2/6R1/p1p2PPP/1R4K1 b kq e3");
+  ASSERT_EQ(tunable.evaluate(position), fixed.evaluate(position));
+  tunable.config.USE_MOBILITY = fixed.config.USE_MOBILITY = true;
+  fixed.updatePolicy();
+  ASSERT_TRUE(fixed.isStatic());
+
+  constexpr int ROUNDS = 500;
+  for (Evaluator* evaluator : {&tunable, &fixed}) {
+    int64_t sum = 0;
+    const auto start = high_resolution_clock::now();
+    for (int r = 0; r < ROUNDS; r++) {
+      for (const Position &p : positions) sum += evaluator->evaluate(p);
+    }
+    const auto nanos = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count();
+    const auto evals = ROUNDS * positions.size();
+    fprintln("{:>8}: {:n} evals in {:n} ms = {:n} evals/sec (checksum {})",
+             evaluator->isStatic() ? "Static" : "Tunable", evals, nanos / 1'000'000,
+             static_cast<uint64_t>(evals * 1e9 / nanos), sum);
+  }
+}
+
+TEST_F(EvaluatorTest, trace) {
+  Evaluator evaluator;
+  EvalTrace trace;
+  for (const std::string &fen : Test_Fens::getFENs()) {
+    const Position position(fen);
+    const Value value = evaluator.trace(position, trace);
+    ASSERT_EQ(evaluator.evaluate(position), value) << fen;
+    ASSERT_EQ(value, trace.value) << fen;
+    if (!trace.shortcut.empty()) continue;
+    // the terms add up to the value (up to rounding when tapering)
+    Score sum = SCORE_ZERO;
+    for (int t = EvalTrace::MATERIAL; t < EvalTrace::TERM_LENGTH; t++) sum += trace.total(EvalTrace::Term(t));
+    int expected = taper(sum, trace.gamePhaseFactor) * trace.scale / Material::SCALE_NORMAL;
+    if (position.getNextPlayer() == BLACK) expected = -expected;
+    ASSERT_NEAR(expected + trace.tempo, value, 3) << fen << "\n" << trace.str();
+  }
+
+  Position position("r3k2r/1ppn3p/2q1q1n1/8/2q1Pp2/6R1/p1p2PPP/1R4K1 b kq e3");
+  evaluator.trace(position, trace);
+  LOG__INFO(Logger::get().TEST_LOG, "\n{}", trace.str());
+  ASSERT_EQ(position.getMaterial(WHITE), mgValue(trace.scores[EvalTrace::MATERIAL][WHITE]));
+  ASSERT_EQ(position.getMaterial(BLACK), mgValue(trace.scores[EvalTrace::MATERIAL][BLACK]));
+  ASSERT_EQ(position.getPosScore(WHITE), trace.scores[EvalTrace::PSQT][WHITE]);
+
+  // values which are not computed from the terms
+  evaluator.trace(Position("8/8/8/4k3/8/8/4P3/4K3 w - -"), trace);
+  ASSERT_EQ("KPK bitbase", trace.shortcut);
+  evaluator.trace(Position("8/8/8/4k3/8/8/4B3/4K3 w - -"), trace);
+  ASSERT_EQ("insufficient material", trace.shortcut);
+  ASSERT_EQ(VALUE_DRAW, trace.value);
+}
+
 TEST_F(EvaluatorTest, fens) {
   using namespace boost::timer;
   Position position;
@@ -255,6 +545,8 @@ TEST_F(EvaluatorTest, fens) {
   evaluator.config.USE_MOBILITY = true;
   evaluator.config.USE_PIECE_BONI = true;
   evaluator.config.USE_KING_CASTLE_SAFETY = true;
+  evaluator.config.USE_KING_ATTACKS = true;
+  evaluator.config.USE_THREATS = true;
   evaluator.resizePawnTable(evaluator.config.PAWN_TABLE_SIZE);
 
   auto iterEnd = NUMBER_OF_FENS > fens.size() ? fens.end() : fens.begin() + NUMBER_OF_FENS;
@@ -224,3 +224,22 @@ TEST_F(FifoTest, popWaitCancel) {
   t.join();
 }
 
+
+TEST_F(FifoTest, bounded) {
+  Fifo<std::string> fifo1(10);
+  auto t = std::thread([&] {
+    for (int i = 0; i < 1'000; ++i) {
+      fifo1.push(std::to_string(i));
+    }
+  });
+  // the producer has to wait for the consumer
+  sleepForSec(1);
+  EXPECT_EQ(10, fifo1.size());
+  for (int i = 0; i < 1'000; ++i) {
+    auto s = fifo1.pop_wait();
+    EXPECT_EQ(std::to_string(i), s);
+    EXPECT_LE(fifo1.size(), 10);
+  }
+  t.join();
+  EXPECT_TRUE(fifo1.empty());
+}
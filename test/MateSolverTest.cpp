@@ -0,0 +1,104 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#include <chrono>
+#include <gtest/gtest.h>
+
+#include "Logging.h"
+#include "MateSolver.h"
+#include "Position.h"
+
+using testing::Eq;
+
+class MateSolverTest : public ::testing::Test {
+public:
+  static void SetUpTestSuite() {
+    NEWLINE;
+    INIT::init();
+    NEWLINE;
+  }
+
+protected:
+  void SetUp() override {
+    Logger::get().TEST_LOG->set_level(spdlog::level::debug);
+    Logger::get().SEARCH_LOG->set_level(spdlog::level::info);
+  }
+
+  void TearDown() override {}
+};
+
+TEST_F(MateSolverTest, mates) {
+  MateSolver solver(16);
+
+  // mate in 1
+  Position position("6k1/5ppp/8/8/8/8/8/R5K1 w - -");
+  ASSERT_EQ(VALUE_CHECKMATE - 1, solver.solve(position, 3, nullptr));
+  ASSERT_EQ("a1a8", printMoveListUCI(solver.getPV()));
+
+  // KRK mate in 4
+  solver.clear();
+  position = Position("8/8/8/8/8/3K4/R7/5k2 w - -");
+  ASSERT_EQ(VALUE_CHECKMATE - 7, solver.solve(position, 4, nullptr));
+  // the pv follows the longest defense
+  ASSERT_EQ(7, solver.getPV().size());
+  fprintln("KRK mate in 4: {} ({:n} nodes)", printMoveListUCI(solver.getPV()), solver.getNodes());
+
+  // black to move mate in 4
+  solver.clear();
+  position = Position("r3r3/p1p2p1k/3p2pp/2p5/2P2n2/2N2B2/PPR1PP1q/3RQK2 b - -");
+  const auto start = std::chrono::steady_clock::now();
+  const Value value = solver.solve(position, 4, nullptr);
+  const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  fprintln("Mate in 4: {} {} ({:n} nodes, {:n} ms)", value, printMoveListUCI(solver.getPV()), solver.getNodes(), ms);
+  ASSERT_EQ(VALUE_CHECKMATE - 7, value);
+  ASSERT_EQ(7, solver.getPV().size());
+}
+
+TEST_F(MateSolverTest, noMate) {
+  MateSolver solver(16);
+
+  // no mate in the start position
+  Position position;
+  ASSERT_EQ(VALUE_NONE, solver.solve(position, 3, nullptr));
+  ASSERT_TRUE(solver.getPV().empty());
+
+  // stalemate is not a mate
+  position = Position("7k/8/6QK/8/8/8/8/8 b - -");
+  ASSERT_EQ(VALUE_NONE, solver.solve(position, 2, nullptr));
+
+  // the side to move is mated
+  position = Position("R5k1/5ppp/8/8/8/8/8/6K1 b - -");
+  ASSERT_EQ(VALUE_NONE, solver.solve(position, 2, nullptr));
+}
+
+TEST_F(MateSolverTest, stop) {
+  MateSolver solver(16);
+  Position position;
+  uint64_t calls = 0;
+  ASSERT_EQ(VALUE_NONE, solver.solve(position, 5, [&calls] { return ++calls > 1000; }));
+  ASSERT_TRUE(solver.wasAborted());
+  ASSERT_EQ(1001, calls);
+}
@@ -0,0 +1,159 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include "types.h"
+#include "Logging.h"
+#include "Material.h"
+#include "Position.h"
+#include "Evaluator.h"
+#include "Test_Fens.h"
+
+using testing::Eq;
+
+class MaterialTest : public ::testing::Test {
+public:
+  static void SetUpTestSuite() {
+    NEWLINE;
+    INIT::init();
+    NEWLINE;
+  }
+
+protected:
+  void SetUp() override {
+    Logger::get().TEST_LOG->set_level(spdlog::level::debug);
+  }
+
+  void TearDown() override {}
+
+  static const Material::Entry* probe(const char* fen) {
+    return Position(fen).getMaterialEntry();
+  }
+};
+
+TEST_F(MaterialTest, gamePhase) {
+  for (const std::string &fen : Test_Fens::getFENs()) {
+    Position position(fen);
+    ASSERT_FLOAT_EQ(position.getGamePhaseFactor(),
+                    position.getMaterialEntry()->gamePhaseFactor) << fen;
+  }
+}
+
+TEST_F(MaterialTest, tableIndex) {
+  // the incremental table index finds the entry computed from the counts
+  for (const std::string &fen : Test_Fens::getFENs()) {
+    Position position(fen);
+    const Material::Entry* entry = position.getMaterialEntry();
+    const Material::Entry* computed = Material::compute(position.getMaterialKey());
+    ASSERT_EQ(computed->imbalance, entry->imbalance) << fen;
+    ASSERT_FLOAT_EQ(computed->gamePhaseFactor, entry->gamePhaseFactor) << fen;
+    ASSERT_EQ(computed->scale[WHITE], entry->scale[WHITE]) << fen;
+    ASSERT_EQ(computed->scale[BLACK], entry->scale[BLACK]) << fen;
+    ASSERT_EQ(computed->draw, entry->draw) << fen;
+    ASSERT_EQ(computed->endgame, entry->endgame) << fen;
+  }
+  // counts beyond the table
+  ASSERT_FALSE(Material::inTable(Position("8/3k4/8/8/8/8/2QQK3/8 w - -").getMaterialKey()));
+  ASSERT_FALSE(Material::inTable(Position("8/3k4/8/8/8/8/1NNNK3/8 w - -").getMaterialKey()));
+  ASSERT_FALSE(Material::inTable(Position("8/2rrrk2/8/8/8/8/4K3/8 w - -").getMaterialKey()));
+  ASSERT_TRUE(Material::inTable(Position("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -").getMaterialKey()));
+}
+
+TEST_F(MaterialTest, draws) {
+  ASSERT_EQ(Material::DRAW_ALWAYS, probe("8/3k4/8/8/8/8/4K3/8 w - -")->draw);
+  ASSERT_EQ(Material::DRAW_ALWAYS, probe("8/3k4/8/8/8/8/4KB2/8 w - -")->draw);
+  ASSERT_EQ(Material::DRAW_NO_FORCED_MATE, probe("8/1nnk4/8/8/8/8/4K3/8 w - -")->draw);
+  ASSERT_EQ(Material::DRAW_SAME_COLORED_BISHOPS, probe("8/3k2b1/8/8/8/8/4K1B1/8 w - -")->draw);
+  ASSERT_EQ(Material::DRAW_NONE, probe("8/3k4/8/8/8/8/4KBB1/8 w - -")->draw);
+  ASSERT_EQ(Material::DRAW_NONE, probe("8/3k4/8/8/8/8/4KBN1/8 w - -")->draw);
+  ASSERT_EQ(Material::DRAW_NONE, probe("8/3k4/8/8/8/8/4KP2/8 w - -")->draw);
+  ASSERT_EQ(Material::DRAW_NONE, probe(START_POSITION_FEN)->draw);
+}
+
+TEST_F(MaterialTest, endgames) {
+  const Material::Entry* entry = probe("8/8/8/8/8/3k4/1p6/4K3 w - -");
+  ASSERT_EQ(Material::ENDGAME_KPK, entry->endgame);
+  ASSERT_EQ(BLACK, entry->strongSide);
+
+  entry = probe("8/3k4/8/8/8/8/4KR2/8 w - -");
+  ASSERT_EQ(Material::ENDGAME_KXK, entry->endgame);
+  ASSERT_EQ(WHITE, entry->strongSide);
+
+  // promotions beyond the precomputed counts are computed on the fly
+  entry = probe("8/3k4/8/8/8/8/2QQK3/8 w - -");
+  ASSERT_EQ(Material::ENDGAME_KXK, entry->endgame);
+
+  ASSERT_EQ(Material::ENDGAME_NONE, probe("8/3k4/8/8/8/8/3PKP2/8 w - -")->endgame);
+  ASSERT_EQ(Material::ENDGAME_NONE, probe("8/3k4/8/8/8/8/4KB2/8 w - -")->endgame);
+  ASSERT_EQ(Material::ENDGAME_NONE, probe(START_POSITION_FEN)->endgame);
+}
+
+TEST_F(MaterialTest, scaleAndImbalance) {
+  // KRKB - hardly winnable
+  const Material::Entry* entry = probe("8/3kb3/8/8/8/8/4KR2/8 w - -");
+  ASSERT_GT(Material::SCALE_NORMAL, entry->scale[WHITE]);
+  ASSERT_EQ(0, entry->scale[BLACK]);
+
+  // KQKR - winnable
+  entry = probe("8/3kr3/8/8/8/8/4KQ2/8 w - -");
+  ASSERT_EQ(Material::SCALE_NORMAL, entry->scale[WHITE]);
+
+  // symmetric material has no imbalance
+  ASSERT_EQ(SCORE_ZERO, probe(START_POSITION_FEN)->imbalance);
+
+  // knights get better with more pawns - rooks worse
+  ASSERT_GT(mgValue(probe("4k3/pppppp2/8/8/8/8/PPPPPPPP/1N2K3 w - -")->imbalance),
+            mgValue(probe("4k3/pppppp2/8/8/8/8/PPPPPP2/1N2K3 w - -")->imbalance));
+  ASSERT_LT(mgValue(probe("4k3/pppppp2/8/8/8/8/PPPPPPPP/R3K3 w - -")->imbalance),
+            mgValue(probe("4k3/pppppp2/8/8/8/8/PPPPPP2/R3K3 w - -")->imbalance));
+}
+
+TEST_F(MaterialTest, evaluation) {
+  Evaluator evaluator;
+  // KRK is a win for white regardless of the side to move
+  ASSERT_GT(evaluator.evaluate(Position("8/3k4/8/8/8/8/4KR2/8 w - -")), 1000);
+  ASSERT_LT(evaluator.evaluate(Position("8/3k4/8/8/8/8/4KR2/8 b - -")), -1000);
+  // the bare king at the edge is better for the strong side
+  ASSERT_GT(evaluator.evaluate(Position("3k4/8/8/8/8/8/4KR2/8 w - -")),
+            evaluator.evaluate(Position("8/8/8/3k4/8/8/4KR2/8 w - -")));
+  // same colored bishops are a draw
+  ASSERT_EQ(VALUE_DRAW, evaluator.evaluate(Position("8/3k1b2/8/8/8/8/4K1B1/8 w - -")));
+}
+
+TEST_F(MaterialTest, probeTime) {
+  using namespace std::chrono;
+  std::vector<Position> positions;
+  for (const std::string &fen : Test_Fens::getFENs()) positions.emplace_back(fen);
+  constexpr int ROUNDS = 10'000;
+  int64_t sum = 0;
+  const auto start = high_resolution_clock::now();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (const Position &p : positions) sum += p.getMaterialEntry()->imbalance;
+  }
+  const auto nanos = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count();
+  fprintln("{:n} probes in {:n} ns = {:n} ns per probe (checksum {})",
+           ROUNDS * positions.size(), nanos, nanos / (ROUNDS * positions.size()), sum);
+}
@@ -0,0 +1,200 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include "types.h"
+#include "Logging.h"
+#include "NNUE.h"
+#include "Position.h"
+#include "MoveGenerator.h"
+#include "Evaluator.h"
+#include "SearchConfig.h"
+#include "Test_Fens.h"
+
+using testing::Eq;
+
+class NNUETest : public ::testing::Test {
+public:
+  static void SetUpTestSuite() {
+    NEWLINE;
+    INIT::init();
+    NEWLINE;
+  }
+
+protected:
+  void SetUp() override {
+    Logger::get().TEST_LOG->set_level(spdlog::level::debug);
+    Logger::get().SEARCH_LOG->set_level(spdlog::level::warn);
+    SearchConfig::USE_BOOK = false;
+    NNUE::initRandom(42);
+  }
+
+  void TearDown() override {
+    NNUE::setEnabled(false);
+    NNUE::setSimd(NNUE::getMaxSimd());
+  }
+
+  /** compares the incrementally updated accumulator with a fresh one on every node */
+  static int verifyAccumulator(Position &position, int depth) {
+    NNUE::evaluate(position);
+    NNUE::Accumulator fresh;
+    NNUE::refresh(fresh, position, WHITE);
+    NNUE::refresh(fresh, position, BLACK);
+    const NNUE::Accumulator &acc = position.getAccumulator();
+    EXPECT_EQ(0, std::memcmp(fresh.values, acc.values, sizeof(fresh.values))) << position.printFen();
+    if (depth == 0) return 1;
+    int nodes = 1;
+    MoveGenerator mg;
+    const MoveList moves = *mg.generateLegalMoves<MoveGenerator::GENALL>(position);
+    for (Move move : moves) {
+      position.doMove(move);
+      nodes += verifyAccumulator(position, depth - 1);
+      position.undoMove();
+    }
+    return nodes;
+  }
+
+  /** same position with colors swapped and the board flipped vertically */
+  static std::string mirrorFen(const std::string &fen) {
+    std::istringstream in(fen);
+    std::string board, color, castling = "-", ep = "-", rest;
+    in >> board >> color >> castling >> ep;
+    std::getline(in, rest);
+
+    std::vector<std::string> ranks;
+    std::istringstream boardIn(board);
+    for (std::string rank; std::getline(boardIn, rank, '/');) ranks.push_back(rank);
+    std::string mirrored;
+    for (auto r = ranks.rbegin(); r != ranks.rend(); ++r) {
+      if (!mirrored.empty()) mirrored += '/';
+      mirrored += *r;
+    }
+    auto swapCase = [](std::string s) {
+      for (char &c : s) c = std::isupper(c) ? std::tolower(c) : std::toupper(c);
+      return s;
+    };
+    mirrored = swapCase(mirrored);
+    color = color == "w" ? "b" : "w";
+    if (castling != "-") castling = swapCase(castling);
+    if (ep != "-") ep[1] = ep[1] == '3' ? '6' : '3';
+    return fmt::format("{} {} {} {}{}", mirrored, color, castling, ep, rest);
+  }
+};
+
+TEST_F(NNUETest, featureIndex) {
+  // same relation seen from the other side gives the same feature
+  ASSERT_EQ(NNUE::featureIndex(WHITE, SQ_E1, WHITE_PAWN, SQ_E2),
+            NNUE::featureIndex(BLACK, SQ_E8, BLACK_PAWN, SQ_E7));
+  ASSERT_EQ(NNUE::featureIndex(WHITE, SQ_G1, BLACK_QUEEN, SQ_D8),
+            NNUE::featureIndex(BLACK, SQ_G8, WHITE_QUEEN, SQ_D1));
+  ASSERT_NE(NNUE::featureIndex(WHITE, SQ_E1, WHITE_PAWN, SQ_E2),
+            NNUE::featureIndex(WHITE, SQ_E1, BLACK_PAWN, SQ_E2));
+  ASSERT_EQ(NNUE::INPUTS - 1, NNUE::featureIndex(WHITE, SQ_H8, BLACK_QUEEN, SQ_H8));
+}
+
+TEST_F(NNUETest, enable) {
+  ASSERT_TRUE(NNUE::isLoaded());
+  ASSERT_TRUE(NNUE::isEnabled());
+  Position position;
+  Evaluator evaluator;
+  ASSERT_EQ(NNUE::evaluate(position), evaluator.evaluate(position));
+  NNUE::setEnabled(false);
+  ASSERT_FALSE(NNUE::isEnabled());
+  Evaluator classic;
+  ASSERT_EQ(classic.evaluate(position), evaluator.evaluate(position));
+}
+
+TEST_F(NNUETest, incrementalUpdate) {
+  // castling, en passant, promotions and king moves
+  for (const char* fen : {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+                          "r3k2r/1ppn3p/2q1q1n1/8/2q1Pp2/6R1/p1p2PPP/1R4K1 b kq e3",
+                          "8/2P5/8/8/8/8/1kp5/4K3 w - -"}) {
+    Position position(fen);
+    const int nodes = verifyAccumulator(position, 3);
+    LOG__INFO(Logger::get().TEST_LOG, "Verified accumulator on {:n} nodes for {}", nodes, fen);
+    ASSERT_EQ(fen, position.printFen().substr(0, std::strlen(fen)));
+  }
+}
+
+TEST_F(NNUETest, copiedPosition) {
+  Position position("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -");
+  const Value value = NNUE::evaluate(position);
+  Position copy = position;
+  MoveGenerator mg;
+  copy.doMove(mg.generateLegalMoves<MoveGenerator::GENALL>(copy)->front());
+  ASSERT_EQ(value, NNUE::evaluate(position));
+  copy.undoMove();
+  ASSERT_EQ(value, NNUE::evaluate(copy));
+}
+
+TEST_F(NNUETest, mirrored) {
+  for (const std::string &fen : Test_Fens::getFENs()) {
+    Position position(fen);
+    Position mirrored(mirrorFen(fen));
+    ASSERT_EQ(NNUE::evaluate(position), NNUE::evaluate(mirrored)) << fen << " | " << mirrorFen(fen);
+  }
+}
+
+TEST_F(NNUETest, simd) {
+  LOG__INFO(Logger::get().TEST_LOG, "CPU supports {}", NNUE::simdName(NNUE::getMaxSimd()));
+  for (const std::string &fen : Test_Fens::getFENs()) {
+    NNUE::setSimd(NNUE::SCALAR);
+    Position scalarPos(fen);
+    const Value scalar = NNUE::evaluate(scalarPos);
+    for (NNUE::Simd simd : {NNUE::SSE41, NNUE::AVX2}) {
+      NNUE::setSimd(simd);
+      Position position(fen);
+      ASSERT_EQ(scalar, NNUE::evaluate(position)) << NNUE::simdName(NNUE::getSimd()) << " " << fen;
+    }
+  }
+}
+
+TEST_F(NNUETest, loadSave) {
+  const std::string fileName = "nnue_test.bin";
+  Position position("r3k2r/1ppn3p/2q1q1n1/8/2q1Pp2/6R1/p1p2PPP/1R4K1 b kq e3");
+  const Value value = NNUE::evaluate(position);
+  ASSERT_TRUE(NNUE::save(fileName));
+
+  // another network gives other values
+  NNUE::initRandom(4711);
+  ASSERT_NE(value, NNUE::evaluate(position));
+
+  ASSERT_TRUE(NNUE::load(fileName));
+  ASSERT_EQ(value, NNUE::evaluate(position));
+
+  // invalid files keep the current network
+  ASSERT_FALSE(NNUE::load("does_not_exist.bin"));
+  {
+    std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+    out << "FKNN garbage";
+  }
+  ASSERT_FALSE(NNUE::load(fileName));
+  ASSERT_TRUE(NNUE::isEnabled());
+  ASSERT_EQ(value, NNUE::evaluate(position));
+  std::remove(fileName.c_str());
+}
@@ -23,6 +23,10 @@
  *
  */
 
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include "types.h"
 #include "Logging.h"
 #include <gtest/gtest.h>
@@ -161,4 +165,170 @@ TEST_F(OpeningBookTest, pgnECOE) {
 }
 
 
+TEST_F(OpeningBookTest, DISABLED_loadTime) {
+  const std::string root = FrankyCPP_PROJECT_ROOT;
+  struct {
+    std::string file;
+    std::string copy;
+    OpeningBook::BookFormat format;
+  } books[] = {{root + "/books/book_graham.txt", "book_graham_load_test.txt", OpeningBook::BookFormat::SAN},
+               {root + "/books/superbook2.pgn", "superbook2_load_test.pgn", OpeningBook::BookFormat::PGN}};
+  for (const auto &b : books) {
+    // a copy without a compiled binary book so the book is parsed
+    {
+      std::ifstream in(b.file);
+      std::ofstream out(b.copy);
+      out << in.rdbuf();
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    OpeningBook book(b.copy, b.format);
+    book.initialize();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start);
+    LOG__INFO(Logger::get().TEST_LOG, "Book {} with {:n} positions loaded in {:n} ms", b.file, book.size(), elapsed.count());
+    std::remove(b.copy.c_str());
+    ASSERT_GT(book.size(), 0);
+  }
+}
+
+TEST_F(OpeningBookTest, binary) {
+  std::string filePathStr = FrankyCPP_PROJECT_ROOT;
+  filePathStr += +"/books/book_smalltest.txt";
+  OpeningBook book(filePathStr, OpeningBook::BookFormat::SIMPLE);
+  book.initialize();
+  const std::string binaryPath = "book_smalltest_test.bin";
+  ASSERT_TRUE(book.saveBinary(binaryPath));
+
+  auto start = std::chrono::high_resolution_clock::now();
+  OpeningBook binaryBook(binaryPath, OpeningBook::BookFormat::BINARY);
+  binaryBook.initialize();
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start);
+  LOG__INFO(Logger::get().TEST_LOG, "Binary book with {:n} positions loaded in {:n} us", binaryBook.size(), elapsed.count());
+  ASSERT_GT(binaryBook.size(), 0);
+  ASSERT_LT(binaryBook.size(), book.size());
+
+  // all moves of the binary book are moves of the book
+  Position position;
+  MoveGenerator mg;
+  for (int i = 0; i < 100; i++) {
+    const Move move = binaryBook.getRandomMove(position.getZobristKey());
+    ASSERT_TRUE(mg.validateMove(position, move));
+    bool found = false;
+    for (int j = 0; j < 1'000 && !found; j++) found = book.getRandomMove(position.getZobristKey()) == move;
+    ASSERT_TRUE(found) << printMove(move);
+  }
+  position = Position("r3k2r/1ppn3p/2q1q1n1/4P3/2q1Pp2/6R1/pbp2PPP/1R4K1 b kq e3");
+  ASSERT_EQ(MOVE_NONE, binaryBook.getRandomMove(position.getZobristKey()));
 
+  // invalid files
+  {
+    std::ofstream out("book_invalid_test.bin", std::ios::binary | std::ios::trunc);
+    out << "FKBK garbage";
+  }
+  OpeningBook invalid("book_invalid_test.bin", OpeningBook::BookFormat::BINARY);
+  invalid.initialize();
+  ASSERT_EQ(MOVE_NONE, invalid.getRandomMove(Position().getZobristKey()));
+  std::remove("book_invalid_test.bin");
+  std::remove(binaryPath.c_str());
+}
+
+TEST_F(OpeningBookTest, binaryReplacesBook) {
+  std::string filePathStr = FrankyCPP_PROJECT_ROOT;
+  filePathStr += +"/books/book_graham.txt";
+  const std::string copyPath = "book_graham_test.txt";
+  {
+    std::ifstream in(filePathStr);
+    std::ofstream out(copyPath);
+    out << in.rdbuf();
+  }
+  OpeningBook book(copyPath, OpeningBook::BookFormat::SAN);
+  book.initialize();
+  ASSERT_EQ(1'256, book.size());
+  ASSERT_TRUE(book.saveBinary(copyPath + ".bin"));
+
+  // the binary book compiled from this text book is used instead of parsing it
+  OpeningBook cached(copyPath, OpeningBook::BookFormat::SAN);
+  cached.initialize();
+  ASSERT_GT(cached.size(), 0);
+  ASSERT_LT(cached.size(), book.size());
+  ASSERT_TRUE(isMove(cached.getRandomMove(Position().getZobristKey())));
+
+  // a changed text book is parsed again
+  {
+    std::ofstream out(copyPath, std::ios::app);
+    out << "\n";
+  }
+  OpeningBook changed(copyPath, OpeningBook::BookFormat::SAN);
+  changed.initialize();
+  ASSERT_EQ(1'256, changed.size());
+  std::remove((copyPath + ".bin").c_str());
+  std::remove(copyPath.c_str());
+}
+
+TEST_F(OpeningBookTest, polyglot) {
+  // small polyglot book: key, move (to | from << 6 | promotion << 12), weight
+  struct Entry {
+    Key key;
+    uint16_t move;
+    uint16_t weight;
+  };
+  auto encode = [](Square from, Square to, int promotion = 0) {
+    return static_cast<uint16_t>(to | from << 6 | promotion << 12);
+  };
+  Position startPosition;
+  Position castlePosition("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+  Position promotionPosition("8/P6k/8/8/8/8/8/K7 w - - 0 1");
+  std::vector<Entry> entries{
+    {startPosition.getPolyglotKey(), encode(SQ_E2, SQ_E4), 30},
+    {startPosition.getPolyglotKey(), encode(SQ_D2, SQ_D4), 10},
+    {startPosition.getPolyglotKey(), encode(SQ_G1, SQ_F3), 0},
+    {castlePosition.getPolyglotKey(), encode(SQ_E1, SQ_H1), 1},
+    {promotionPosition.getPolyglotKey(), encode(SQ_A7, SQ_A8, 4), 1}};
+  std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.key < b.key; });
+
+  const std::string bookPath = "book_polyglot_test.bin";
+  {
+    std::ofstream out(bookPath, std::ios::binary | std::ios::trunc);
+    auto write = [&](uint64_t value, int bytes) {
+      for (int i = bytes - 1; i >= 0; i--) out.put(static_cast<char>(value >> (8 * i) & 0xFF));
+    };
+    for (const Entry &e : entries) {
+      write(e.key, 8);
+      write(e.move, 2);
+      write(e.weight, 2);
+      write(0, 4);
+    }
+  }
+
+  OpeningBook book(bookPath, OpeningBook::BookFormat::POLYGLOT);
+  book.initialize();
+  ASSERT_EQ(5, book.size());
+
+  // weighted selection - moves without weight are not played
+  int e4 = 0, d4 = 0;
+  for (int i = 0; i < 1'000; i++) {
+    const Move move = book.getRandomMove(startPosition);
+    if (move == createMove("e2e4")) e4++;
+    else if (move == createMove("d2d4")) d4++;
+    else FAIL() << printMove(move);
+  }
+  LOG__INFO(Logger::get().TEST_LOG, "e2e4 {} times, d2d4 {} times", e4, d4);
+  ASSERT_GT(d4, 0);
+  ASSERT_GT(e4, 2 * d4);
+
+  ASSERT_EQ(createMove<CASTLING>(SQ_E1, SQ_G1), book.getRandomMove(castlePosition));
+  ASSERT_EQ(createMove<PROMOTION>(SQ_A7, SQ_A8, QUEEN), book.getRandomMove(promotionPosition));
+  ASSERT_EQ(MOVE_NONE, book.getRandomMove(Position("r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1")));
+  // our zobrist keys can't be used with polyglot books
+  ASSERT_EQ(MOVE_NONE, book.getRandomMove(startPosition.getZobristKey()));
+
+  // invalid files
+  {
+    std::ofstream out(bookPath, std::ios::binary | std::ios::trunc);
+    out << "no polyglot";
+  }
+  OpeningBook invalid(bookPath, OpeningBook::BookFormat::POLYGLOT);
+  invalid.initialize();
+  ASSERT_EQ(0, invalid.size());
+  ASSERT_EQ(MOVE_NONE, invalid.getRandomMove(startPosition));
+  std::remove(bookPath.c_str());
+}
@@ -23,6 +23,7 @@
  *
  */
 
+#include <fstream>
 #include "types.h"
 #include "Logging.h"
 #include "PGN_Reader.h"
@@ -66,3 +67,36 @@ TEST_F(PGN_ReaderTest, regex) {
   EXPECT_TRUE(find_regex(input, tagPairs));
 
 }
+
+TEST_F(PGN_ReaderTest, stream) {
+  std::string filePathStr = FrankyCPP_PROJECT_ROOT;
+  filePathStr += +"/books/pgn_test.pgn";
+
+  // all lines in memory
+  std::vector<std::string> lines;
+  {
+    std::ifstream in(filePathStr);
+    for (std::string line; std::getline(in, line);) {
+      if (!line.empty()) lines.push_back(line);
+    }
+  }
+  PGN_Reader reader(lines);
+  ASSERT_TRUE(reader.process());
+  const std::vector<PGN_Game> &games = reader.getGames();
+
+  // streamed game by game gives the same games
+  std::ifstream in(filePathStr);
+  PGN_Reader streamReader;
+  std::size_t i = 0;
+  const uint64_t found = streamReader.process(in, [&](PGN_Game &&game) {
+    ASSERT_LT(i, games.size());
+    EXPECT_EQ(games[i].moves, game.moves) << "game " << i;
+    EXPECT_EQ(games[i].tags, game.tags) << "game " << i;
+    i++;
+  });
+  LOG__INFO(Logger::get().TEST_LOG, "Streamed {:n} games", found);
+  EXPECT_EQ(games.size(), found);
+  EXPECT_EQ(games.size(), i);
+  EXPECT_EQ(found, streamReader.getGamesFound());
+  EXPECT_TRUE(streamReader.getGames().empty());
+}
@@ -31,6 +31,9 @@
 #include "TT.h"
 #include "Evaluator.h"
 #include "Search.h"
+#include "MoveGenerator.h"
+#include "NNUE.h"
+#include "Test_Fens.h"
 
 #include <gtest/gtest.h>
 #include <boost/timer/timer.hpp>
@@ -106,6 +109,105 @@ TEST_F(PerformanceTests, Position_PPS) {
   }
 }
 
+/**
+ * Compares the per node cost of the repetition detection in a long game
+ * without pawn moves and captures (high halfMoveClock).
+ */
+TEST_F(PerformanceTests, Repetition_PPS) {
+  // the plain history scan of checkRepetitions without the repetition filter
+  auto linearScan = [](const Position &position, int reps) {
+    int counter = 0;
+    int i = position.historyCounter - 2;
+    int lastHalfMove = position.halfMoveClock;
+    while (i >= 0) {
+      if (position.historyState[i].halfMoveClockHistory >= lastHalfMove) break;
+      lastHalfMove = position.historyState[i].halfMoveClockHistory;
+      if (position.zobristKey == position.historyState[i].zobristKey_History) counter++;
+      if (counter >= reps) return true;
+      i -= 2;
+    }
+    return false;
+  };
+
+  // play random reversible moves without repeating a position
+  std::mt19937_64 rg(1234);
+  Position position("r1b1k2r/8/2n2q2/8/8/2N2Q2/8/R1B1K2R w - - 0 1");
+  MoveGenerator mg;
+  while (position.getHalfMoveClock() < 90) {
+    MoveList moves = *mg.generateLegalMoves<MoveGenerator::GENNONCAP>(position);
+    std::shuffle(moves.begin(), moves.end(), rg);
+    bool found = false;
+    for (Move move : moves) {
+      position.doMove(move);
+      if (position.countRepetitions() == 0 && !position.hasCheck()) {
+        found = true;
+        break;
+      }
+      position.undoMove();
+    }
+    if (!found) break;
+  }
+  fprintln("Half move clock: {}", position.getHalfMoveClock());
+
+  // the positions after each move as they would be checked by the search
+  const MoveList moves = *mg.generateLegalMoves<MoveGenerator::GENALL>(position);
+  const uint64_t iterations = 1'000'000;
+  uint64_t found = 0;
+
+  auto timer = cpu_timer();
+  for (uint64_t i = 0; i < iterations; ++i) {
+    for (Move move : moves) {
+      position.doMove(move);
+      found += linearScan(position, 2);
+      position.undoMove();
+    }
+  }
+  timer.stop();
+  const nanosecond_type scanTime = timer.elapsed().user + timer.elapsed().system;
+
+  timer = cpu_timer();
+  for (uint64_t i = 0; i < iterations; ++i) {
+    for (Move move : moves) {
+      position.doMove(move);
+      found += position.checkRepetitions(2);
+      position.undoMove();
+    }
+  }
+  timer.stop();
+  const nanosecond_type filterTime = timer.elapsed().user + timer.elapsed().system;
+
+  timer = cpu_timer();
+  for (uint64_t i = 0; i < iterations; ++i) {
+    for (Move move : moves) {
+      position.doMove(move);
+      found += position.hasUpcomingRepetition(10);
+      position.undoMove();
+    }
+  }
+  timer.stop();
+  const nanosecond_type cuckooTime = timer.elapsed().user + timer.elapsed().system;
+
+  timer = cpu_timer();
+  for (uint64_t i = 0; i < iterations; ++i) {
+    for (Move move : moves) {
+      position.doMove(move);
+      position.undoMove();
+    }
+  }
+  timer.stop();
+  const nanosecond_type baseTime = timer.elapsed().user + timer.elapsed().system;
+
+  const uint64_t nodes = iterations * moves.size();
+  fprintln("Nodes: {:n} (found {:n})", nodes, found);
+  auto perNode = [&](nanosecond_type time) {
+    return static_cast<double>(time - std::min(time, baseTime)) / nodes;
+  };
+  fprintln("Do/undo move only:       {:.2f} ns per node", static_cast<double>(baseTime) / nodes);
+  fprintln("History scan:            {:.2f} ns per node", perNode(scanTime));
+  fprintln("Filter + history scan:   {:.2f} ns per node", perNode(filterTime));
+  fprintln("Upcoming rep. (cuckoo):  {:.2f} ns per node", perNode(cuckooTime));
+}
+
 /**
 23:50 24.1.2020 CYGWIN
 Move generated: 86.000.000 in 3.051670 seconds
@@ -245,7 +347,7 @@ TEST_F(PerformanceTests, TT_PPS) {
       auto depth = static_cast<Depth>(randomDepth(rg1));
       auto value = static_cast<Value>(randomValue(rg1));
       auto type = static_cast<Value_Type>(randomType(rg1));
-      tt.put(key, depth, move, value, type, false, true);
+      tt.put(key, depth, move, value, type, VALUE_NONE, false, true);
     }
     // probes
     for (int i = 0; i < iterations; ++i) {
@@ -294,6 +396,8 @@ TEST_F(PerformanceTests, Evaluator_EPS) {
   evaluator.config.USE_MOBILITY = true;
   evaluator.config.USE_PIECE_BONI = true;
   evaluator.config.USE_KING_CASTLE_SAFETY = true;
+  evaluator.config.USE_KING_ATTACKS = true;
+  evaluator.config.USE_THREATS = true;
   evaluator.resizePawnTable(evaluator.config.PAWN_TABLE_SIZE);
 
   for (uint64_t round = 0; round < rounds; ++round) {
@@ -344,4 +448,114 @@ TEST_F(PerformanceTests, Search_NPS) {
             nps);
 
   //  EXPECT_LT(1'800'000, nps);
-}
\ No newline at end of file
+}
+/*
+ * Nodes per second of the search with single search and evaluation
+ * features changed against the default configuration.
+ */
+TEST_F(PerformanceTests, SearchFeatures_NPS) {
+  Logger::get().SEARCH_LOG->set_level(spdlog::level::warn);
+  Search search;
+  SearchLimits searchLimits;
+  search.setHashSize(64);
+  searchLimits.setDepth(8);
+
+  const std::vector<std::string> fens = {
+    START_POSITION_FEN,
+    "r3k2r/1ppn3p/2q1q1n1/8/2q1Pp2/6R1/p1p2PPP/1R4K1 b kq e3",
+    "r1bqkb1r/pp3ppp/2nppn2/8/3NP3/2N1B3/PPP2PPP/R2QKB1R w KQkq -"
+  };
+
+  const auto measure = [&](const std::string &name) {
+    uint64_t nodes = 0;
+    MilliSec time = 0;
+    for (const std::string &fen : fens) {
+      Position position(fen);
+      search.clearHash();
+      search.startSearch(position, searchLimits);
+      search.waitWhileSearching();
+      nodes += search.getSearchStats().nodesVisited;
+      time += search.getSearchStats().lastSearchTime;
+    }
+    LOG__INFO(Logger::get().TEST_LOG, "{:<16} Nodes: {:>12n} Time: {:>6n} ms NPS: {:>10n}",
+              name, nodes, time, nodes * 1'000 / (time + 1));
+  };
+
+  measure("default");
+  SearchConfig::USE_STATIC_SEARCH = false;
+  measure("runtime search");
+  SearchConfig::USE_STATIC_SEARCH = true;
+  SearchConfig::USE_TT_EVAL = false;
+  measure("no TT eval");
+  SearchConfig::USE_TT_EVAL = true;
+  search.setEvalCacheSize(2);
+  measure("eval cache 2 MB");
+  search.setEvalCacheSize(0);
+  // a changed evaluation config also uses the runtime evaluation
+  search.pEvaluator->config.USE_LAZY_EVAL = false;
+  measure("no lazy eval");
+}
+
+/*
+ * Evaluations per second of the classic evaluation and the NNUE with a
+ * random network for each available SIMD implementation.
+ */
+TEST_F(PerformanceTests, NNUE_EPS) {
+  using namespace std::chrono;
+  const auto fens = Test_Fens::getFENs();
+  std::vector<Position> positions;
+  for (const std::string &fen : fens) positions.emplace_back(fen);
+  constexpr int ROUNDS = 200;
+  NNUE::initRandom(42);
+
+  auto run = [&](const std::string &name, auto &&eval) {
+    int64_t sum = 0;
+    const auto start = high_resolution_clock::now();
+    for (int r = 0; r < ROUNDS; r++) {
+      for (Position &p : positions) {
+        // force a full refresh as a worst case for the network
+        p.getAccumulator().computed[WHITE] = p.getAccumulator().computed[BLACK] = false;
+        sum += eval(p);
+      }
+    }
+    const auto nanos = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count();
+    const auto evals = ROUNDS * positions.size();
+    LOG__INFO(Logger::get().TEST_LOG, "{:>12}: {:n} evals in {:n} ms = {:n} evals/sec (checksum {})", name, evals,
+              nanos / 1'000'000, static_cast<uint64_t>(evals * 1e9 / nanos), sum);
+  };
+
+  NNUE::setEnabled(false);
+  Evaluator evaluator;
+  run("Classic", [&](Position &p) { return evaluator.evaluate(p); });
+  NNUE::setEnabled(true);
+  for (NNUE::Simd simd : {NNUE::SCALAR, NNUE::SSE41, NNUE::AVX2}) {
+    if (simd > NNUE::getMaxSimd()) continue;
+    NNUE::setSimd(simd);
+    run("NNUE " + NNUE::simdName(simd), [&](Position &p) { return NNUE::evaluate(p); });
+  }
+  NNUE::setEnabled(false);
+  NNUE::setSimd(NNUE::getMaxSimd());
+}
+
+/*
+ * Nodes per second of the search with the classic evaluation and the NNUE
+ * with a random network.
+ */
+TEST_F(PerformanceTests, NNUE_Search_NPS) {
+  Logger::get().SEARCH_LOG->set_level(spdlog::level::warn);
+  NNUE::initRandom(42);
+  SearchLimits searchLimits;
+  searchLimits.setDepth(8);
+  for (bool useNNUE : {false, true}) {
+    NNUE::setEnabled(useNNUE);
+    Search search;
+    Position position("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -");
+    search.startSearch(position, searchLimits);
+    search.waitWhileSearching();
+    const auto &stats = search.getSearchStats();
+    LOG__INFO(Logger::get().TEST_LOG, "{:>8}: nodes {:n} time {:n} ms nps {:n}", useNNUE ? "NNUE" : "Classic",
+              stats.nodesVisited, stats.lastSearchTime,
+              stats.lastSearchTime ? stats.nodesVisited * 1'000 / stats.lastSearchTime : 0);
+  }
+  NNUE::setEnabled(false);
+}
@@ -33,6 +33,8 @@
 #include "Logging.h"
 #include "Bitboards.h"
 #include "Position.h"
+#include "PackedPosition.h"
+#include "Material.h"
 
 using namespace std;
 using testing::Eq;
@@ -117,6 +119,64 @@ TEST_F(PositionTest, ZobristTest) {
   ASSERT_EQ(expected, z);
 }
 
+TEST_F(PositionTest, PawnKey) {
+  // only pawns change the pawn key
+  Position position("r1bqkb1r/pppp1ppp/2n2n2/3Pp3/8/8/PPP1PPPP/RNBQKBNR w KQkq e6 0 1");
+  const Key start = position.getPawnKey();
+  position.doMove(createMove("g1f3"));
+  ASSERT_EQ(start, position.getPawnKey());
+  position.doMove(createMove("e8e7"));
+  ASSERT_EQ(start, position.getPawnKey());
+  position.undoMove();
+  position.undoMove();
+
+  // incremental key matches the key of the position setup from the fen
+  position.doMove(createMove<ENPASSANT>(SQ_D5, SQ_E6));
+  ASSERT_EQ(Position(position.printFen()).getPawnKey(), position.getPawnKey());
+  ASSERT_NE(start, position.getPawnKey());
+  position.doMove(createMove("d7e6"));
+  ASSERT_EQ(Position(position.printFen()).getPawnKey(), position.getPawnKey());
+  position.undoMove();
+  position.undoMove();
+  ASSERT_EQ(start, position.getPawnKey());
+
+  // promotion
+  position = Position("8/2P5/8/8/8/8/1kp5/4K3 w - -");
+  position.doMove(createMove<PROMOTION>("c7c8q"));
+  ASSERT_EQ(Position(position.printFen()).getPawnKey(), position.getPawnKey());
+
+  // no pawns still give a valid key
+  ASSERT_NE(0, Position("4k3/8/8/8/8/8/8/4K3 w - -").getPawnKey());
+}
+
+TEST_F(PositionTest, MaterialKey) {
+  Position position("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -");
+  const Key start = position.getMaterialKey();
+  for (Color c = WHITE; c <= BLACK; ++c) {
+    for (PieceType pt = KING; pt <= QUEEN; ++pt) {
+      ASSERT_EQ(Bitboards::popcount(position.getPieceBB(c, pt)), Material::count(start, makePiece(c, pt)));
+    }
+  }
+
+  // quiet moves do not change the key - captures do
+  position.doMove(createMove("e1g1"));
+  ASSERT_EQ(start, position.getMaterialKey());
+  position.doMove(createMove("e6d5"));
+  ASSERT_EQ(start - Material::keyDelta(WHITE_PAWN), position.getMaterialKey());
+  ASSERT_EQ(Position(position.printFen()).getMaterialIndex(), position.getMaterialIndex());
+  position.undoMove();
+  position.undoMove();
+  ASSERT_EQ(start, position.getMaterialKey());
+
+  // promotion
+  position = Position("8/2P5/8/8/8/8/1kp5/4K3 w - -");
+  position.doMove(createMove<PROMOTION>("c7c8q"));
+  ASSERT_EQ(Position(position.printFen()).getMaterialKey(), position.getMaterialKey());
+  ASSERT_EQ(Position(position.printFen()).getMaterialIndex(), position.getMaterialIndex());
+  ASSERT_EQ(1, Material::count(position.getMaterialKey(), WHITE_QUEEN));
+  ASSERT_EQ(0, Material::count(position.getMaterialKey(), WHITE_PAWN));
+}
+
 TEST_F(PositionTest, Setup) {
   string fen;
 
@@ -591,6 +651,11 @@ TEST_F(PositionTest, repetitionSimple) {
   // cout << "3-Repetitions: " << position.countRepetitions() << endl;
   ASSERT_EQ(2, position.countRepetitions());
   ASSERT_TRUE(position.checkRepetitions(2));
+
+  // a packed setup only resets the filter slots of the history keys
+  position.setup(PackedPosition::pack(Position()));
+  for (uint16_t count : position.repetitionFilter) ASSERT_EQ(0, count);
+  ASSERT_EQ(0, position.countRepetitions());
 }
 
 TEST_F(PositionTest, repetitionAdvanced) {
@@ -616,6 +681,58 @@ TEST_F(PositionTest, repetitionAdvanced) {
   ASSERT_TRUE(position.checkRepetitions(2));
 }
 
+TEST_F(PositionTest, upcomingRepetition) {
+  // all reversible piece moves on an empty board
+  int entries = 0;
+  for (Key key : Cuckoo::keys) { if (key) entries++; }
+  ASSERT_EQ(3668, entries);
+
+  // no double pawn moves as the en passant square is part of the key
+  Position position;
+  position.doMove(createMove(SQ_E2, SQ_E3));
+  position.doMove(createMove(SQ_E7, SQ_E6));
+  ASSERT_FALSE(position.hasUpcomingRepetition(10));
+
+  position.doMove(createMove(SQ_G1, SQ_F3));
+  position.doMove(createMove(SQ_B8, SQ_C6));
+  ASSERT_FALSE(position.hasUpcomingRepetition(10));
+
+  // black can repeat the position after 1.e3 e6 with Nb8
+  position.doMove(createMove(SQ_F3, SQ_G1));
+  ASSERT_TRUE(position.hasUpcomingRepetition(10));
+  // not within the search tree and not repeated before
+  ASSERT_FALSE(position.hasUpcomingRepetition(0));
+
+  // white can repeat with Ng1 after Nc6 was played again
+  position.doMove(createMove(SQ_C6, SQ_B8));
+  position.doMove(createMove(SQ_G1, SQ_F3));
+  position.doMove(createMove(SQ_B8, SQ_C6));
+  ASSERT_TRUE(position.hasUpcomingRepetition(10));
+  ASSERT_FALSE(position.hasUpcomingRepetition(0));
+
+  // after another cycle the position after Ng1 has been repeated already
+  // which counts also before the search root
+  position.doMove(createMove(SQ_F3, SQ_G1));
+  position.doMove(createMove(SQ_C6, SQ_B8));
+  position.doMove(createMove(SQ_G1, SQ_F3));
+  position.doMove(createMove(SQ_B8, SQ_C6));
+  ASSERT_TRUE(position.hasUpcomingRepetition(0));
+
+  // Ra4-c4 repeats the position after 1.Rc4 unless the pawn on b4 blocks it
+  for (const char* fen : {"4k3/8/8/8/8/8/8/2R1K3 w - - 0 1", "4k3/8/8/8/1P6/8/8/2R1K3 w - - 0 1"}) {
+    position = Position(fen);
+    position.doMove(createMove(SQ_C1, SQ_C4));
+    position.doMove(createMove(SQ_E8, SQ_D8));
+    position.doMove(createMove(SQ_C4, SQ_C3));
+    position.doMove(createMove(SQ_D8, SQ_D7));
+    position.doMove(createMove(SQ_C3, SQ_A3));
+    position.doMove(createMove(SQ_D7, SQ_E7));
+    position.doMove(createMove(SQ_A3, SQ_A4));
+    position.doMove(createMove(SQ_E7, SQ_E8));
+    ASSERT_EQ(position.getPiece(SQ_B4) == PIECE_NONE, position.hasUpcomingRepetition(10));
+  }
+}
+
 TEST_F(PositionTest, insufficientMaterial) {
   string fen;
   Position position;
@@ -640,6 +757,21 @@ TEST_F(PositionTest, insufficientMaterial) {
   position = Position(fen);
   ASSERT_TRUE(position.checkInsufficientMaterial());
 
+  // KBK
+  fen = "8/3k4/8/8/8/8/4KB2/8 w - -";
+  position = Position(fen);
+  ASSERT_TRUE(position.checkInsufficientMaterial());
+
+  // KKB
+  fen = "8/2bk4/8/8/8/8/4K3/8 w - -";
+  position = Position(fen);
+  ASSERT_TRUE(position.checkInsufficientMaterial());
+
+  // KBKN
+  fen = "8/2nk4/8/8/8/8/4KB2/8 w - -";
+  position = Position(fen);
+  ASSERT_FALSE(position.checkInsufficientMaterial());
+
   // KKN
   fen = "8/2nk4/8/8/8/8/4K3/8 w - -";
   position = Position(fen);
@@ -966,6 +1098,38 @@ TEST_F(PositionTest, isCapturingMove) {
   ASSERT_FALSE(position.isCapturingMove(createMove(SQ_C4, SQ_F1)));
 }
 
+TEST_F(PositionTest, see) {
+  Position position;
+
+  // undefended pawn
+  position = Position("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - -");
+  ASSERT_EQ(100, position.see(createMove(SQ_E1, SQ_E5)));
+
+  // knight takes pawn defended by pawn and x-rayed rooks and queen
+  position = Position("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - -");
+  ASSERT_EQ(-220, position.see(createMove(SQ_D3, SQ_E5)));
+
+  // queen takes defended pawn
+  position = Position("4k3/8/3p4/4p3/8/8/4Q3/4K3 w - -");
+  ASSERT_EQ(100 - 900, position.see(createMove(SQ_E2, SQ_E5)));
+
+  // rook takes rook defended by rook - the second rook recaptures through
+  // the first (x-ray)
+  position = Position("3r2k1/3r4/8/8/8/8/3R4/3R2K1 w - -");
+  ASSERT_EQ(500, position.see(createMove(SQ_D2, SQ_D7)));
+
+  // en passant and promotion
+  position = Position("4k3/8/8/3Pp3/8/8/8/4K3 w - e6");
+  ASSERT_EQ(100, position.see(createMove<ENPASSANT>(SQ_D5, SQ_E6)));
+  position = Position("1n2k3/P7/8/8/8/8/8/4K3 w - -");
+  ASSERT_EQ(320 + 900 - 100, position.see(createMove<PROMOTION>(SQ_A7, SQ_B8, QUEEN)));
+
+  // quiet moves
+  position = Position("4k3/8/7p/8/8/8/8/2B1K3 w - -");
+  ASSERT_EQ(-330, position.see(createMove(SQ_C1, SQ_G5)));
+  ASSERT_EQ(0, position.see(createMove(SQ_C1, SQ_F4)));
+}
+
 TEST_F(PositionTest, isLegalMove) {
   string fen;
   Position position;
@@ -1012,3 +1176,27 @@ TEST_F(PositionTest, isLegalPosition) {
   position.undoMove();
 }
 
+
+TEST_F(PositionTest, polyglotKey) {
+  // test keys from the polyglot book format specification
+  const std::vector<std::pair<string, Key>> keys{
+    {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 0x463b96181691fc9c},
+    {"rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1", 0x823c9b50fd114196},
+    {"rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 2", 0x0756b94461c50fb0},
+    {"rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 2", 0x662fafb965db29d4},
+    {"rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3", 0x22a48b5a8e47ff78},
+    {"rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR b kq - 0 3", 0x652a607ca3f242c1},
+    {"rnbq1bnr/ppp1pkpp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR w - - 0 4", 0x00fdd303c946bdd9},
+    {"rnbqkbnr/p1pppppp/8/8/PpP4P/8/1P1PPPP1/RNBQKBNR b KQkq c3 0 3", 0x3c8123ea7b067637},
+    {"rnbqkbnr/p1pppppp/8/8/P6P/R1p5/1P1PPPP1/1NBQKBNR b Kkq - 0 4", 0x5c3f9b829b279560}};
+  for (const auto &[fen, key] : keys) {
+    ASSERT_EQ(key, Position(fen).getPolyglotKey()) << fen;
+  }
+
+  // same key after making the moves
+  Position position;
+  for (const char* move : {"e2e4", "d7d5", "e4e5", "f7f5", "e1e2", "e8f7"}) {
+    position.doMove(createMove(move));
+  }
+  ASSERT_EQ(0x00fdd303c946bdd9, position.getPolyglotKey());
+}
@@ -24,10 +24,14 @@
  */
 
 #include <sstream>
+#include <numeric>
 #include "Logging.h"
 #include "Position.h"
 #include "SearchConfig.h"
 #include "Search.h"
+#include "MoveGenerator.h"
+#include "Evaluator.h"
+#include "Test_Fens.h"
 #include "Engine.h"
 #include <gtest/gtest.h>
 
@@ -41,6 +45,37 @@ public:
     NEWLINE;
   }
 
+  /** sums of the statistics of the searches of several positions */
+  struct FensStats {
+    uint64_t nodes = 0;
+    uint64_t evaluations = 0;
+    uint64_t ttEvalHits = 0;
+    uint64_t lazyEvaluations = 0;
+  };
+
+  /** searches each of the fens after clearing the hash */
+  static FensStats searchFens(Search &search, SearchLimits &searchLimits, const std::vector<std::string> &fens) {
+    FensStats stats;
+    for (const std::string &fen : fens) {
+      Position position(fen);
+      search.clearHash();
+      search.startSearch(position, searchLimits);
+      search.waitWhileSearching();
+      stats.nodes += search.getSearchStats().nodesVisited;
+      stats.evaluations += search.getSearchStats().leafPositionsEvaluated;
+      stats.ttEvalHits += search.getSearchStats().ttEvalHits;
+      stats.lazyEvaluations += search.getSearchStats().lazyEvaluations;
+    }
+    return stats;
+  }
+
+  // positions to compare search and evaluation features
+  const std::vector<std::string> featureFens = {
+    START_POSITION_FEN,
+    "r3k2r/1ppn3p/2q1q1n1/8/2q1Pp2/6R1/p1p2PPP/1R4K1 b kq e3",
+    "r1bqkb1r/pp3ppp/2nppn2/8/3NP3/2N1B3/PPP2PPP/R2QKB1R w KQkq -"
+  };
+
 protected:
   void SetUp() override {
     Logger::get().TEST_LOG->set_level(spdlog::level::debug);
@@ -49,7 +84,11 @@ protected:
     SearchConfig::USE_BOOK = false;
   }
 
-  void TearDown() override {}
+  void TearDown() override {
+    // also restored when a test changing it failed
+    SearchConfig::USE_SOFT_TIME_LIMIT = true;
+    SearchConfig::USE_ASPIRATION_WINDOW = true;
+  }
 };
 
 TEST_F(SearchTest, basic) {
@@ -102,6 +141,8 @@ TEST_F(SearchTest, timerTest) {
   Position position;
 
   SearchConfig::USE_BOOK = false;
+  SearchConfig::USE_SOFT_TIME_LIMIT = false; // only test the hard limit here
+  SearchConfig::USE_ASPIRATION_WINDOW = false; // fail lows add extra time
 
   searchLimits.setWhiteTime(60'000);  //  1.475 ms
   searchLimits.setBlackTime(60'000);
@@ -132,6 +173,40 @@ TEST_F(SearchTest, movetime) {
               (searchLimits.getMoveTime() + 100));
 }
 
+TEST_F(SearchTest, movetimeLatency) {
+  Logger::get().SEARCH_LOG->set_level(spdlog::level::warn);
+  Search search;
+  SearchLimits searchLimits;
+  Position position;
+  SearchConfig::USE_BOOK = false;
+  const int runs = 10;
+
+  // go to bestmove latency for timer thread and node based time checks
+  for (bool nodeTimeCheck : {false, true}) {
+    SearchConfig::USE_NODE_TIME_CHECK = nodeTimeCheck;
+    fprintln("Time check: {}", nodeTimeCheck ? "NODES" : "TIMER THREAD");
+    for (MilliSec moveTime : {10, 20, 50, 100}) {
+      searchLimits.setMoveTime(moveTime);
+      // in microseconds
+      std::vector<int64_t> latencies{};
+      for (int i = 0; i < runs; i++) {
+        search.clearHash();
+        const auto start = std::chrono::steady_clock::now();
+        search.startSearch(position, searchLimits);
+        search.waitWhileSearching();
+        const auto stop = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count());
+      }
+      std::sort(latencies.begin(), latencies.end());
+      const int64_t avg = std::accumulate(latencies.begin(), latencies.end(), int64_t{0}) / runs;
+      fprintln("movetime {:3d} ms: min {:7n} us avg {:7n} us p90 {:7n} us max {:7n} us",
+               moveTime, latencies.front(), avg, latencies[runs * 9 / 10 - 1], latencies.back());
+      EXPECT_LT(latencies.back(), (moveTime + 100) * 1'000);
+    }
+  }
+  SearchConfig::USE_NODE_TIME_CHECK = true;
+}
+
 TEST_F(SearchTest, timewhite) {
   Search search;
   SearchLimits searchLimits;
@@ -194,6 +269,32 @@ TEST_F(SearchTest, mate2Search) {
             valueOf(search.getLastSearchResult().bestMove));
 }
 
+TEST_F(SearchTest, mateSolverStopped) {
+  // stopped before the mate solver has a result - a legal move without a score
+  Search search;
+  SearchLimits searchLimits;
+  Position position;
+  searchLimits.setMate(3);
+  searchLimits.setNodes(50);
+  search.startSearch(position, searchLimits);
+  search.waitWhileSearching();
+  MoveGenerator mg;
+  ASSERT_TRUE(mg.validateMove(position, search.getLastSearchResult().bestMove));
+  ASSERT_EQ(VALUE_NONE, search.getLastSearchResult().bestMoveValue);
+}
+
+TEST_F(SearchTest, mateKNNK) {
+  // KNNK is no material draw for the search as mates are possible
+  Search search;
+  SearchLimits searchLimits;
+  Position position("7k/8/5NKN/8/8/8/8/8 w - - 0 1");
+  searchLimits.setDepth(6);
+  search.startSearch(position, searchLimits);
+  search.waitWhileSearching();
+  ASSERT_EQ("h6f7", printMove(search.getLastSearchResult().bestMove));
+  ASSERT_EQ(VALUE_CHECKMATE - 1, search.getLastSearchResult().bestMoveValue);
+}
+
 TEST_F(SearchTest, repetitionForce) {
   Search search;
   SearchLimits searchLimits;
@@ -463,6 +564,127 @@ TEST_F(SearchTest, TT) {
      (search.getSearchStats().tt_Cuts + search.getSearchStats().tt_NoCuts)));
 }
 
+TEST_F(SearchTest, ttEval) {
+  Search search;
+  SearchLimits searchLimits;
+  search.setHashSize(64);
+  searchLimits.setDepth(7);
+
+  for (bool useTTEval : {false, true}) {
+    SearchConfig::USE_TT_EVAL = useTTEval;
+    const FensStats stats = searchFens(search, searchLimits, featureFens);
+    LOG__INFO(Logger::get().TEST_LOG, "TT eval {:<5} Nodes: {:>12n} Evaluations: {:>12n} per node: {:.3f} TT eval hits: {:n}",
+              useTTEval, stats.nodes, stats.evaluations, static_cast<double>(stats.evaluations) / stats.nodes, stats.ttEvalHits);
+    if (!useTTEval) EXPECT_EQ(0, stats.ttEvalHits);
+    else EXPECT_GT(stats.ttEvalHits, 0);
+  }
+  SearchConfig::USE_TT_EVAL = true;
+}
+
+TEST_F(SearchTest, lazyEval) {
+  Search search;
+  SearchLimits searchLimits;
+  search.setHashSize(64);
+  searchLimits.setDepth(7);
+
+  for (bool useLazyEval : {false, true}) {
+    search.pEvaluator->config.USE_LAZY_EVAL = useLazyEval;
+    const FensStats stats = searchFens(search, searchLimits, featureFens);
+    // the changed config is not ignored by the static evaluation
+    ASSERT_EQ(useLazyEval, search.pEvaluator->isStatic());
+    LOG__INFO(Logger::get().TEST_LOG, "Lazy eval {:<5} Nodes: {:>12n} Evaluations: {:>12n} Lazy: {:>12n}",
+              useLazyEval, stats.nodes, stats.evaluations, stats.lazyEvaluations);
+    if (!useLazyEval) EXPECT_EQ(0, stats.lazyEvaluations);
+    else EXPECT_GT(stats.lazyEvaluations, 0);
+  }
+}
+
+TEST_F(SearchTest, staticSearch) {
+  // @formatter:off
+  SearchConfig::USE_ALPHABETA       = true;
+  SearchConfig::USE_PVS             = true;
+  SearchConfig::USE_QUIESCENCE      = true;
+  SearchConfig::USE_TT              = true;
+  SearchConfig::USE_TT_QSEARCH      = true;
+  SearchConfig::USE_TT_EVAL         = true;
+  SearchConfig::USE_KILLER_MOVES    = true;
+  SearchConfig::USE_PV_MOVE_SORT    = true;
+  SearchConfig::USE_UPCOMING_REP    = true;
+  SearchConfig::USE_MATERIAL_DRAW   = true;
+  SearchConfig::USE_KPK_BITBASE     = true;
+  SearchConfig::USE_MDP             = true;
+  SearchConfig::USE_MPP             = true;
+  SearchConfig::USE_QS_STANDPAT_CUT = true;
+  SearchConfig::USE_RFP             = true;
+  SearchConfig::USE_NMP             = true;
+  SearchConfig::NMP_VERIFICATION    = true;
+  SearchConfig::USE_PROBCUT         = true;
+  SearchConfig::USE_EXTENSIONS      = true;
+  SearchConfig::USE_FP              = true;
+  SearchConfig::USE_EFP             = true;
+  SearchConfig::USE_LMR             = true;
+  // @formatter:on
+  ASSERT_TRUE(StaticSearchPolicy::matchesConfig());
+
+  Search search;
+  SearchLimits searchLimits;
+  search.setHashSize(64);
+  searchLimits.setDepth(7);
+
+  // both instantiations search the same tree
+  uint64_t nodes[2]{};
+  for (bool staticSearch : {false, true}) {
+    SearchConfig::USE_STATIC_SEARCH = staticSearch;
+    nodes[staticSearch] = searchFens(search, searchLimits, featureFens).nodes;
+    ASSERT_EQ(staticSearch, search.staticSearch);
+  }
+  EXPECT_EQ(nodes[false], nodes[true]);
+
+  // changed flags fall back to the runtime search
+  SearchConfig::USE_LMR = false;
+  Position position;
+  search.startSearch(position, searchLimits);
+  search.waitWhileSearching();
+  EXPECT_FALSE(search.staticSearch);
+  SearchConfig::USE_LMR = true;
+}
+
+TEST_F(SearchTest, pawnTable) {
+  Search search;
+  SearchLimits searchLimits;
+  search.setHashSize(64);
+  searchLimits.setDepth(6);
+
+  // positions from real games
+  const auto fens = Test_Fens::getFENs();
+  searchFens(search, searchLimits, std::vector<std::string>(fens.begin(), fens.begin() + 10));
+  const Evaluator &evaluator = *search.pEvaluator;
+  LOG__INFO(Logger::get().TEST_LOG, "{}", evaluator.pawnTableStats());
+  const double hitRate = static_cast<double>(evaluator.cacheHits) / (evaluator.cacheHits + evaluator.cacheMisses);
+  EXPECT_GT(hitRate, 0.75);
+}
+
+TEST_F(SearchTest, evalCache) {
+  Search search;
+  SearchLimits searchLimits;
+  search.setHashSize(64);
+  searchLimits.setDepth(7);
+  // lazy estimates are not cached - the cache would change the search
+  search.pEvaluator->config.USE_LAZY_EVAL = false;
+
+  // the cache only saves evaluations and does not change the search
+  uint64_t nodes[2]{};
+  for (int sizeInMB : {0, 2}) {
+    search.setEvalCacheSize(sizeInMB);
+    nodes[sizeInMB > 0] = searchFens(search, searchLimits, featureFens).nodes;
+    LOG__INFO(Logger::get().TEST_LOG, "Eval cache {} MB Nodes: {:>12n} {}",
+              sizeInMB, nodes[sizeInMB > 0], search.pEvaluator->evalCacheStats());
+    if (!sizeInMB) EXPECT_EQ(0, search.pEvaluator->evalCacheHits);
+    else EXPECT_GT(search.pEvaluator->evalCacheHits, 0);
+  }
+  EXPECT_EQ(nodes[false], nodes[true]);
+}
+
 TEST_F(SearchTest, null_move) {
   Search search;
   SearchLimits searchLimits;
@@ -503,6 +725,21 @@ TEST_F(SearchTest, aspirationWindow) {
   search.waitWhileSearching();
 }
 
+TEST_F(SearchTest, rootMoveNodes) {
+  Search search;
+  SearchLimits searchLimits;
+  Position position("r1bqkb1r/pp3ppp/2nppn2/8/3NP3/2N1B3/PPP2PPP/R2QKB1R w KQkq -");
+  searchLimits.setDepth(7);
+  search.startSearch(position, searchLimits);
+  search.waitWhileSearching();
+
+  // node counts of the last iteration only - the best move is searched first
+  const auto &nodes = search.getSearchStats().rootMoveNodes;
+  const uint64_t sum = std::accumulate(nodes.begin(), nodes.end(), uint64_t{0});
+  ASSERT_GT(nodes.front(), 0);
+  ASSERT_LT(sum, search.getSearchStats().nodesVisited);
+}
+
 TEST_F(SearchTest, perft) {
   int DEPTH = 6;
 
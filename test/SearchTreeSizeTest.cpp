@@ -168,8 +168,10 @@ SearchTreeSizeTest::featureMeasurements(int depth, const std::string &fen) {
   SearchConfig::USE_MPP = false;
   SearchConfig::USE_PVS = false;
   SearchConfig::USE_PV_MOVE_SORT = false;
+  SearchConfig::USE_ROOT_MOVE_NODE_SORT = false;
   SearchConfig::USE_RFP = false;
   SearchConfig::USE_NMP = false;
+  SearchConfig::USE_PROBCUT = false;
   SearchConfig::USE_EXTENSIONS = false;
   SearchConfig::USE_FP = false;
   SearchConfig::USE_EFP = false;
@@ -231,6 +233,12 @@ SearchTreeSizeTest::featureMeasurements(int depth, const std::string &fen) {
   SearchConfig::USE_ASPIRATION_WINDOW = true;
   result.tests.push_back(measureTreeSize(search, position, searchLimits, "90 ASP"));
 
+  SearchConfig::USE_ROOT_MOVE_NODE_SORT = true;
+  result.tests.push_back(measureTreeSize(search, position, searchLimits, "95 ROOTNODES"));
+
+  SearchConfig::USE_PROBCUT = true;
+  result.tests.push_back(measureTreeSize(search, position, searchLimits, "96 PROBCUT"));
+
   //  SearchConfig::USE_RAZOR_PRUNING = true;
   //  result.tests.push_back(measureTreeSize(search, position, searchLimits, "90 RAZOR"));
 
@@ -28,6 +28,8 @@
 #include <random>
 
 #include "Position.h"
+#include "Search.h"
+#include "MoveGenerator.h"
 #include "Engine.h"
 #include "Logging.h"
 #include "UCIHandler.h"
@@ -46,8 +48,15 @@ public:
 protected:
   void SetUp() override {
     Logger::get().TEST_LOG->set_level(spdlog::level::debug);
+    useBook = SearchConfig::USE_BOOK;
   }
-  void TearDown() override {}
+  void TearDown() override {
+    // also restored when a test changing them failed
+    SearchConfig::USE_SOFT_TIME_LIMIT = true;
+    SearchConfig::USE_BOOK = useBook;
+  }
+
+  bool useBook = true;
 
   static std::string sendCommand(Engine &engine, const std::string &command) {
     LOG__INFO(Logger::get().TEST_LOG, "COMMAND: " + command);
@@ -105,3 +114,87 @@ TEST_F(UCISelfPlayUCITest, uciTest) {
 
   engine.waitWhileSearching();
 }
+
+/**
+ * Local self play harness for time management changes. Plays games from a few
+ * openings with colors swapped between soft time limits on and off and
+ * logs time used per move and the results.
+ */
+TEST_F(UCISelfPlayUCITest, DISABLED_timeManagement) {
+  Logger::get().SEARCH_LOG->set_level(spdlog::level::warn);
+  Logger::get().BOOK_LOG->set_level(spdlog::level::warn);
+
+  SearchConfig::USE_BOOK = false;
+
+  const std::vector<std::string> openings = {
+    START_POSITION_FEN,
+    "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+    "rnbqkb1r/pp2pppp/3p1n2/8/3NP3/8/PPP2PPP/RNBQKB1R w KQkq - 1 5"
+  };
+  constexpr MilliSec gameTime = 5'000;
+  constexpr MilliSec increment = 50;
+  constexpr int maxPly = 120;
+
+  // index 0: soft time limit on, index 1: off
+  double points[2]{};
+  MilliSec timeUsed[2]{};
+  int movesPlayed[2]{};
+  int games = 0;
+
+  Search searches[2];
+  for (const std::string &fen : openings) {
+    for (int softPlaysWhite = 0; softPlaysWhite <= 1; softPlaysWhite++) {
+      Position position(fen);
+      MilliSec clock[COLOR_LENGTH] = {gameTime, gameTime};
+      searches[0].clearHash();
+      searches[1].clearHash();
+      double result = 0.5; // from white's view
+      for (int ply = 0; ply < maxPly; ply++) {
+        if (!MoveGenerator::hasLegalMove(position)) {
+          if (position.hasCheck()) { result = position.getNextPlayer() == WHITE ? 0.0 : 1.0; }
+          break;
+        }
+        if (position.checkRepetitions(2) || position.check50MovesRule()
+            || position.checkInsufficientMaterial()) {
+          break;
+        }
+        const Color us = position.getNextPlayer();
+        const int side = (us == WHITE) == (softPlaysWhite == 1) ? 0 : 1;
+        SearchConfig::USE_SOFT_TIME_LIMIT = side == 0;
+
+        SearchLimits searchLimits;
+        searchLimits.setWhiteTime(clock[WHITE]);
+        searchLimits.setBlackTime(clock[BLACK]);
+        searchLimits.setWhiteInc(increment);
+        searchLimits.setBlackInc(increment);
+        const auto start = std::chrono::steady_clock::now();
+        searches[side].startSearch(position, searchLimits);
+        searches[side].waitWhileSearching();
+        const MilliSec used = std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::steady_clock::now() - start).count();
+
+        timeUsed[side] += used;
+        movesPlayed[side]++;
+        clock[us] += increment - used;
+        if (clock[us] <= 0) { // lost on time
+          result = us == WHITE ? 0.0 : 1.0;
+          break;
+        }
+        const Move move = searches[side].getLastSearchResult().bestMove;
+        if (!move) break;
+        position.doMove(move);
+      }
+      points[0] += softPlaysWhite ? result : 1.0 - result;
+      points[1] += softPlaysWhite ? 1.0 - result : result;
+      games++;
+      LOG__INFO(Logger::get().TEST_LOG, "Game {}: {} soft time limit white: {} result: {}", games, fen,
+                softPlaysWhite ? "ON " : "OFF", result == 1.0 ? "1-0" : result == 0.0 ? "0-1" : "1/2-1/2");
+    }
+  }
+
+  LOG__INFO(Logger::get().TEST_LOG, "Games: {}", games);
+  LOG__INFO(Logger::get().TEST_LOG, "Soft time limit ON : {:4.1f} points {:6n} ms per move ({} moves)",
+            points[0], timeUsed[0] / std::max(1, movesPlayed[0]), movesPlayed[0]);
+  LOG__INFO(Logger::get().TEST_LOG, "Soft time limit OFF: {:4.1f} points {:6n} ms per move ({} moves)",
+            points[1], timeUsed[1] / std::max(1, movesPlayed[1]), movesPlayed[1]);
+}
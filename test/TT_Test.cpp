@@ -49,14 +49,17 @@ TEST_F(TT_Test, entrySize) {
     // sorted by size to achieve smallest struct size
     // using bitfield for smallest size
     Key key = 0; // 64 bit
-    Move move = MOVE_NONE; // 32 bit
+    Move move:16; // 16 bit
     Value value = VALUE_NONE; // 16 bit signed
+    Value eval = VALUE_NONE; // 16 bit signed
     Depth depth:7; // 0-127
     uint8_t age:3; // 0-7
     Value_Type type:2; // 4 values
     bool mateThreat:1; // 1-bit bool
   };
   LOG__INFO(Logger::get().TEST_LOG, "Entry size = {} Byte", sizeof(Entry));
+  ASSERT_EQ(16, sizeof(Entry));
+  ASSERT_EQ(16, sizeof(TT::Entry));
 
 }
 
@@ -307,6 +310,34 @@ TEST_F(TT_Test, get) {
 
 }
 
+TEST_F(TT_Test, staticEval) {
+  TT tt(10);
+  const Key key = 0x1234567890ABCDEFULL;
+
+  // no static eval given
+  tt.put(key, Depth(4), createMove("e2e4"), Value(101), TYPE_EXACT, false);
+  ASSERT_EQ(VALUE_NONE, tt.getMatch(key)->eval);
+
+  // static eval stored with the entry
+  tt.put(key, Depth(5), createMove("d2d4"), Value(102), TYPE_BETA, Value(55), false);
+  ASSERT_EQ(55, tt.getMatch(key)->eval);
+  ASSERT_EQ(createMove("d2d4"), tt.getMatch(key)->move);
+
+  // an update without static eval keeps the stored one
+  tt.put(key, Depth(6), MOVE_NONE, Value(103), TYPE_ALPHA, false);
+  ASSERT_EQ(55, tt.getMatch(key)->eval);
+  ASSERT_EQ(103, tt.getMatch(key)->value);
+  ASSERT_EQ(createMove("d2d4"), tt.getMatch(key)->move);
+
+  // moves are stored without their value
+  tt.put(key, Depth(6), createMove(SQ_E2, SQ_E4, Value(200)), Value(104), TYPE_EXACT, Value(-60), false);
+  ASSERT_EQ(createMove("e2e4"), tt.getMatch(key)->move);
+  ASSERT_EQ(-60, tt.getMatch(key)->eval);
+
+  tt.clear();
+  ASSERT_EQ(nullptr, tt.getMatch(key));
+}
+
 //TEST_F(TT_Test, probe) {
 //  std::random_device rd;
 //  std::mt19937_64 rg(rd());
@@ -24,12 +24,14 @@
  */
 
 #include <iostream>
+#include <fstream>
 #include <regex>
 #include "types.h"
 #include "misc.h"
 #include "Search.h"
 #include "Engine.h"
 #include "Logging.h"
+#include "SearchConfig.h"
 #include <gtest/gtest.h>
 #include <TestSuite.h>
 
@@ -69,6 +71,57 @@ TEST_F(TestSuiteTest, MateTestSuite) {
   testSuite.runTestSuite();
 }
 
+/**
+ * Compares the time to solution of the proof number mate solver with the
+ * alpha-beta search on the mate test suite and on the positions of
+ * MATE-POS.PGN (mate in up to 10 moves).
+ */
+TEST_F(TestSuiteTest, MateSolverBenchmark) {
+  Logger::get().SEARCH_LOG->set_level(spdlog::level::warn);
+  Logger::get().TSUITE_LOG->set_level(spdlog::level::warn);
+  const MilliSec moveTime = 2'000;
+  const Depth depth{0};
+
+  // mate test suite
+  std::string filePath = FrankyCPP_PROJECT_ROOT;
+  filePath += +"/testsets/mate_test_suite.epd";
+  TestSuite testSuite(filePath, moveTime, depth);
+  std::vector<TestSuite::Test> epdTests;
+  testSuite.readTestCases(filePath, epdTests);
+
+  // MATE-POS.PGN - the number of moves is part of the tags
+  filePath = FrankyCPP_PROJECT_ROOT;
+  filePath += +"/testsets/MATE-POS.PGN";
+  std::ifstream file(filePath);
+  ASSERT_TRUE(file.is_open());
+  const std::regex fenTag(R"re(\[FEN "(.*)"\])re");
+  const std::regex mateTag(R"re(\[(?:White|Black|Event) ".*(?:\((\d+)\)|M ?(\d+)|= (\d+)).*"\])re");
+  std::vector<TestSuite::Test> pgnTests;
+  std::string line, mateIn, event;
+  std::smatch matcher;
+  while (std::getline(file, line)) {
+    if (line.rfind("[Event ", 0) == 0) mateIn.clear();
+    if (mateIn.empty() && std::regex_search(line, matcher, mateTag)) {
+      mateIn = matcher[1].matched ? matcher[1] : matcher[2].matched ? matcher[2] : matcher[3];
+    }
+    if (std::regex_search(line, matcher, fenTag) && !mateIn.empty() && std::stoi(mateIn) <= 10) {
+      pgnTests.emplace_back(fmt::format("MATE-POS #{}", pgnTests.size() + 1), matcher[1], TestSuite::DM, mateIn);
+    }
+  }
+
+  for (auto* tests : {&epdTests, &pgnTests}) {
+    for (bool useMateSolver : {false, true}) {
+      std::vector<TestSuite::Test> ts = *tests;
+      testSuite.setUseMateSolver(useMateSolver);
+      const auto start = std::chrono::steady_clock::now();
+      testSuite.runTestSet(ts);
+      const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+      const auto solved = std::count_if(ts.begin(), ts.end(), [](const TestSuite::Test &t) { return t.result == TestSuite::SUCCESS; });
+      fprintln("{:<14} {:>3} mate tests: solved {:>3} in {:>7n} ms", useMateSolver ? "Mate solver" : "Alpha-Beta", ts.size(), solved, duration);
+    }
+  }
+}
+
 TEST_F(TestSuiteTest, CCC1Suite) {
   std::string filePath = FrankyCPP_PROJECT_ROOT;
   filePath+= + "/testsets/ccc-1.epd";
@@ -0,0 +1,139 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <string>
+#include <vector>
+#include "types.h"
+#include "Logging.h"
+#include "Tokenizer.h"
+#include <gtest/gtest.h>
+
+using testing::Eq;
+
+class TokenizerTest : public ::testing::Test {
+public:
+  static void SetUpTestSuite() {
+    NEWLINE;
+    INIT::init();
+    NEWLINE;
+    Logger::get().TEST_LOG->set_level(spdlog::level::warn);
+  }
+
+protected:
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+TEST_F(TokenizerTest, trim) {
+  ASSERT_EQ("e4 e5", Tokenizer::trim("  \te4 e5 \r\n"));
+  ASSERT_EQ("", Tokenizer::trim(" \t "));
+  std::vector<std::string> tokens;
+  Tokenizer::forEachToken("  1. e4  e5\t2. Nf3 ", [&](std::string_view t) { tokens.emplace_back(t); });
+  ASSERT_EQ((std::vector<std::string>{"1.", "e4", "e5", "2.", "Nf3"}), tokens);
+}
+
+TEST_F(TokenizerTest, uci) {
+  ASSERT_TRUE(Tokenizer::isUCIMove("e2e4"));
+  ASSERT_TRUE(Tokenizer::isUCIMove("a7a8q"));
+  ASSERT_TRUE(Tokenizer::isUCIMove("a7a8N"));
+  ASSERT_FALSE(Tokenizer::isUCIMove("a7a8k"));
+  ASSERT_FALSE(Tokenizer::isUCIMove("e2e9"));
+  ASSERT_FALSE(Tokenizer::isUCIMove("Nf3"));
+  ASSERT_FALSE(Tokenizer::isUCIMove("e2e4e5"));
+
+  std::vector<std::string> moves;
+  Tokenizer::forEachUCIMove("g1f3c7c5e2e4", [&](std::string_view m) { moves.emplace_back(m); });
+  ASSERT_EQ((std::vector<std::string>{"g1f3", "c7c5", "e2e4"}), moves);
+  moves.clear();
+  Tokenizer::forEachUCIMove("e2e4 e7e5 b7b8q", [&](std::string_view m) { moves.emplace_back(m); });
+  ASSERT_EQ((std::vector<std::string>{"e2e4", "e7e5", "b7b8q"}), moves);
+  moves.clear();
+  Tokenizer::forEachUCIMove("a7a8qb2b1b1c3", [&](std::string_view m) { moves.emplace_back(m); });
+  ASSERT_EQ((std::vector<std::string>{"a7a8q", "b2b1", "b1c3"}), moves);
+}
+
+TEST_F(TokenizerTest, san) {
+  Tokenizer::SAN san;
+  ASSERT_TRUE(Tokenizer::parseSAN("Nbxd2+", san));
+  ASSERT_EQ('N', san.piece);
+  ASSERT_EQ('b', san.file);
+  ASSERT_EQ(0, san.rank);
+  ASSERT_EQ("d2", san.target);
+  ASSERT_EQ(0, san.promotion);
+
+  ASSERT_TRUE(Tokenizer::parseSAN("exd8=Q#", san));
+  ASSERT_EQ(0, san.piece);
+  ASSERT_EQ('e', san.file);
+  ASSERT_EQ("d8", san.target);
+  ASSERT_EQ('Q', san.promotion);
+
+  ASSERT_TRUE(Tokenizer::parseSAN("R1e2", san));
+  ASSERT_EQ('R', san.piece);
+  ASSERT_EQ('1', san.rank);
+
+  ASSERT_TRUE(Tokenizer::parseSAN("O-O-O!?", san));
+  ASSERT_EQ("O-O-O", san.target);
+  ASSERT_TRUE(Tokenizer::parseSAN("O-O", san));
+  ASSERT_EQ("O-O", san.target);
+
+  ASSERT_FALSE(Tokenizer::parseSAN("1.", san));
+  ASSERT_FALSE(Tokenizer::parseSAN("1-0", san));
+  ASSERT_FALSE(Tokenizer::parseSAN("Zd4", san));
+}
+
+TEST_F(TokenizerTest, numbersAndResults) {
+  ASSERT_TRUE(Tokenizer::isMoveNumber("1."));
+  ASSERT_TRUE(Tokenizer::isMoveNumber("12..."));
+  ASSERT_FALSE(Tokenizer::isMoveNumber("12"));
+  ASSERT_FALSE(Tokenizer::isMoveNumber("1.e4"));
+  ASSERT_TRUE(Tokenizer::isResult("1/2-1/2"));
+  ASSERT_TRUE(Tokenizer::isResult("*"));
+  ASSERT_FALSE(Tokenizer::isResult("1-1"));
+  ASSERT_TRUE(Tokenizer::endsWithResult("42. Qh7# 1-0  "));
+  ASSERT_FALSE(Tokenizer::endsWithResult("42. Qh7#"));
+}
+
+TEST_F(TokenizerTest, tagPair) {
+  std::string_view name, value;
+  ASSERT_TRUE(Tokenizer::parseTagPair(R"([White "Kasparov, Garry"])", name, value));
+  ASSERT_EQ("White", name);
+  ASSERT_EQ("Kasparov, Garry", value);
+  ASSERT_TRUE(Tokenizer::parseTagPair(R"([Result ""])", name, value));
+  ASSERT_EQ("", value);
+  ASSERT_FALSE(Tokenizer::parseTagPair(R"([White Kasparov])", name, value));
+  ASSERT_FALSE(Tokenizer::parseTagPair("1. e4 e5", name, value));
+}
+
+TEST_F(TokenizerTest, movetext) {
+  std::vector<std::string> moves;
+  Tokenizer::forEachMovetextToken("1. e4 {best by test} e5 $1 2.Nf3 (2. f4 exf4 (2... d5)) Nc6 ; comment 3. Bb5\n"
+                                  "3... a6 <reserved> 4.Ba4 1/2-1/2",
+                                  [&](std::string_view m) { moves.emplace_back(m); });
+  ASSERT_EQ((std::vector<std::string>{"e4", "e5", "Nf3", "Nc6", "a6", "Ba4"}), moves);
+  moves.clear();
+  Tokenizer::forEachMovetextToken("e4(d4);comment\nd5!!2.c4$50(Nf3?)e5 Nf3{Comment !}Nc6 *",
+                                  [&](std::string_view m) { moves.emplace_back(m); });
+  ASSERT_EQ((std::vector<std::string>{"e4", "d5!!", "c4", "e5", "Nf3", "Nc6"}), moves);
+}
@@ -0,0 +1,156 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2020 Frank Kopp
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include "version.h"
+#include "types.h"
+#include "Logging.h"
+#include "Values.h"
+#include "Position.h"
+#include "Tuner.h"
+#include "Test_Fens.h"
+
+using testing::Eq;
+
+class TunerTest : public ::testing::Test {
+public:
+  static void SetUpTestSuite() {
+    NEWLINE;
+    INIT::init();
+    NEWLINE;
+  }
+
+protected:
+  void SetUp() override {
+    Logger::get().TEST_LOG->set_level(spdlog::level::debug);
+    Logger::get().MAIN_LOG->set_level(spdlog::level::info);
+    Logger::get().BOOK_LOG->set_level(spdlog::level::warn);
+  }
+
+  void TearDown() override {}
+};
+
+TEST_F(TunerTest, packedPosition) {
+  for (const std::string &fen : Test_Fens::getFENs()) {
+    const Position position(fen);
+    const PackedPosition packed = PackedPosition::pack(position, Tuner::DRAW);
+    ASSERT_EQ(Tuner::DRAW, packed.result);
+    const Position unpacked(packed.fen());
+    ASSERT_EQ(position.getOccupiedBB(), unpacked.getOccupiedBB()) << fen;
+    ASSERT_EQ(position.getNextPlayer(), unpacked.getNextPlayer()) << fen;
+    for (Square sq = SQ_A1; sq <= SQ_H8; ++sq) {
+      ASSERT_EQ(position.getPiece(sq), unpacked.getPiece(sq)) << fen;
+    }
+  }
+  ASSERT_EQ(32, sizeof(PackedPosition));
+}
+
+TEST_F(TunerTest, parseResult) {
+  ASSERT_EQ(Tuner::WHITE_WIN, Tuner::parseResult("1-0"));
+  ASSERT_EQ(Tuner::WHITE_WIN, Tuner::parseResult("1.0"));
+  ASSERT_EQ(Tuner::BLACK_WIN, Tuner::parseResult("0-1"));
+  ASSERT_EQ(Tuner::BLACK_WIN, Tuner::parseResult("0.0"));
+  ASSERT_EQ(Tuner::DRAW, Tuner::parseResult("1/2-1/2"));
+  ASSERT_EQ(Tuner::DRAW, Tuner::parseResult("0.5"));
+  ASSERT_EQ(Tuner::NO_RESULT, Tuner::parseResult("*"));
+}
+
+TEST_F(TunerTest, loadEPD) {
+  const std::string fileName = "tuner_test.epd";
+  {
+    std::ofstream out(fileName);
+    out << "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - c9 \"1-0\";\n";
+    out << "4k3/8/8/8/8/8/4P3/4K3 b - - [0.5]\n";
+    out << "4k3/8/8/8/8/8/q7/4K3 w - - 0-1\n";
+    // no result
+    out << "4k3/8/8/8/8/8/3q4/4K3 w - - bm Kf1;\n";
+    // in check
+    out << "4k3/8/8/8/8/8/4q3/4K3 w - - 0-1\n";
+  }
+  Tuner::Tuner tuner(1);
+  ASSERT_EQ(3, tuner.loadEPD(fileName));
+  const auto &positions = tuner.getPositions();
+  EXPECT_EQ(Tuner::WHITE_WIN, positions[0].result);
+  EXPECT_EQ(Tuner::DRAW, positions[1].result);
+  EXPECT_EQ(BLACK, positions[1].nextPlayer);
+  EXPECT_EQ(Tuner::BLACK_WIN, positions[2].result);
+  std::remove(fileName.c_str());
+}
+
+TEST_F(TunerTest, quietPositions) {
+  Tuner::Tuner tuner(1);
+  // white can win the queen - the stored position is after the exchange
+  ASSERT_TRUE(tuner.addPosition(Position("4k3/8/8/3q4/8/8/8/3RK3 w - -"), Tuner::WHITE_WIN));
+  const Position quiet(tuner.getPositions().front().fen());
+  EXPECT_EQ(WHITE_ROOK, quiet.getPiece(SQ_D5));
+  EXPECT_EQ(BLACK, quiet.getNextPlayer());
+}
+
+TEST_F(TunerTest, loadPGN) {
+  Tuner::Tuner tuner(1);
+  const std::size_t added = tuner.loadPGN(std::string(FrankyCPP_PROJECT_ROOT) + "/books/pgn_test2.pgn");
+  ASSERT_GT(added, 50);
+  for (const auto &p : tuner.getPositions()) ASSERT_EQ(Tuner::DRAW, p.result);
+  Tuner::Tuner limited(1);
+  ASSERT_EQ(10, limited.loadPGN(std::string(FrankyCPP_PROJECT_ROOT) + "/books/pgn_test2.pgn", 10));
+}
+
+TEST_F(TunerTest, restorePST) {
+  const Score score = Values::getPosScore(KNIGHT, 27);
+  {
+    Tuner::Tuner tuner(1);
+    tuner.addPSTParameters();
+    ASSERT_EQ(2 * 6 * 64 - 2 * 16, tuner.getParameters().size());
+    Values::setPosScore(KNIGHT, 27, makeScore(99, 99));
+    ASSERT_EQ(makeScore(99, 99), Values::posScore[WHITE_KNIGHT][63 - 27]);
+    ASSERT_EQ(makeScore(99, 99), Values::posScore[BLACK_KNIGHT][27]);
+  }
+  ASSERT_EQ(score, Values::getPosScore(KNIGHT, 27));
+}
+
+TEST_F(TunerTest, tune) {
+  Tuner::Tuner tuner;
+  tuner.loadPGN(std::string(FrankyCPP_PROJECT_ROOT) + "/books/superbook2.pgn", 10'000);
+  ASSERT_EQ(10'000, tuner.getPositions().size());
+  tuner.addConfigParameters();
+  const auto start = std::chrono::high_resolution_clock::now();
+  const double before = tuner.error();
+  const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::high_resolution_clock::now() - start).count();
+  LOG__INFO(Logger::get().TEST_LOG, "Error {:.6f} in {:n} ms ({:n} positions/sec)", before, nanos / 1'000'000,
+            static_cast<uint64_t>(tuner.getPositions().size() * 1e9 / nanos));
+  tuner.computeK();
+  const double fitted = tuner.error();
+  ASSERT_LE(fitted, before);
+  const double after = tuner.tune(1);
+  ASSERT_LE(after, fitted);
+  LOG__INFO(Logger::get().TEST_LOG, "K={:.3f} error {:.6f} -> {:.6f}", tuner.getK(), fitted, after);
+  const std::string output = tuner.print();
+  fprintln("{}", output);
+  ASSERT_NE(std::string::npos, output.find(fmt::format("int TEMPO = {};", tuner.getConfig().TEMPO)));
+}
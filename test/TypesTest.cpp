@@ -124,6 +124,33 @@ TEST(GlobalsTest, operators) {
   ASSERT_EQ(SQ_A8, SQ_H1 + (7 * NORTH_WEST));
 }
 
+TEST(ScoreTest, score) {
+  Score score = makeScore(25, -30);
+  ASSERT_EQ(25, mgValue(score));
+  ASSERT_EQ(-30, egValue(score));
+
+  score = makeScore(-5, 90);
+  ASSERT_EQ(-5, mgValue(score));
+  ASSERT_EQ(90, egValue(score));
+
+  // both halves in one operation
+  score += makeScore(10, -100);
+  ASSERT_EQ(5, mgValue(score));
+  ASSERT_EQ(-10, egValue(score));
+  score = -3 * score;
+  ASSERT_EQ(-15, mgValue(score));
+  ASSERT_EQ(30, egValue(score));
+  score = makeScore(-15, 7) / 2;
+  ASSERT_EQ(-7, mgValue(score));
+  ASSERT_EQ(3, egValue(score));
+  ASSERT_EQ(SCORE_ZERO, makeScore(-12, 34) - makeScore(-12, 34));
+
+  // tapering
+  ASSERT_EQ(-15, taper(makeScore(-15, 30), 1.0));
+  ASSERT_EQ(30, taper(makeScore(-15, 30), 0.0));
+  ASSERT_EQ(7, taper(makeScore(-15, 30), 0.5));
+}
+
 TEST(MoveTest, moves) {
   Move move = createMove<NORMAL>(SQ_A1, SQ_H1);
   ASSERT_TRUE(isMove(move));
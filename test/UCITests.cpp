@@ -86,6 +86,20 @@ TEST_F(UCITest, isreadyTest) {
   ASSERT_EQ(expected, os.str());
 }
 
+TEST_F(UCITest, evalTest) {
+  string command = "position startpos moves e2e4\neval";
+  LOG__INFO(Logger::get().TEST_LOG, "COMMAND: " + command);
+  istringstream is(command);
+  ostringstream os;
+  Engine engine;
+  UCI_Handler uciHandler(&engine, &is, &os);
+  uciHandler.loop();
+  string result = os.str();
+  LOG__DEBUG(Logger::get().TEST_LOG, "RESPONSE: \n" + result);
+  ASSERT_NE(string::npos, result.find("Material"));
+  ASSERT_NE(string::npos, result.find("Final evaluation (side to move):"));
+}
+
 TEST_F(UCITest, setoptionTest) {
   ostringstream os;
   Engine engine;
@@ -107,6 +121,20 @@ TEST_F(UCITest, setoptionTest) {
   SUCCEED();
 }
 
+TEST_F(UCITest, setoptionMateSolverHash) {
+  ostringstream os;
+  Engine engine;
+
+  string command = "setoption name MateSolverHash value 8";
+  LOG__INFO(Logger::get().TEST_LOG, "COMMAND: " + command);
+  istringstream is(command);
+  UCI_Handler uciHandler(&engine, &is, &os);
+  uciHandler.loop();
+  ASSERT_EQ("8", engine.getOption("MateSolverHash"));
+  ASSERT_EQ(8, SearchConfig::MATE_SOLVER_SIZE_MB);
+  SearchConfig::MATE_SOLVER_SIZE_MB = 32;
+}
+
 
 TEST_F(UCITest, positionTest) {
   ostringstream os;
@@ -53,38 +53,38 @@ protected:
 };
 
 TEST_F(ValuesTest, basic) {
-  ASSERT_EQ(25, Values::posMidValue[WHITE_PAWN][SQ_E4]);
-  ASSERT_EQ(-30, Values::posMidValue[WHITE_KNIGHT][SQ_H3]);
-  ASSERT_EQ(5, Values::posMidValue[WHITE_BISHOP][SQ_G2]);
-  ASSERT_EQ(-15, Values::posMidValue[WHITE_ROOK][SQ_H1]);
-  ASSERT_EQ(2, Values::posMidValue[WHITE_QUEEN][SQ_E5]);
-  ASSERT_EQ(50, Values::posMidValue[WHITE_KING][SQ_G1]);
-
-  ASSERT_EQ(25, Values::posMidValue[BLACK_PAWN][SQ_E5]);
-  ASSERT_EQ(-30, Values::posMidValue[BLACK_KNIGHT][SQ_A6]);
-  ASSERT_EQ(5, Values::posMidValue[BLACK_BISHOP][SQ_B7]);
-  ASSERT_EQ(-15, Values::posMidValue[BLACK_ROOK][SQ_A8]);
-  ASSERT_EQ(2, Values::posMidValue[BLACK_QUEEN][SQ_D4]);
-  ASSERT_EQ(50, Values::posMidValue[BLACK_KING][SQ_G8]);
-
-  ASSERT_EQ(90, Values::posEndValue[WHITE_PAWN][SQ_E7]);
-  ASSERT_EQ(-30, Values::posEndValue[WHITE_KNIGHT][SQ_H3]);
-  ASSERT_EQ(0, Values::posEndValue[WHITE_BISHOP][SQ_G2]);
-  ASSERT_EQ(5, Values::posEndValue[WHITE_ROOK][SQ_H8]);
-  ASSERT_EQ(5, Values::posEndValue[WHITE_QUEEN][SQ_E5]);
-  ASSERT_EQ(-30, Values::posEndValue[WHITE_KING][SQ_G1]);
-
-  ASSERT_EQ(90, Values::posEndValue[BLACK_PAWN][SQ_E2]);
-  ASSERT_EQ(-30, Values::posEndValue[BLACK_KNIGHT][SQ_A6]);
-  ASSERT_EQ(0, Values::posEndValue[BLACK_BISHOP][SQ_B7]);
-  ASSERT_EQ(5, Values::posEndValue[BLACK_ROOK][SQ_A1]);
-  ASSERT_EQ(5, Values::posEndValue[BLACK_QUEEN][SQ_D4]);
-  ASSERT_EQ(-30, Values::posEndValue[BLACK_KING][SQ_G8]);
-
-  const Value value = Values::posMidValue[WHITE_PAWN][SQ_A4];
+  ASSERT_EQ(25, mgValue(Values::posScore[WHITE_PAWN][SQ_E4]));
+  ASSERT_EQ(-30, mgValue(Values::posScore[WHITE_KNIGHT][SQ_H3]));
+  ASSERT_EQ(5, mgValue(Values::posScore[WHITE_BISHOP][SQ_G2]));
+  ASSERT_EQ(-15, mgValue(Values::posScore[WHITE_ROOK][SQ_H1]));
+  ASSERT_EQ(2, mgValue(Values::posScore[WHITE_QUEEN][SQ_E5]));
+  ASSERT_EQ(50, mgValue(Values::posScore[WHITE_KING][SQ_G1]));
+
+  ASSERT_EQ(25, mgValue(Values::posScore[BLACK_PAWN][SQ_E5]));
+  ASSERT_EQ(-30, mgValue(Values::posScore[BLACK_KNIGHT][SQ_A6]));
+  ASSERT_EQ(5, mgValue(Values::posScore[BLACK_BISHOP][SQ_B7]));
+  ASSERT_EQ(-15, mgValue(Values::posScore[BLACK_ROOK][SQ_A8]));
+  ASSERT_EQ(2, mgValue(Values::posScore[BLACK_QUEEN][SQ_D4]));
+  ASSERT_EQ(50, mgValue(Values::posScore[BLACK_KING][SQ_G8]));
+
+  ASSERT_EQ(90, egValue(Values::posScore[WHITE_PAWN][SQ_E7]));
+  ASSERT_EQ(-30, egValue(Values::posScore[WHITE_KNIGHT][SQ_H3]));
+  ASSERT_EQ(0, egValue(Values::posScore[WHITE_BISHOP][SQ_G2]));
+  ASSERT_EQ(5, egValue(Values::posScore[WHITE_ROOK][SQ_H8]));
+  ASSERT_EQ(5, egValue(Values::posScore[WHITE_QUEEN][SQ_E5]));
+  ASSERT_EQ(-30, egValue(Values::posScore[WHITE_KING][SQ_G1]));
+
+  ASSERT_EQ(90, egValue(Values::posScore[BLACK_PAWN][SQ_E2]));
+  ASSERT_EQ(-30, egValue(Values::posScore[BLACK_KNIGHT][SQ_A6]));
+  ASSERT_EQ(0, egValue(Values::posScore[BLACK_BISHOP][SQ_B7]));
+  ASSERT_EQ(5, egValue(Values::posScore[BLACK_ROOK][SQ_A1]));
+  ASSERT_EQ(5, egValue(Values::posScore[BLACK_QUEEN][SQ_D4]));
+  ASSERT_EQ(-30, egValue(Values::posScore[BLACK_KING][SQ_G8]));
+
+  const int value = mgValue(Values::posScore[WHITE_PAWN][SQ_A4]);
   const Value value1 = Values::posValue[WHITE_PAWN][SQ_A4][GAME_PHASE_MAX];
   ASSERT_EQ(value, value1);
-  const Value value2 = Values::posEndValue[WHITE_PAWN][SQ_A4];
+  const int value2 = egValue(Values::posScore[WHITE_PAWN][SQ_A4]);
   const Value value3 = Values::posValue[WHITE_PAWN][SQ_A4][0];
   ASSERT_EQ(value2, value3);
 